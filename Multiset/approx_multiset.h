@@ -0,0 +1,602 @@
+/**
+	@headerfile approx_multiset.h
+
+	@brief Dichiarazione e definizione di una classe templata ApproxMultiSet, che stima
+	il numero di occorrenze degli elementi di un flusso usando memoria limitata.
+*/
+
+// Guardie
+
+#ifndef APPROX_MULTISET_H
+#define APPROX_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <algorithm> // std::swap, std::sort
+#include <cmath> // std::ceil, std::exp, std::log
+#include <cstddef> // std::size_t
+#include <functional> // std::hash, std::equal_to
+#include <limits> // std::numeric_limits
+#include <utility> // std::pair
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_count_overflow, multiset_incompatible
+#include "multiset.h" // multiset_mix, multiset_equal
+
+/**
+	@brief MultiSet approssimato, a memoria limitata, templato su tre parametri
+
+	@description
+	Offre le stesse operazioni di inserimento e di conteggio di MultiSet, ma la memoria
+	non cresce con il numero di elementi distinti:
+	- un Count-Min sketch di depth() righe e width() colonne stima il numero di occorrenze
+	di qualsiasi valore. La stima non è mai minore del valore esatto e, con probabilità
+	almeno 1 - delta, non lo supera di più di epsilon * size();
+	- un riepilogo Space-Saving di capacity() contatori tiene traccia dei valori più frequenti:
+	ogni valore con più di size() / capacity() occorrenze è sicuramente presente in top_k().
+	Due ApproxMultiSet con gli stessi parametri possono essere uniti (ad esempio dopo aver
+	elaborato parti diverse di un flusso su thread diversi) tramite operator+=.
+
+	@tparam T tipo degli elementi del flusso
+	@tparam E funtore di uguaglianza tra due elementi
+	@tparam H funtore di hash degli elementi
+*/
+template <typename T, typename E = std::equal_to<T>, typename H = std::hash<T>>
+class ApproxMultiSet {
+
+	// Sezione privata della classe
+
+	/**
+		Contatore del riepilogo Space-Saving
+	*/
+	struct counter {
+		T value; ///< Valore monitorato
+		std::size_t hash; ///< Hash rimescolato del valore
+		std::size_t count; ///< Stima (per eccesso) del numero di occorrenze
+		std::size_t error; ///< Massima sovrastima di count
+		std::size_t heap_pos; ///< Posizione del contatore nell'heap
+
+		/**
+			@brief Costruttore per un contatore
+
+			@param v valore monitorato
+			@param h hash rimescolato del valore
+			@param c stima del numero di occorrenze
+			@param e massima sovrastima
+		*/
+		counter(const T &v, std::size_t h, std::size_t c, std::size_t e) : value(v), hash(h), count(c), error(e), heap_pos(0) {}
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct counter
+
+	// Dati membro privati
+
+	std::size_t _width; ///< Colonne del Count-Min sketch (una potenza di 2)
+	std::size_t _depth; ///< Righe del Count-Min sketch
+	std::vector<std::size_t> _sketch; ///< Contatori del Count-Min sketch, riga per riga
+	std::size_t _capacity; ///< Numero massimo di contatori Space-Saving
+	std::vector<counter> _counters; ///< Contatori Space-Saving
+	std::vector<std::size_t> _heap; ///< Min-heap dei contatori per count
+	std::vector<std::size_t> _slots; ///< Indice ad indirizzamento aperto dei contatori (posizione + 1, 0 se libero)
+	std::size_t _size; ///< Numero totale di elementi inseriti
+
+	E _eql; ///< Istanza del funtore di uguaglianza
+	H _hash; ///< Istanza del funtore di hash
+
+	/**
+		@brief Hash rimescolato di un valore
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash di v, rimescolato con multiset_mix
+	*/
+	std::size_t hash_of(const T &v) const {
+		return multiset_mix(_hash(v));
+	}
+
+	/**
+		@brief Ricerca del contatore di un valore
+
+		@description
+		L'indice ha almeno il doppio delle posizioni dei contatori e usa la scansione lineare,
+		quindi la ricerca richiede in media un numero costante di confronti.
+
+		@param v valore da cercare
+		@param h hash rimescolato di v
+
+		@return posizione del contatore di v in _counters, _counters.size() se v non è monitorato
+	*/
+	std::size_t find_counter(const T &v, std::size_t h) const {
+		if(_slots.empty())
+			return _counters.size();
+		std::size_t mask = _slots.size() - 1;
+		for(std::size_t p = h & mask; _slots[p] != 0; p = (p + 1) & mask) {
+			const counter &c = _counters[_slots[p] - 1];
+			if(c.hash == h && multiset_equal(_eql, c.value, v))
+				return _slots[p] - 1;
+		}
+		return _counters.size();
+	}
+
+	/**
+		@brief Inserimento di un contatore nell'indice
+
+		@param i posizione del contatore in _counters
+	*/
+	void link(std::size_t i) {
+		std::size_t mask = _slots.size() - 1;
+		std::size_t p = _counters[i].hash & mask;
+		while(_slots[p] != 0)
+			p = (p + 1) & mask;
+		_slots[p] = i + 1;
+	}
+
+	/**
+		@brief Rimozione di un contatore dall'indice
+
+		@description
+		Le posizioni successive della stessa sequenza di scansione sono spostate indietro,
+		così che l'indice non contenga marcatori di cancellazione.
+
+		@param i posizione del contatore in _counters
+	*/
+	void unlink(std::size_t i) {
+		std::size_t mask = _slots.size() - 1;
+		std::size_t p = _counters[i].hash & mask;
+		while(_slots[p] != i + 1)
+			p = (p + 1) & mask;
+		for(std::size_t q = (p + 1) & mask; _slots[q] != 0; q = (q + 1) & mask) {
+			std::size_t home = _counters[_slots[q] - 1].hash & mask;
+			// L'elemento in q resta dov'è se la sua posizione naturale è ciclicamente in (p, q]
+			bool stays = (p <= q) ? (p < home && home <= q) : (p < home || home <= q);
+			if(!stays) {
+				_slots[p] = _slots[q];
+				p = q;
+			}
+		}
+		_slots[p] = 0;
+	}
+
+	/**
+		@brief Colonna di un valore in una riga del Count-Min sketch
+
+		@description
+		Ogni riga rimescola nuovamente l'hash del valore con una costante diversa, così che
+		due valori con lo stesso hash modulo width() in una riga non collidano anche nelle altre
+		(come accadrebbe con il doppio hashing, per la ristrettezza delle righe).
+
+		@param h hash rimescolato del valore
+		@param row riga del Count-Min sketch
+
+		@return indice del contatore nel vettore _sketch
+	*/
+	std::size_t cell(std::size_t h, std::size_t row) const {
+		std::size_t seed = static_cast<std::size_t>((row + 1) * 0x9e3779b97f4a7c15ULL);
+		return row * _width + (multiset_mix(h ^ seed) & (_width - 1));
+	}
+
+	/**
+		@brief Stima del Count-Min sketch per un valore
+
+		@param h hash rimescolato del valore
+
+		@return minimo dei contatori del valore nelle varie righe
+	*/
+	std::size_t sketch_estimate(std::size_t h) const {
+		std::size_t est = std::numeric_limits<std::size_t>::max();
+		for(std::size_t r = 0; r < _depth; ++r)
+			if(_sketch[cell(h, r)] < est)
+				est = _sketch[cell(h, r)];
+		return est;
+	}
+
+	/**
+		@brief Scambio di due posizioni dell'heap dei contatori
+
+		@param a prima posizione
+		@param b seconda posizione
+	*/
+	void heap_swap(std::size_t a, std::size_t b) {
+		std::swap(_heap[a], _heap[b]);
+		_counters[_heap[a]].heap_pos = a;
+		_counters[_heap[b]].heap_pos = b;
+	}
+
+	/**
+		@brief Ripristino dell'heap dopo l'incremento di un contatore
+
+		@param p posizione nell'heap del contatore incrementato
+	*/
+	void sift_down(std::size_t p) {
+		std::size_t n = _heap.size();
+		while(true) {
+			std::size_t min = p, l = 2 * p + 1, r = 2 * p + 2;
+			if(l < n && _counters[_heap[l]].count < _counters[_heap[min]].count)
+				min = l;
+			if(r < n && _counters[_heap[r]].count < _counters[_heap[min]].count)
+				min = r;
+			if(min == p)
+				return;
+			heap_swap(p, min);
+			p = min;
+		}
+	}
+
+	/**
+		@brief Ripristino dell'heap dopo l'inserimento di un contatore in fondo
+
+		@param p posizione nell'heap del nuovo contatore
+	*/
+	void sift_up(std::size_t p) {
+		while(p > 0 && _counters[_heap[p]].count < _counters[_heap[(p - 1) / 2]].count) {
+			heap_swap(p, (p - 1) / 2);
+			p = (p - 1) / 2;
+		}
+	}
+
+	/**
+		@brief Aggiornamento del riepilogo Space-Saving
+
+		@description
+		Se il valore è monitorato il suo contatore è incrementato; altrimenti, se c'è posto,
+		viene creato un nuovo contatore, e in caso contrario il contatore minimo è riassegnato
+		al valore, ereditandone il conteggio come errore.
+
+		@param v valore inserito
+		@param h hash rimescolato di v
+		@param k numero di occorrenze inserite
+		@param err errore già presente sul conteggio (usato dall'unione)
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore o dall'assegnamento di T
+	*/
+	void track(const T &v, std::size_t h, std::size_t k, std::size_t err) {
+		std::size_t i = find_counter(v, h);
+		if(i != _counters.size()) {
+			counter &c = _counters[i];
+			c.count += k;
+			c.error += err;
+			sift_down(c.heap_pos);
+			return;
+		}
+		if(_capacity == 0)
+			return;
+		if(_counters.size() < _capacity) {
+			_counters.push_back(counter(v, h, k, err));
+			try {
+				_heap.push_back(_counters.size() - 1);
+			}
+			catch(...) { // Eccezione di allocazione di memoria
+				_counters.pop_back();
+				throw;
+			}
+			link(_counters.size() - 1);
+			_counters.back().heap_pos = _heap.size() - 1;
+			sift_up(_heap.size() - 1);
+			return;
+		}
+		std::size_t m = _heap[0];
+		counter &c = _counters[m];
+		c.value = v;
+		unlink(m);
+		c.hash = h;
+		link(m);
+		c.error = c.count + err;
+		c.count += k;
+		sift_down(0);
+	}
+
+	/**
+		@brief Numero minimo di occorrenze di un valore non monitorato
+
+		@return 0 se il riepilogo non è pieno, altrimenti il contatore minimo
+	*/
+	std::size_t untracked_bound() const {
+		return (_counters.size() < _capacity || _capacity == 0) ? 0 : _counters[_heap[0]].count;
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	typedef std::size_t size_type; ///< Tipo dei numeri di occorrenze e delle dimensioni
+
+	/**
+		@brief Costruttore per ApproxMultiSet
+
+		@description
+		Il Count-Min sketch ha ceil(ln(1 / delta)) righe e almeno e / epsilon colonne.
+
+		@param epsilon errore massimo delle stime, in rapporto a size() (0 < epsilon < 1)
+		@param delta probabilità di superare l'errore massimo (0 < delta < 1)
+		@param capacity numero di contatori per i valori più frequenti
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	ApproxMultiSet(double epsilon = 0.001, double delta = 0.01, size_type capacity = 100) : _width(1),
+		_depth(static_cast<std::size_t>(std::ceil(std::log(1.0 / delta)))), _capacity(capacity), _size(0) {
+		std::size_t w = static_cast<std::size_t>(std::ceil(std::exp(1.0) / epsilon));
+		while(_width < w)
+			_width *= 2;
+		if(_depth == 0)
+			_depth = 1;
+		_sketch.assign(_width * _depth, 0);
+		_counters.reserve(_capacity);
+		_heap.reserve(_capacity);
+		if(_capacity > 0) {
+			std::size_t s = 1;
+			while(s < 2 * _capacity)
+				s *= 2;
+			_slots.assign(s, 0);
+		}
+	}
+
+	// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	/**
+		@brief Numero di elementi inseriti
+
+		@return numero totale (esatto) di elementi inseriti
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Colonne del Count-Min sketch
+
+		@return numero di colonne di ciascuna riga
+	*/
+	size_type width() const {
+		return _width;
+	}
+
+	/**
+		@brief Righe del Count-Min sketch
+
+		@return numero di righe
+	*/
+	size_type depth() const {
+		return _depth;
+	}
+
+	/**
+		@brief Contatori dei valori più frequenti
+
+		@return numero massimo di valori monitorati
+	*/
+	size_type capacity() const {
+		return _capacity;
+	}
+
+	/**
+		@brief Inserimento di un elemento
+
+		@param v valore da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v) {
+		add(v, 1);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento
+
+		@description
+		Costo O(depth()) per il Count-Min sketch più O(log capacity()) per il riepilogo
+		Space-Saving; una volta pieno il riepilogo, l'inserimento non alloca memoria.
+
+		@param v valore da inserire
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (l'ApproxMultiSet resta invariato)
+	*/
+	void add(const T &v, size_type k) {
+		if(k == 0)
+			return;
+		if(k > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		std::size_t h = hash_of(v);
+		track(v, h, k, 0);
+		for(std::size_t r = 0; r < _depth; ++r)
+			_sketch[cell(h, r)] += k;
+		_size += k;
+	}
+
+	/**
+		@brief Stima del numero di occorrenze di un elemento
+
+		@description
+		Viene restituito il minimo tra la stima del Count-Min sketch e, se il valore è
+		monitorato, il suo contatore Space-Saving: entrambe sono stime per eccesso.
+
+		@param v valore da cercare
+
+		@return stima per eccesso del numero di occorrenze di v
+	*/
+	size_type nocc(const T &v) const {
+		std::size_t h = hash_of(v);
+		std::size_t est = sketch_estimate(h);
+		std::size_t i = find_counter(v, h);
+		if(i != _counters.size() && _counters[i].count < est)
+			est = _counters[i].count;
+		return est;
+	}
+
+	/**
+		@brief Ricerca (approssimata) di un elemento
+
+		@param v valore da cercare
+
+		@return true se la stima del numero di occorrenze di v è positiva: i falsi positivi
+		sono possibili, i falsi negativi no
+	*/
+	bool contains(const T &v) const {
+		return nocc(v) > 0;
+	}
+
+	/**
+		@brief Valori più frequenti
+
+		@description
+		Sono considerati i valori monitorati dal riepilogo Space-Saving, con la stessa stima
+		di nocc() (il minimo tra il contatore e il Count-Min sketch), in ordine decrescente.
+		Ogni valore con più di size() / capacity() occorrenze è presente, se k è almeno capacity().
+
+		@param k numero massimo di valori restituiti
+
+		@return coppie (valore, stima per eccesso del numero di occorrenze)
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	std::vector<std::pair<T, size_type>> top_k(size_type k) const {
+		std::vector<std::pair<size_type, std::size_t>> order;
+		order.reserve(_counters.size());
+		for(std::size_t i = 0; i < _counters.size(); ++i) {
+			std::size_t est = sketch_estimate(_counters[i].hash);
+			order.push_back(std::make_pair((_counters[i].count < est) ? _counters[i].count : est, i));
+		}
+		std::sort(order.begin(), order.end(), more_frequent);
+		if(k > order.size())
+			k = order.size();
+		std::vector<std::pair<T, size_type>> res;
+		res.reserve(k);
+		for(std::size_t i = 0; i < k; ++i)
+			res.push_back(std::pair<T, size_type>(_counters[order[i].second].value, order[i].first));
+		return res;
+	}
+
+	/**
+		@brief Numero minimo garantito di occorrenze di un valore monitorato
+
+		@param v valore da cercare
+
+		@return contatore Space-Saving di v meno la sua massima sovrastima, 0 se v non è monitorato
+	*/
+	size_type guaranteed(const T &v) const {
+		std::size_t i = find_counter(v, hash_of(v));
+		if(i == _counters.size())
+			return 0;
+		return _counters[i].count - _counters[i].error;
+	}
+
+	/**
+		@brief Unione di due ApproxMultiSet
+
+		@description
+		I Count-Min sketch sono sommati cella per cella. Nei riepiloghi Space-Saving, ad un
+		valore assente da uno dei due riepiloghi pieni viene attribuito il contatore minimo di
+		quel riepilogo (come errore), quindi le stime restano per eccesso; dei valori risultanti
+		sono mantenuti i capacity() con le stime maggiori.
+
+		@param other ApproxMultiSet da unire
+
+		@return Riferimento all'ApproxMultiSet corrente
+
+		@throw multiset_incompatible se i due ApproxMultiSet hanno parametri diversi
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	ApproxMultiSet& operator+=(const ApproxMultiSet &other) {
+		if(_width != other._width || _depth != other._depth || _capacity != other._capacity)
+			throw multiset_incompatible();
+		if(other._size > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+
+		std::size_t mine = untracked_bound(), theirs = other.untracked_bound();
+		std::vector<counter> merged;
+		merged.reserve(_counters.size() + other._counters.size());
+		for(std::size_t i = 0; i < _counters.size(); ++i) {
+			const counter &c = _counters[i];
+			std::size_t j = other.find_counter(c.value, c.hash);
+			if(j == other._counters.size())
+				merged.push_back(counter(c.value, c.hash, c.count + theirs, c.error + theirs));
+			else {
+				const counter &o = other._counters[j];
+				merged.push_back(counter(c.value, c.hash, c.count + o.count, c.error + o.error));
+			}
+		}
+		for(std::size_t i = 0; i < other._counters.size(); ++i) {
+			const counter &o = other._counters[i];
+			if(find_counter(o.value, o.hash) == _counters.size())
+				merged.push_back(counter(o.value, o.hash, o.count + mine, o.error + mine));
+		}
+		std::vector<std::pair<size_type, std::size_t>> order;
+		order.reserve(merged.size());
+		for(std::size_t i = 0; i < merged.size(); ++i)
+			order.push_back(std::make_pair(merged[i].count, i));
+		std::sort(order.begin(), order.end(), more_frequent);
+		if(order.size() > _capacity)
+			order.resize(_capacity);
+
+		ApproxMultiSet res(*this);
+		res._counters.clear();
+		res._heap.clear();
+		res._slots.assign(res._slots.size(), 0);
+		for(std::size_t i = 0; i < order.size(); ++i) {
+			const counter &c = merged[order[i].second];
+			res.track(c.value, c.hash, c.count, c.error);
+		}
+		for(std::size_t i = 0; i < _sketch.size(); ++i)
+			res._sketch[i] += other._sketch[i];
+		res._size += other._size;
+		this->swap(res);
+		return *this;
+	}
+
+	/**
+		@brief Scambio del contenuto di due ApproxMultiSet
+
+		@param other ApproxMultiSet con cui scambiare il contenuto
+	*/
+	void swap(ApproxMultiSet &other) {
+		std::swap(_width, other._width);
+		std::swap(_depth, other._depth);
+		_sketch.swap(other._sketch);
+		std::swap(_capacity, other._capacity);
+		_counters.swap(other._counters);
+		_heap.swap(other._heap);
+		_slots.swap(other._slots);
+		std::swap(_size, other._size);
+		std::swap(_eql, other._eql);
+		std::swap(_hash, other._hash);
+	}
+
+private:
+
+	/**
+		@brief Confronto per stima decrescente, usato da top_k() e dall'unione
+
+		@param a prima coppia (stima, indice)
+		@param b seconda coppia (stima, indice)
+
+		@return true se a ha una stima maggiore di b (a parità, indice minore)
+	*/
+	static bool more_frequent(const std::pair<size_type, std::size_t> &a, const std::pair<size_type, std::size_t> &b) {
+		return (a.first != b.first) ? a.first > b.first : a.second < b.second;
+	}
+
+}; // class ApproxMultiSet
+
+/**
+	@brief Unione di due ApproxMultiSet
+
+	@param a primo ApproxMultiSet
+	@param b secondo ApproxMultiSet
+
+	@return nuovo ApproxMultiSet, unione di a e b
+
+	@throw multiset_incompatible se i due ApproxMultiSet hanno parametri diversi
+*/
+template <typename T, typename E, typename H>
+ApproxMultiSet<T,E,H> operator+(const ApproxMultiSet<T,E,H> &a, const ApproxMultiSet<T,E,H> &b) {
+	ApproxMultiSet<T,E,H> res(a);
+	res += b;
+	return res;
+}
+
+#endif
+
+// Fine approx_multiset.h
@@ -0,0 +1,1415 @@
+/**
+	@file benchmark.cpp
+
+	@brief Benchmark della classe MultiSet
+
+	@description
+	File sorgente con funzione main(). Contiene alcune misure dei tempi di esecuzione
+	dei metodi della classe MultiSet su input di grandi dimensioni. A differenza dei test
+	del file main.cpp, va compilato con le ottimizzazioni attive (make bench).
+*/
+
+// Direttive pre-compilatore
+
+#include <iostream> // std::cout
+#include <chrono> // std::chrono::steady_clock
+#include <functional> // std::hash
+#include <pthread.h> // pthread_create, pthread_attr_setstacksize
+#include <thread> // std::thread::hardware_concurrency
+#include <vector> // std::vector
+#include <algorithm> // std::sort
+#include <iterator> // std::advance
+#include <random> // std::mt19937
+#include <sstream> // std::ostringstream
+#include <cstdlib> // std::rand, std::srand
+#include <cstring> // std::strlen
+#include <cstdio> // std::sprintf, std::remove
+#include <fstream> // std::ofstream, std::ifstream
+#include "multiset.h" // Classe MultiSet
+#include "ordered_multiset.h" // Classe OrderedMultiSet
+#include "flat_multiset.h" // Classe FlatMultiSet
+#include "multiset_sampler.h" // Campionatore pesato multiset_sampler
+#include "approx_multiset.h" // Classe ApproxMultiSet
+#include "concurrent_multiset.h" // Classe ConcurrentMultiSet
+#include "multiset_parallel.h" // Costruzione parallela di un MultiSet
+#include "snapshot_multiset.h" // Classe SnapshotMultiSet
+#include "string_multiset.h" // Classe StringMultiSet
+#include "multiset_binary.h" // Formato binario, classe MappedMultiSet
+
+/**
+	@brief Funtore di uguaglianza tra interi che conta le proprie invocazioni
+
+	@description
+	Senza funtore di hash, il MultiSet invoca il funtore di uguaglianza una volta
+	per ogni nodo visitato durante una ricerca: il contatore misura quindi il numero
+	di nodi attraversati.
+*/
+struct counting_equal_int {
+	static unsigned long long calls; ///< Numero di invocazioni del funtore
+
+	bool operator()(int a, int b) const {
+		++calls;
+		return a==b;
+	}
+};
+
+unsigned long long counting_equal_int::calls = 0;
+
+/**
+	@brief Millisecondi trascorsi da un istante dato
+
+	@param start istante iniziale
+
+	@return millisecondi trascorsi da start
+*/
+double elapsed_ms(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+	@brief Inserimento di valori distinti in un MultiSet senza hash
+
+	@description
+	Ogni nuovo valore distinto richiede una scansione completa della lista: il costo
+	totale è quadratico e dominato dall'attraversamento dei nodi. Il nuovo nodo è accodato
+	all'ultimo nodo visitato dalla ricerca, quindi ogni inserimento attraversa la lista
+	una sola volta. Per confronto viene ripetuto lo schema precedente, in cui dopo la
+	ricerca la lista era scorsa di nuovo fino alla coda: la seconda scansione è riprodotta
+	con distinct(). Per entrambi sono stampati il tempo ed i nodi visitati (invocazioni
+	del funtore durante la ricerca più passi della scansione fino alla coda).
+*/
+void bench_add_distinct() {
+	const int n = 50000; // Valori distinti inseriti
+
+	MultiSet<int, counting_equal_int> ms;
+	counting_equal_int::calls = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < n; ++i)
+		ms.add(i);
+	double t = elapsed_ms(start);
+	unsigned long long visits = counting_equal_int::calls;
+
+	MultiSet<int, counting_equal_int> old;
+	counting_equal_int::calls = 0;
+	unsigned long long walked = 0; // Passi della seconda scansione fino alla coda
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < n; ++i) {
+		MultiSet<int, counting_equal_int>::distinct_range r = old.distinct();
+		for(MultiSet<int, counting_equal_int>::distinct_iterator j = r.begin(); j != r.end(); ++j)
+			++walked;
+		old.add(i);
+	}
+	double t_old = elapsed_ms(start);
+	unsigned long long visits_old = counting_equal_int::calls + walked;
+
+	std::cout << "add() di " << n << " interi distinti (lista), una scansione: " << t << " ms, ";
+	std::cout << visits << " nodi visitati" << std::endl;
+	std::cout << "add() di " << n << " interi distinti (lista), ricerca e scansione fino alla coda: " << t_old << " ms, ";
+	std::cout << visits_old << " nodi visitati" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Corpo del thread che distrugge un MultiSet
+
+	@param arg puntatore al MultiSet da distruggere
+
+	@return nullptr
+*/
+void* destroy_run(void *arg) {
+	delete static_cast<MultiSet<int, counting_equal_int>*>(arg);
+	return nullptr;
+}
+
+/**
+	@brief Distruzione di un MultiSet senza hash con 10^7 elementi distinti
+
+	@description
+	Il MultiSet è una sola lista di 10^7 nodi, il caso in cui una distruzione ricorsiva
+	esaurirebbe lo stack. È costruito in tempo lineare da una sequenza ordinata
+	(multiset_sorted_input), senza ricerche, e viene distrutto su un thread con uno
+	stack di 256 KiB.
+*/
+void bench_destroy_large() {
+	const int n = 10000000; // Valori distinti inseriti
+
+	std::vector<int> values(n);
+	for(int i = 0; i < n; ++i)
+		values[i] = i;
+	MultiSet<int, counting_equal_int> *ms = new MultiSet<int, counting_equal_int>(multiset_sorted_input, values.begin(), values.end());
+
+	pthread_attr_t attr;
+	pthread_t thread;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, 256 * 1024);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	int err = pthread_create(&thread, &attr, destroy_run, ms);
+	if(err == 0)
+		pthread_join(thread, nullptr);
+	double t = elapsed_ms(start);
+	pthread_attr_destroy(&attr);
+
+	if(err != 0) {
+		delete ms;
+		std::cout << "distruzione di " << n << " nodi: impossibile creare il thread (errore " << err << ")" << std::endl;
+	}
+	else
+		std::cout << "distruzione di una lista di " << n << " nodi su uno stack di 256 KiB: " << t << " ms" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Inserimento, rimozione e distruzione di 10^6 elementi distinti con un allocatore dato
+
+	@tparam MS tipo del MultiSet
+
+	@return millisecondi trascorsi
+*/
+template <typename MS>
+double churn(MS &ms) {
+	const int n = 1000000; // Valori distinti inseriti
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < n; ++i)
+		ms.add(i);
+	for(int i = 0; i < n; i += 2)
+		ms.remove(i);
+	for(int i = 0; i < n; i += 2)
+		ms.add(n + i);
+	ms.clear();
+	return elapsed_ms(start);
+}
+
+/**
+	@brief Confronto tra l'allocatore standard e l'allocatore a blocchi
+
+	@description
+	Vengono stampati i tempi delle stesse operazioni con i due allocatori e le
+	statistiche del pool: le allocazioni di sistema sono una per blocco di celle,
+	più una per ciascun array di bucket.
+*/
+void bench_pool_allocator() {
+	MultiSet<int, counting_equal_int, std::hash<int>> ms_std;
+	MultiSet<int, counting_equal_int, std::hash<int>, multiset_pool_allocator<int>> ms_pool;
+
+	double t_std = churn(ms_std);
+	double t_pool = churn(ms_pool);
+	multiset_pool_stats st = ms_pool.get_allocator().stats();
+
+	std::cout << "add()/remove()/clear() di 10^6 interi distinti, allocatore standard: " << t_std << " ms" << std::endl;
+	std::cout << "add()/remove()/clear() di 10^6 interi distinti, allocatore a blocchi: " << t_pool << " ms" << std::endl;
+	std::cout << "  richieste di allocazione: " << st.allocations << ", allocazioni di sistema: " << st.system_allocations;
+	std::cout << ", deallocazioni: " << st.deallocations << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Costruzione di MultiSet da una sequenza
+
+	@description
+	Senza funtore di hash, una sequenza ordinata di 2*10^6 elementi con 10^3 valori distinti
+	è caricata con add() elemento per elemento, con il costruttore da sequenza (una ricerca
+	per gruppo di elementi uguali) e con il costruttore da sequenza ordinata (nessuna ricerca).
+	Con funtore di hash, una sequenza casuale di 10^7 elementi con 10^6 valori distinti è
+	caricata con add() e con reserve() seguito da add(first, last).
+*/
+void bench_bulk_load() {
+	const int n = 10000000; // Lunghezza della sequenza casuale
+	const int ns = 2000000; // Lunghezza della sequenza ordinata
+	const int d = 1000; // Valori distinti della sequenza ordinata
+	std::vector<int> v(ns);
+	for(int i = 0; i < ns; ++i)
+		v[i] = i / (ns / d);
+
+	double t;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		MultiSet<int, counting_equal_int> ms;
+		counting_equal_int::calls = 0;
+		start = std::chrono::steady_clock::now();
+		for(int i = 0; i < ns; ++i)
+			ms.add(v[i]);
+		t = elapsed_ms(start);
+	}
+	std::cout << "add() di " << ns << " interi ordinati, " << d << " distinti (lista): " << t << " ms, ";
+	std::cout << counting_equal_int::calls << " confronti" << std::endl;
+	{
+		counting_equal_int::calls = 0;
+		start = std::chrono::steady_clock::now();
+		MultiSet<int, counting_equal_int> ms(v.begin(), v.end());
+		t = elapsed_ms(start);
+	}
+	std::cout << "costruttore da sequenza (lista): " << t << " ms, " << counting_equal_int::calls << " confronti" << std::endl;
+	{
+		counting_equal_int::calls = 0;
+		start = std::chrono::steady_clock::now();
+		MultiSet<int, counting_equal_int> ms(multiset_sorted_input, v.begin(), v.end());
+		t = elapsed_ms(start);
+	}
+	std::cout << "costruttore da sequenza ordinata (lista): " << t << " ms, " << counting_equal_int::calls << " confronti" << std::endl;
+
+	std::srand(1);
+	v.resize(n);
+	for(int i = 0; i < n; ++i)
+		v[i] = std::rand() % (n / 10);
+	{
+		MultiSet<int, counting_equal_int, std::hash<int>> ms;
+		start = std::chrono::steady_clock::now();
+		for(int i = 0; i < n; ++i)
+			ms.add(v[i]);
+		t = elapsed_ms(start);
+	}
+	std::cout << "add() di " << n << " interi casuali (hash): " << t << " ms" << std::endl;
+	{
+		MultiSet<int, counting_equal_int, std::hash<int>> ms;
+		start = std::chrono::steady_clock::now();
+		ms.reserve(n / 10);
+		ms.add(v.begin(), v.end());
+		t = elapsed_ms(start);
+	}
+	std::cout << "reserve() e add(first, last) (hash): " << t << " ms" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Copia di MultiSet con 10^4 valori distinti, ciascuno con 10^3 occorrenze
+
+	@description
+	La copia è strutturale: ogni nodo è copiato una sola volta, senza confronti.
+	Come riferimento, con funtore di hash viene misurata anche la ricostruzione tramite
+	add() di ogni occorrenza (il costo della copia prima della modifica); senza funtore di
+	hash la ricostruzione richiederebbe circa 5*10^10 confronti e non viene eseguita.
+*/
+void bench_copy() {
+	const int d = 10000; // Valori distinti
+	const int k = 1000; // Occorrenze di ciascun valore
+	std::vector<int> v(static_cast<std::size_t>(d) * k);
+	for(std::size_t i = 0; i < v.size(); ++i)
+		v[i] = static_cast<int>(i / k);
+
+	MultiSet<int, counting_equal_int> l(multiset_sorted_input, v.begin(), v.end());
+	MultiSet<int, counting_equal_int, std::hash<int>> h(multiset_sorted_input, v.begin(), v.end());
+
+	counting_equal_int::calls = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		MultiSet<int, counting_equal_int> c(l);
+	}
+	double t = elapsed_ms(start);
+	std::cout << "copia di " << d << " valori distinti x " << k << " occorrenze (lista): " << t << " ms, ";
+	std::cout << counting_equal_int::calls << " confronti" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	{
+		MultiSet<int, counting_equal_int, std::hash<int>> c(h);
+	}
+	t = elapsed_ms(start);
+	std::cout << "copia (hash): " << t << " ms" << std::endl;
+
+	MultiSet<int, counting_equal_int, std::hash<int>> c;
+	start = std::chrono::steady_clock::now();
+	c = h;
+	t = elapsed_ms(start);
+	std::cout << "assegnamento ad un MultiSet vuoto (hash): " << t << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	c = h;
+	t = elapsed_ms(start);
+	std::cout << "assegnamento con riutilizzo dei nodi (hash): " << t << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	{
+		MultiSet<int, counting_equal_int, std::hash<int>> r;
+		for(MultiSet<int, counting_equal_int, std::hash<int>>::const_iterator i = h.begin(); i != h.end(); ++i)
+			r.add(*i);
+	}
+	t = elapsed_ms(start);
+	std::cout << "riferimento, add() di ogni occorrenza (hash): " << t << " ms" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Operazioni insiemistiche su MultiSet e OrderedMultiSet con 10^6 elementi distinti
+
+	@description
+	Come riferimento viene misurata anche l'unione calcolata, come in precedenza, scorrendo
+	l'iteratore di un MultiSet ed inserendo ogni occorrenza con add().
+*/
+void bench_algebra() {
+	const int n = 1000000; // Elementi distinti di ciascun operando
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	mshint a, b;
+	OrderedMultiSet<int> oa, ob;
+	for(int i = 0; i < n; ++i) {
+		a.add(i, 2);
+		b.add(i + n / 2, 3);
+		oa.add(i, 2);
+		ob.add(i + n / 2, 3);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		mshint r(a);
+		for(mshint::const_iterator i = b.begin(); i != b.end(); ++i)
+			r.add(*i);
+	}
+	std::cout << "somma tramite add() di ogni occorrenza (hash): " << elapsed_ms(start) << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	{
+		mshint r = a + b;
+	}
+	std::cout << "a + b (hash): " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	{
+		mshint r = a | b;
+	}
+	std::cout << "a | b (hash): " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	{
+		mshint r = a & b;
+	}
+	std::cout << "a & b (hash): " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	{
+		mshint r = a - b;
+	}
+	std::cout << "a - b (hash): " << elapsed_ms(start) << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	{
+		OrderedMultiSet<int> r = oa + ob;
+	}
+	std::cout << "a + b (ordinato): " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	{
+		OrderedMultiSet<int> r = oa & ob;
+	}
+	std::cout << "a & b (ordinato): " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	bool inc = (oa | ob).includes(ob);
+	std::cout << "(a | b).includes(b) (ordinato): " << elapsed_ms(start) << " ms (" << inc << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Ricerca di MultiSet in un MultiSet di MultiSet
+
+	@description
+	Un MultiSet con hash contiene 10^4 MultiSet di 100 interi ciascuno, indicizzati tramite
+	multiset_hash (l'impronta). Ogni ricerca confronta la chiave solo con i MultiSet che
+	hanno la stessa impronta; come riferimento viene misurato il numero di confronti tra
+	coppie di MultiSet di pari dimensione che l'impronta permette di escludere in tempo costante.
+*/
+void bench_nested_lookup() {
+	const int n = 10000; // MultiSet contenuti
+	const int m = 100; // Elementi di ciascun MultiSet
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	MultiSet<mshint, std::equal_to<mshint>, multiset_hash> outer;
+	std::vector<mshint> keys(n);
+	for(int i = 0; i < n; ++i) {
+		for(int j = 0; j < m; ++j)
+			keys[i].add(i + j);
+		outer.add(keys[i]);
+	}
+
+	counting_equal_int::calls = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::size_t found = 0;
+	for(int r = 0; r < 10; ++r)
+		for(int i = 0; i < n; ++i)
+			found += outer.contains(keys[i]);
+	double t = elapsed_ms(start);
+	std::cout << 10 * n << " ricerche di MultiSet di " << m << " interi (hash di MultiSet): " << t << " ms, ";
+	std::cout << found << " trovati, " << counting_equal_int::calls << " confronti tra interi" << std::endl;
+
+	counting_equal_int::calls = 0;
+	start = std::chrono::steady_clock::now();
+	std::size_t equal = 0;
+	for(int i = 0; i < n; ++i)
+		equal += (keys[i] == keys[(i + 1) % n]);
+	t = elapsed_ms(start);
+	std::cout << n << " confronti tra MultiSet diversi di pari dimensione: " << t << " ms, ";
+	std::cout << equal << " uguali, " << counting_equal_int::calls << " confronti tra interi" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Visita degli elementi di un MultiSet con frequenze sbilanciate
+
+	@description
+	Il MultiSet contiene 10^4 valori distinti con 10^3 occorrenze ciascuno. Il numero di
+	occorrenze di ogni valore è calcolato scorrendo const_iterator (un passo per occorrenza)
+	e distinct() (un passo per valore distinto); viene misurata anche la stampa su stream.
+*/
+void bench_distinct() {
+	const int d = 10000; // Valori distinti
+	const int k = 1000; // Occorrenze di ciascun valore
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	mshint ms;
+	for(int i = 0; i < d; ++i)
+		ms.add(i, k);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long long sum = 0;
+	for(mshint::const_iterator i = ms.begin(); i != ms.end(); ++i)
+		sum += *i;
+	double t = elapsed_ms(start);
+	std::cout << "somma di " << d << " valori x " << k << " occorrenze con const_iterator: " << t << " ms (" << sum << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	mshint::distinct_range r = ms.distinct();
+	for(mshint::distinct_iterator i = r.begin(); i != r.end(); ++i)
+		sum += static_cast<unsigned long long>(i.value()) * i.count();
+	t = elapsed_ms(start);
+	std::cout << "somma con distinct(): " << t << " ms (" << sum << ")" << std::endl;
+
+	std::ostringstream os;
+	start = std::chrono::steady_clock::now();
+	os << ms;
+	t = elapsed_ms(start);
+	std::cout << "stampa su stream: " << t << " ms, " << os.str().size() << " caratteri" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Accesso per posizione ad un FlatMultiSet
+
+	@description
+	10^4 valori distinti, con numeri di occorrenze casuali tra 1 e 1000. Viene misurato il
+	campionamento di 10^5 elementi con probabilità proporzionale al numero di occorrenze:
+	nel FlatMultiSet tramite nth() (ricerca binaria sulle somme prefisse), nel MultiSet con
+	hash avanzando un iteratore forward dall'inizio (su 10^2 campioni). Viene misurata
+	anche la visita completa con i due iteratori.
+*/
+void bench_flat() {
+	const int d = 10000; // Valori distinti
+	const int samples = 100000; // Campioni estratti dal FlatMultiSet
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	mshint ms;
+	std::srand(2);
+	for(int i = 0; i < d; ++i)
+		ms.add(i, std::rand() % 1000 + 1);
+	FlatMultiSet<int, counting_equal_int> fs(ms);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned long long sum = 0;
+	for(int i = 0; i < samples; ++i)
+		sum += fs.nth(static_cast<std::size_t>(std::rand()) % fs.size());
+	double t = elapsed_ms(start);
+	std::cout << samples << " campioni con nth() (flat): " << t << " ms (" << sum << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(int i = 0; i < samples / 1000; ++i) {
+		mshint::const_iterator it = ms.begin();
+		std::advance(it, static_cast<std::size_t>(std::rand()) % ms.size());
+		sum += *it;
+	}
+	t = elapsed_ms(start);
+	std::cout << samples / 1000 << " campioni con std::advance() (hash): " << t << " ms (" << sum << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(FlatMultiSet<int, counting_equal_int>::const_iterator i = fs.begin(); i != fs.end(); ++i)
+		sum += *i;
+	t = elapsed_ms(start);
+	std::cout << "visita di " << fs.size() << " elementi (flat): " << t << " ms (" << sum << ")" << std::endl;
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(mshint::const_iterator i = ms.begin(); i != ms.end(); ++i)
+		sum += *i;
+	t = elapsed_ms(start);
+	std::cout << "visita di " << ms.size() << " elementi (hash): " << t << " ms (" << sum << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Estrazioni pesate da un MultiSet
+
+	@description
+	Stessi dati di bench_flat(): 10^6 estrazioni in blocco tramite la tabella alias di
+	multiset_sampler, confrontate con nth() del FlatMultiSet. Viene misurata anche la
+	costruzione della tabella.
+*/
+void bench_sampler() {
+	const int d = 10000; // Valori distinti
+	const int n = 1000000; // Estrazioni
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	mshint ms;
+	std::srand(2);
+	for(int i = 0; i < d; ++i)
+		ms.add(i, std::rand() % 1000 + 1);
+	FlatMultiSet<int, counting_equal_int> fs(ms);
+	std::mt19937 g(1);
+	std::vector<int> out(n);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	multiset_sampler<int> s(ms);
+	double t = elapsed_ms(start);
+	std::cout << "costruzione della tabella alias su " << d << " valori distinti: " << t << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	s.sample(g, n, out.begin());
+	t = elapsed_ms(start);
+	std::cout << n << " estrazioni con la tabella alias: " << t << " ms (" << out[n - 1] << ")" << std::endl;
+
+	std::uniform_int_distribution<std::size_t> pos(0, fs.size() - 1);
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < n; ++i)
+		out[i] = fs.nth(pos(g));
+	t = elapsed_ms(start);
+	std::cout << n << " estrazioni con nth() (flat): " << t << " ms (" << out[n - 1] << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Valori più frequenti di un MultiSet con 10^6 valori distinti
+
+	@description
+	Viene confrontato top_k(10) con la copia di tutti i nodi tramite distinct() seguita
+	da un ordinamento, e con l'indice dei valori più frequenti, di cui viene misurato anche
+	il costo aggiuntivo sugli inserimenti.
+*/
+void bench_top_k() {
+	const int d = 1000000; // Valori distinti
+	const std::size_t k = 10; // Valori richiesti
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	std::vector<int> counts(d);
+	std::srand(3);
+	for(int i = 0; i < d; ++i)
+		counts[i] = std::rand() % 10000 + 1;
+	mshint ms, idx;
+	idx.enable_top_index();
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < d; ++i)
+		ms.add(i, counts[i]);
+	std::cout << "add() di " << d << " valori distinti: " << elapsed_ms(start) << " ms" << std::endl;
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < d; ++i)
+		idx.add(i, counts[i]);
+	std::cout << "add() di " << d << " valori distinti con l'indice: " << elapsed_ms(start) << " ms" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	std::vector<std::pair<std::size_t, int>> all;
+	mshint::distinct_range r = ms.distinct();
+	for(mshint::distinct_iterator i = r.begin(); i != r.end(); ++i)
+		all.push_back(std::make_pair(i.count(), i.value()));
+	std::sort(all.begin(), all.end());
+	std::cout << "copia ed ordinamento di tutti i valori: " << elapsed_ms(start) << " ms (" << all.back().first << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	std::vector<std::pair<int, mshint::size_type>> top = ms.top_k(k);
+	std::cout << "top_k(" << k << "): " << elapsed_ms(start) << " ms (" << top[0].second << ")" << std::endl;
+	start = std::chrono::steady_clock::now();
+	for(int i = 0; i < 1000; ++i)
+		top = idx.top_k(k);
+	std::cout << "10^3 top_k(" << k << ") con l'indice: " << elapsed_ms(start) << " ms (" << top[0].second << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Dati di un thread che elabora una parte di un flusso
+*/
+struct approx_task {
+	const std::vector<int> *stream; ///< Flusso completo
+	std::size_t first; ///< Primo elemento della parte
+	std::size_t last; ///< Fine della parte
+	ApproxMultiSet<int> sketch; ///< Stime della parte
+};
+
+/**
+	@brief Corpo di un thread che inserisce una parte di un flusso in un ApproxMultiSet
+
+	@param arg puntatore ad un approx_task
+
+	@return nullptr
+*/
+void* approx_run(void *arg) {
+	approx_task *t = static_cast<approx_task*>(arg);
+	for(std::size_t i = t->first; i < t->last; ++i)
+		t->sketch.add((*t->stream)[i]);
+	return nullptr;
+}
+
+/**
+	@brief Conteggio di un flusso di 10^7 elementi con circa 5*10^6 valori distinti
+
+	@description
+	Il flusso è contato in modo esatto con un MultiSet con hash e in modo approssimato con
+	un ApproxMultiSet (epsilon 10^-4, delta 10^-2), sia su un solo thread sia su 4 thread
+	con unione finale. Sono stampate la memoria occupata dai nodi del MultiSet e dai contatori
+	del Count-Min sketch, e l'errore massimo delle stime dei valori più frequenti.
+*/
+void bench_approx() {
+	const int n = 10000000; // Lunghezza del flusso
+	const int nthreads = 4; // Thread usati per l'elaborazione parallela
+	std::vector<int> stream(n);
+	std::srand(4);
+	for(int i = 0; i < n; ++i)
+		stream[i] = (std::rand() % 2 == 0) ? std::rand() % 1000 : std::rand();
+
+	typedef MultiSet<int, counting_equal_int, std::hash<int>> mshint;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	mshint exact;
+	for(int i = 0; i < n; ++i)
+		exact.add(stream[i]);
+	double t = elapsed_ms(start);
+	std::cout << "conteggio esatto (hash): " << t << " ms, " << exact.distinct_size() << " valori distinti, circa ";
+	std::cout << exact.distinct_size() * 4 * sizeof(std::size_t) / (1024 * 1024) << " MiB di nodi" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	ApproxMultiSet<int> approx(0.0001, 0.01, 1000);
+	for(int i = 0; i < n; ++i)
+		approx.add(stream[i]);
+	t = elapsed_ms(start);
+	std::cout << "conteggio approssimato: " << t << " ms, " << approx.width() * approx.depth() * sizeof(std::size_t) / 1024;
+	std::cout << " KiB di contatori" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	std::vector<approx_task> tasks(nthreads);
+	std::vector<pthread_t> threads(nthreads);
+	for(int i = 0; i < nthreads; ++i) {
+		tasks[i].stream = &stream;
+		tasks[i].first = static_cast<std::size_t>(n) / nthreads * i;
+		tasks[i].last = (i == nthreads - 1) ? n : static_cast<std::size_t>(n) / nthreads * (i + 1);
+		tasks[i].sketch = ApproxMultiSet<int>(0.0001, 0.01, 1000);
+		pthread_create(&threads[i], nullptr, approx_run, &tasks[i]);
+	}
+	for(int i = 0; i < nthreads; ++i)
+		pthread_join(threads[i], nullptr);
+	for(int i = 1; i < nthreads; ++i)
+		tasks[0].sketch += tasks[i].sketch;
+	t = elapsed_ms(start);
+	std::cout << "conteggio approssimato su " << nthreads << " thread, con unione: " << t << " ms" << std::endl;
+
+	std::size_t maxerr = 0;
+	std::vector<std::pair<int, std::size_t>> top = tasks[0].sketch.top_k(100);
+	for(std::size_t i = 0; i < top.size(); ++i)
+		if(top[i].second - exact.nocc(top[i].first) > maxerr)
+			maxerr = top[i].second - exact.nocc(top[i].first);
+	std::cout << "  errore massimo sui 100 valori più frequenti: " << maxerr << " (limite " << 0.0001 * n << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+typedef ConcurrentMultiSet<int> cmsint; // ConcurrentMultiSet di int
+
+/**
+	@brief Dati di un thread che inserisce valori in un ConcurrentMultiSet
+*/
+struct concurrent_task {
+	cmsint *set; ///< ConcurrentMultiSet condiviso
+	const std::vector<int> *values; ///< Valori da inserire
+};
+
+/**
+	@brief Corpo di un thread che inserisce valori in un ConcurrentMultiSet
+
+	@param arg puntatore ad un concurrent_task
+
+	@return nullptr
+*/
+void* concurrent_run(void *arg) {
+	concurrent_task *t = static_cast<concurrent_task*>(arg);
+	for(std::size_t i = 0; i < t->values->size(); ++i)
+		t->set->add((*t->values)[i]);
+	return nullptr;
+}
+
+/**
+	@brief Throughput di inserimento in un ConcurrentMultiSet da 1 a N thread
+
+	@description
+	Ogni thread inserisce 10^6 valori casuali tra 10^5 valori distinti condivisi. Con una
+	sola partizione il ConcurrentMultiSet equivale ad un MultiSet protetto da un unico mutex;
+	con 64 partizioni i thread si bloccano a vicenda solo sulla stessa partizione. I thread
+	vanno da 1 al doppio dei core disponibili (almeno 4): oltre il numero di core il throughput
+	non può più crescere.
+*/
+void bench_concurrent() {
+	const int per_thread = 1000000; // Inserimenti di ciascun thread
+	unsigned int cores = std::thread::hardware_concurrency();
+	unsigned int max_threads = (cores < 2) ? 4 : 2 * cores;
+	std::vector<std::vector<int>> values(max_threads, std::vector<int>(per_thread));
+	std::mt19937 gen(17);
+	for(unsigned int i = 0; i < max_threads; ++i)
+		for(int j = 0; j < per_thread; ++j)
+			values[i][j] = static_cast<int>(gen() % 100000);
+
+	std::cout << "core disponibili: " << cores << std::endl;
+	std::size_t shard_counts[] = {1, 64};
+	for(int s = 0; s < 2; ++s) {
+		for(unsigned int n = 1; n <= max_threads; n *= 2) {
+			cmsint set(shard_counts[s]);
+			std::vector<concurrent_task> tasks(n);
+			std::vector<pthread_t> threads(n);
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			for(unsigned int i = 0; i < n; ++i) {
+				tasks[i].set = &set;
+				tasks[i].values = &values[i];
+				pthread_create(&threads[i], nullptr, concurrent_run, &tasks[i]);
+			}
+			for(unsigned int i = 0; i < n; ++i)
+				pthread_join(threads[i], nullptr);
+			double t = elapsed_ms(start);
+			std::cout << set.shard_count() << " partizioni, " << n << " thread: " << t << " ms, ";
+			std::cout << n * (per_thread / 1000.0) / t << " milioni di inserimenti al secondo" << std::endl;
+		}
+	}
+	std::cout << std::endl;
+}
+
+/**
+	@brief Costruzione di un MultiSet con hash da 10^7 elementi con 10^6 valori distinti
+
+	@description
+	Confronta il costruttore da sequenza con multiset_parallel_build() da 2 al doppio dei
+	core disponibili (almeno 4) thread.
+*/
+void bench_parallel_build() {
+	typedef MultiSet<int, std::equal_to<int>, std::hash<int>> mshint; // counting_equal_int non è thread-safe
+	const int n = 10000000; // Lunghezza della sequenza
+	unsigned int cores = std::thread::hardware_concurrency();
+	unsigned int max_threads = (cores < 2) ? 4 : 2 * cores;
+	std::vector<int> values(n);
+	std::mt19937 gen(23);
+	for(int i = 0; i < n; ++i)
+		values[i] = static_cast<int>(gen() % 1000000);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	mshint seq(values.begin(), values.end());
+	std::cout << "costruttore da sequenza: " << elapsed_ms(start) << " ms" << std::endl;
+	for(unsigned int t = 2; t <= max_threads; t *= 2) {
+		start = std::chrono::steady_clock::now();
+		mshint par = multiset_parallel_build<mshint>(values.begin(), values.end(), t);
+		double ms = elapsed_ms(start);
+		std::cout << "costruzione parallela, " << t << " thread (" << cores << " core): " << ms << " ms";
+		std::cout << (par == seq ? "" : " (RISULTATO DIVERSO)") << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+typedef SnapshotMultiSet<int> smsint; // SnapshotMultiSet di int
+
+/**
+	@brief Dati di un thread che legge numeri di occorrenze
+*/
+struct reader_task {
+	const smsint *snapshot; ///< SnapshotMultiSet letto (nullptr se si legge concurrent)
+	const cmsint *concurrent; ///< ConcurrentMultiSet letto (nullptr se si legge snapshot)
+	int lookups; ///< Numero di letture
+	int per_view; ///< Letture fatte sulla stessa vista dello SnapshotMultiSet (divisore di lookups)
+	std::size_t sum; ///< Somma dei numeri di occorrenze letti, per non eliminare le letture
+	double ms; ///< Millisecondi impiegati dal thread
+};
+
+/**
+	@brief Corpo di un thread che legge numeri di occorrenze
+
+	@description
+	Sullo SnapshotMultiSet le letture sono fatte a gruppi di per_view sulla stessa vista.
+
+	@param arg puntatore ad un reader_task
+
+	@return nullptr
+*/
+void* reader_run(void *arg) {
+	reader_task *t = static_cast<reader_task*>(arg);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for(int i = 0; i < t->lookups; i += t->per_view) {
+		if(t->snapshot != nullptr) {
+			smsint::view v = t->snapshot->read();
+			for(int j = i; j < i + t->per_view; ++j)
+				t->sum += v.nocc(j % 100000);
+		}
+		else
+			for(int j = i; j < i + t->per_view; ++j)
+				t->sum += t->concurrent->nocc(j % 100000);
+	}
+	t->ms = elapsed_ms(start);
+	return nullptr;
+}
+
+/**
+	@brief Throughput di lettura con uno scrittore che pubblica gruppi di modifiche
+
+	@description
+	Da 1 al doppio dei core disponibili (almeno 4) thread leggono 10^6 numeri di occorrenze
+	ciascuno, mentre il thread principale applica gruppi di 100 modifiche. Lo SnapshotMultiSet
+	pubblica ogni gruppo come nuova versione; il ConcurrentMultiSet a 64 partizioni applica le
+	stesse modifiche sotto i lock delle partizioni, che i lettori devono acquisire. Lo
+	SnapshotMultiSet è misurato con 1000 letture per vista e con una vista per lettura, che
+	misura la creazione delle viste (posizioni dei lettori su linee di cache separate). Il tempo
+	riportato è quello del lettore più lento.
+*/
+void bench_snapshot() {
+	const int lookups = 1000000; // Letture di ciascun thread
+	unsigned int cores = std::thread::hardware_concurrency();
+	unsigned int max_threads = (cores < 2) ? 4 : 2 * cores;
+	const char *names[] = {"SnapshotMultiSet", "SnapshotMultiSet (una vista per lettura)", "ConcurrentMultiSet (64 partizioni)"};
+	for(int kind = 0; kind < 3; ++kind) {
+		for(unsigned int n = 1; n <= max_threads; n *= 2) {
+			smsint snapshot;
+			cmsint concurrent(64);
+			for(int i = 0; i < 100000; ++i) {
+				snapshot.add(i);
+				concurrent.add(i);
+			}
+			snapshot.publish();
+			std::vector<reader_task> tasks(n);
+			std::vector<pthread_t> threads(n);
+			for(unsigned int i = 0; i < n; ++i) {
+				reader_task t = {kind < 2 ? &snapshot : nullptr, kind < 2 ? nullptr : &concurrent, lookups, kind == 1 ? 1 : 1000, 0, 0};
+				tasks[i] = t;
+				pthread_create(&threads[i], nullptr, reader_run, &tasks[i]);
+			}
+			std::mt19937 gen(29);
+			for(int batch = 0; batch < 100; ++batch) {
+				for(int j = 0; j < 100; ++j) {
+					int v = static_cast<int>(gen() % 100000);
+					if(kind < 2)
+						snapshot.add(v);
+					else
+						concurrent.add(v);
+				}
+				if(kind < 2)
+					snapshot.publish();
+			}
+			double t = 0;
+			for(unsigned int i = 0; i < n; ++i) {
+				pthread_join(threads[i], nullptr);
+				t = std::max(t, tasks[i].ms);
+			}
+			std::cout << names[kind] << ", " << n;
+			std::cout << " lettori: " << t << " ms, " << n * (lookups / 1000.0) / t << " milioni di letture al secondo" << std::endl;
+		}
+	}
+	std::cout << std::endl;
+}
+
+/**
+	@brief Punto del piano, come nei test dei MultiSet di MultiSet di point
+*/
+struct bench_point {
+	int x; ///< Ascissa
+	int y; ///< Ordinata
+};
+
+/**
+	@brief Uguaglianza tra due bench_point
+*/
+struct equal_bench_point {
+	bool operator()(const bench_point &a, const bench_point &b) const {
+		return a.x == b.x && a.y == b.y;
+	}
+};
+
+/**
+	@brief Uguaglianza tra due bench_point che conta le proprie invocazioni
+*/
+struct counting_equal_bench_point {
+	static unsigned long long calls; ///< Numero di invocazioni del funtore
+
+	bool operator()(const bench_point &a, const bench_point &b) const {
+		++calls;
+		return a.x == b.x && a.y == b.y;
+	}
+};
+
+unsigned long long counting_equal_bench_point::calls = 0;
+
+/**
+	@brief Uguaglianza tra due bench_point, dichiarata equivalente al confronto byte per byte
+*/
+struct bytewise_equal_bench_point {
+	bool operator()(const bench_point &a, const bench_point &b) const {
+		return a.x == b.x && a.y == b.y;
+	}
+};
+
+template <> struct multiset_bytewise_equal<bench_point, bytewise_equal_bench_point> : std::true_type {}; ///< bench_point non ha byte di riempimento
+
+/**
+	@brief Ricerche di MultiSet di point della stessa dimensione in un MultiSet di MultiSet senza hash
+
+	@tparam MS tipo dei MultiSet di point
+
+	@param t tempo delle ricerche (ms)
+
+	@return numero di MultiSet trovati
+*/
+template <typename MS>
+std::size_t nested_points_lookup(double &t) {
+	const int n = 2000; // MultiSet contenuti
+	const int m = 50; // Point di ciascun MultiSet
+	MultiSet<MS, std::equal_to<MS>> outer;
+	std::vector<MS> keys(n);
+	for(int i = 0; i < n; ++i) {
+		for(int j = 0; j < m; ++j) {
+			bench_point p = {i, j};
+			keys[i].add(p);
+		}
+		outer.add(keys[i]);
+	}
+	counting_equal_bench_point::calls = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::size_t found = 0;
+	for(int i = 0; i < n; ++i)
+		found += outer.contains(keys[i]);
+	t = elapsed_ms(start);
+	return found;
+}
+
+/**
+	@brief Impronta dei MultiSet interni senza funtore di hash
+
+	@description
+	Un MultiSet senza hash contiene 2000 MultiSet di 50 point senza hash, tutti della stessa
+	dimensione: ogni ricerca confronta la chiave con metà dei MultiSet contenuti. Con un funtore
+	generico l'impronta coincide con la dimensione ed ogni confronto scorre i point; con il
+	confronto byte per byte l'impronta usa l'hash dei byte dei point ed i MultiSet diversi sono
+	esclusi senza confrontare alcun point.
+*/
+void bench_nested_points_lookup() {
+	double t;
+	std::size_t found = nested_points_lookup<MultiSet<bench_point, counting_equal_bench_point>>(t);
+	std::cout << "2000 ricerche tra MultiSet di 50 point, funtore generico: " << t << " ms, " << found << " trovati, ";
+	std::cout << counting_equal_bench_point::calls << " confronti tra point" << std::endl;
+	found = nested_points_lookup<MultiSet<bench_point, bytewise_equal_bench_point>>(t);
+	std::cout << "2000 ricerche tra MultiSet di 50 point, confronto byte per byte: " << t << " ms, " << found << " trovati" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Costruzione, copia e inserimento in un MultiSet di MultiSet di piccoli MultiSet di point
+
+	@description
+	Vengono costruiti 10^6 MultiSet con da 1 a 7 point distinti (con ripetizioni), copiati,
+	e 10^5 di essi sono inseriti in un MultiSet di MultiSet con 420 elementi distinti.
+
+	@tparam MS tipo dei MultiSet di point
+
+	@param tbuild tempo di costruzione dei MultiSet (ms)
+	@param tcopy tempo di copia dei MultiSet (ms)
+	@param touter tempo di inserimento nel MultiSet di MultiSet e di ricerca (ms)
+
+	@return numero totale di elementi, per non eliminare le operazioni
+*/
+template <typename MS>
+std::size_t nested_points(double &tbuild, double &tcopy, double &touter) {
+	const int n = 1000000; // MultiSet di point
+	std::size_t total = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	{
+		std::vector<MS> sets(n);
+		for(int i = 0; i < n; ++i) {
+			int k = 1 + i % 7;
+			for(int j = 0; j < k + 2; ++j) {
+				bench_point p = {j % k, i % 60};
+				sets[i].add(p);
+			}
+		}
+		tbuild = elapsed_ms(start);
+		start = std::chrono::steady_clock::now();
+		std::vector<MS> copies(sets);
+		total += copies[n - 1].size();
+		tcopy = elapsed_ms(start);
+		start = std::chrono::steady_clock::now();
+		MultiSet<MS, std::equal_to<MS>> outer;
+		for(int i = 0; i < n / 10; ++i)
+			outer.add(sets[i]);
+		for(int i = 0; i < 420; ++i)
+			total += outer.nocc(sets[i]);
+		touter = elapsed_ms(start);
+	}
+	return total;
+}
+
+/**
+	@brief Confronto tra MultiSet di point senza e con 8 nodi interni
+
+	@description
+	I MultiSet di point hanno al più 7 elementi distinti: con 8 nodi interni nessun nodo è
+	richiesto all'allocatore, e copiare un MultiSet non alloca memoria; in cambio ogni oggetto
+	MultiSet è più grande, e la copia del vettore sposta più byte.
+*/
+void bench_inline() {
+	typedef MultiSet<bench_point, equal_bench_point> msp;
+	typedef MultiSet<bench_point, equal_bench_point, multiset_no_hash, std::allocator<bench_point>, 8> mssp;
+	double b, c, o;
+	std::size_t r = nested_points<msp>(b, c, o);
+	std::cout << "MultiSet di point, nodi allocati (" << sizeof(msp) << " byte): costruzione " << b << " ms, copia ";
+	std::cout << c << " ms, MultiSet di MultiSet " << o << " ms" << std::endl;
+	r += nested_points<mssp>(b, c, o);
+	std::cout << "MultiSet di point, 8 nodi interni (" << sizeof(mssp) << " byte): costruzione " << b << " ms, copia ";
+	std::cout << c << " ms, MultiSet di MultiSet " << o << " ms" << std::endl;
+	std::cout << "elementi contati: " << r << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Funtore di uguaglianza generico, che obbliga FlatMultiSet alla ricerca scalare
+
+	@tparam T tipo dei valori confrontati
+*/
+template <typename T>
+struct scalar_equal {
+	bool operator()(const T &a, const T &b) const {
+		return a==b;
+	}
+};
+
+/**
+	@brief Ricerche di valori casuali in un multiset di d valori distinti
+
+	@description
+	Metà delle ricerche riguarda valori presenti, metà valori assenti (scansione completa).
+
+	@tparam MS tipo del multiset
+	@tparam T tipo dei valori
+
+	@param d numero di valori distinti
+	@param lookups numero di ricerche
+	@param found somma dei numeri di occorrenze trovati
+
+	@return millisecondi impiegati dalle ricerche
+*/
+template <typename MS, typename T>
+double scan_lookups(int d, int lookups, std::size_t &found) {
+	MS ms;
+	for(int i = 0; i < d; ++i)
+		ms.add(static_cast<T>(i), static_cast<std::size_t>(i % 3 + 1));
+	std::mt19937 gen(5);
+	std::vector<T> keys(lookups);
+	for(int i = 0; i < lookups; ++i)
+		keys[i] = static_cast<T>(static_cast<int>(gen() % static_cast<unsigned>(2 * d)));
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	found = 0;
+	for(int i = 0; i < lookups; ++i)
+		found += ms.nocc(keys[i]);
+	return elapsed_ms(start);
+}
+
+/**
+	@brief Ricerca vettoriale di chiavi aritmetiche nel FlatMultiSet
+
+	@description
+	Per d = 16, 64, 256 e 1024 valori distinti (int e double) viene misurato il tempo di
+	2*10^6 / d * 16 ricerche con nocc() nel MultiSet senza hash (lista di nodi), nel
+	FlatMultiSet con un funtore generico (ricerca scalare) e nel FlatMultiSet con
+	std::equal_to (multiset_scan()).
+*/
+void bench_scan() {
+	const int sizes[] = {16, 64, 256, 1024};
+	for(int k = 0; k < 4; ++k) {
+		const int d = sizes[k];
+		const int lookups = 2000000 / d * 16;
+		std::size_t f1, f2, f3;
+		double l = scan_lookups<MultiSet<int, std::equal_to<int>>, int>(d, lookups, f1);
+		double s = scan_lookups<FlatMultiSet<int, scalar_equal<int>>, int>(d, lookups, f2);
+		double v = scan_lookups<FlatMultiSet<int, std::equal_to<int>>, int>(d, lookups, f3);
+		std::cout << "int, d = " << d << ", " << lookups << " ricerche: lista " << l << " ms, flat scalare ";
+		std::cout << s << " ms, flat vettoriale " << v << " ms (" << f1 << " " << f2 << " " << f3 << ")" << std::endl;
+		l = scan_lookups<MultiSet<double, std::equal_to<double>>, double>(d, lookups, f1);
+		s = scan_lookups<FlatMultiSet<double, scalar_equal<double>>, double>(d, lookups, f2);
+		v = scan_lookups<FlatMultiSet<double, std::equal_to<double>>, double>(d, lookups, f3);
+		std::cout << "double, d = " << d << ", " << lookups << " ricerche: lista " << l << " ms, flat scalare ";
+		std::cout << s << " ms, flat vettoriale " << v << " ms (" << f1 << " " << f2 << " " << f3 << ")" << std::endl;
+	}
+	std::cout << std::endl;
+}
+
+/**
+	@brief Operazioni tra MultiSet senza hash di d interi distinti
+
+	@description
+	Il secondo MultiSet contiene metà dei valori del primo, inseriti in ordine inverso: il
+	confronto non può avanzare in parallelo sulle due liste.
+
+	@tparam MS tipo del MultiSet
+	@param d numero di valori distinti del primo MultiSet
+	@param times millisecondi impiegati da ==, includes(), & e - (in quest'ordine)
+
+	@return somma dei risultati, per evitare che le operazioni siano eliminate
+*/
+template <typename MS>
+std::size_t list_algebra(int d, double *times) {
+	MS a, b, c;
+	for(int i = 0; i < d; ++i) {
+		a.add(i, static_cast<std::size_t>(i % 4 + 1));
+		c.add(d - 1 - i, static_cast<std::size_t>((d - 1 - i) % 4 + 1));
+	}
+	for(int i = d - 1; i >= 0; i -= 2)
+		b.add(i, 2);
+	std::size_t r = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	r += (a == c) ? 1 : 0;
+	times[0] = elapsed_ms(start);
+	start = std::chrono::steady_clock::now();
+	r += a.includes(b) ? 1 : 0;
+	times[1] = elapsed_ms(start);
+	start = std::chrono::steady_clock::now();
+	r += (a & b).size();
+	times[2] = elapsed_ms(start);
+	start = std::chrono::steady_clock::now();
+	r += (a - b).size();
+	times[3] = elapsed_ms(start);
+	return r;
+}
+
+/**
+	@brief Operazioni tra MultiSet senza hash con un funtore generico o std::equal_to
+
+	@description
+	Con std::equal_to<int> il confronto è byte per byte (multiset_bytewise_equal): le
+	operazioni ordinano i nodi di uno dei due MultiSet invece di scandire la lista per ogni
+	elemento, passando da O(d^2) a O(d log d).
+*/
+void bench_plain_equal() {
+	const int d = 8000; // Valori distinti
+	double g[4], p[4];
+	std::size_t r = list_algebra<MultiSet<int, scalar_equal<int>>>(d, g);
+	r += list_algebra<MultiSet<int, std::equal_to<int>>>(d, p);
+	const char *names[] = {"==", "includes()", "a & b", "a - b"};
+	for(int k = 0; k < 4; ++k)
+		std::cout << names[k] << " su " << d << " valori distinti (lista): funtore generico " << g[k] << " ms, std::equal_to " << p[k] << " ms" << std::endl;
+	std::cout << "risultati: " << r << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Funtore trasparente di uguaglianza tra std::string e stringhe C
+*/
+struct equal_string_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi di tipo diverso da std::string
+
+	bool operator()(const std::string &a, const std::string &b) const {
+		return a == b;
+	}
+
+	bool operator()(const std::string &a, const char *b) const {
+		return a.compare(b) == 0;
+	}
+};
+
+/**
+	@brief Funtore trasparente di hash (FNV-1a) per std::string e stringhe C
+*/
+struct hash_string_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi di tipo diverso da std::string
+
+	std::size_t operator()(const char *s, std::size_t n) const {
+		std::size_t h = 14695981039346656037ULL;
+		for(std::size_t i = 0; i < n; ++i)
+			h = (h ^ static_cast<unsigned char>(s[i])) * 1099511628211ULL;
+		return h;
+	}
+
+	std::size_t operator()(const std::string &s) const {
+		return (*this)(s.data(), s.size());
+	}
+
+	std::size_t operator()(const char *s) const {
+		return (*this)(s, std::strlen(s));
+	}
+};
+
+/**
+	@brief Ricerche di stringhe C in un MultiSet di std::string
+
+	@description
+	10^4 chiavi distinte di 24 caratteri (oltre la small string optimization) e 10^6
+	ricerche con nocc(): passando il const char*, che il funtore trasparente confronta
+	direttamente, oppure costruendo una std::string temporanea per ogni ricerca.
+*/
+void bench_transparent() {
+	const int d = 10000; // Chiavi distinte
+	const int lookups = 1000000; // Ricerche
+	typedef MultiSet<std::string, equal_string_key, hash_string_key> mskstr;
+	mskstr ms;
+	std::vector<std::vector<char>> keys(d, std::vector<char>(32));
+	for(int i = 0; i < d; ++i) {
+		std::sprintf(keys[i].data(), "token-%018d", i);
+		ms.add(std::string(keys[i].data()), static_cast<std::size_t>(i % 3 + 1));
+	}
+	std::mt19937 gen(9);
+	std::vector<int> order(lookups);
+	for(int i = 0; i < lookups; ++i)
+		order[i] = static_cast<int>(gen() % d);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::size_t sum = 0;
+	for(int i = 0; i < lookups; ++i)
+		sum += ms.nocc(static_cast<const char*>(keys[order[i]].data()));
+	double t = elapsed_ms(start);
+	std::cout << lookups << " nocc() con const char* (hash trasparente): " << t << " ms (" << sum << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(int i = 0; i < lookups; ++i)
+		sum += ms.nocc(std::string(keys[order[i]].data()));
+	t = elapsed_ms(start);
+	std::cout << lookups << " nocc() con std::string temporanea: " << t << " ms (" << sum << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Conteggio di token con un MultiSet di std::string e con uno StringMultiSet
+
+	@description
+	Flusso di 4*10^6 token estratti da un vocabolario di 10^6 parole di 3-24 caratteri
+	(circa un terzo oltre la small string optimization). Sono misurati il conteggio e 10^6
+	ricerche; la memoria del MultiSet è stimata (nodo, bucket, caratteri allocati a parte
+	e 16 byte di intestazione per allocazione), quella dello StringMultiSet è misurata da
+	memory_usage().
+*/
+void bench_string_multiset() {
+	const int vocabulary = 1000000; // Parole distinte
+	const int n = 4000000; // Token del flusso
+	typedef MultiSet<std::string, std::equal_to<std::string>, std::hash<std::string>> mshstr;
+	std::vector<std::string> words(vocabulary);
+	std::mt19937 gen(13);
+	for(int i = 0; i < vocabulary; ++i) {
+		std::string w(3 + gen() % 22, 'a');
+		for(std::size_t j = 0; j < w.size(); ++j)
+			w[j] = static_cast<char>('a' + gen() % 26);
+		words[i] = w;
+	}
+	std::vector<int> stream(n);
+	for(int i = 0; i < n; ++i)
+		stream[i] = static_cast<int>(gen() % vocabulary);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	mshstr ms;
+	for(int i = 0; i < n; ++i)
+		ms.add(words[stream[i]]);
+	double t = elapsed_ms(start);
+	std::size_t bytes = ms.distinct_size() * (sizeof(std::string) + 3 * sizeof(std::size_t) + 16 + sizeof(void*));
+	mshstr::distinct_range r = ms.distinct();
+	for(mshstr::distinct_iterator i = r.begin(); i != r.end(); ++i)
+		if(i.value().size() > 15)
+			bytes += (i.value().size() + 16) / 16 * 16 + 16;
+	std::cout << "conteggio di " << n << " token (MultiSet di std::string): " << t << " ms, " << ms.distinct_size();
+	std::cout << " distinti, circa " << bytes / (1024 * 1024) << " MiB" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	StringMultiSet sm;
+	for(int i = 0; i < n; ++i)
+		sm.add(words[stream[i]]);
+	t = elapsed_ms(start);
+	std::cout << "conteggio di " << n << " token (StringMultiSet): " << t << " ms, " << sm.distinct_size();
+	std::cout << " distinti, " << sm.memory_usage() / (1024 * 1024) << " MiB" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	std::size_t sum = 0;
+	for(int i = 0; i < n / 4; ++i)
+		sum += ms.nocc(words[stream[i]]);
+	t = elapsed_ms(start);
+	std::cout << n / 4 << " nocc() (MultiSet di std::string): " << t << " ms (" << sum << ")" << std::endl;
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	for(int i = 0; i < n / 4; ++i)
+		sum += sm.nocc(words[stream[i]]);
+	t = elapsed_ms(start);
+	std::cout << n / 4 << " nocc() (StringMultiSet): " << t << " ms (" << sum << ")" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Formato binario contro stampa testuale, lettura completa contro MappedMultiSet
+
+	@description
+	MultiSet con hash di 10^6 interi casuali, con occorrenze da 1 a 1000. Sono misurate
+	la scrittura testuale (operator<<) e binaria (multiset_write) con le rispettive
+	dimensioni, la lettura del file in un MultiSet e 10^5 ricerche eseguite dopo la
+	lettura completa oppure direttamente sul file tramite MappedMultiSet.
+*/
+void bench_binary() {
+	const int n = 1000000; // Valori distinti
+	const int queries = 100000; // Ricerche dopo l'apertura del file
+	typedef MultiSet<int, std::equal_to<int>, std::hash<int>> mshint;
+	const char *path = "bench_multiset.bin";
+	mshint ms;
+	ms.reserve(n);
+	std::mt19937 gen(17);
+	std::vector<int> values(n);
+	for(int i = 0; i < n; ++i) {
+		values[i] = static_cast<int>(gen());
+		ms.add(values[i], 1 + gen() % 1000);
+	}
+	std::vector<int> keys(queries); // Metà presenti, metà casuali (quasi sempre assenti)
+	for(int i = 0; i < queries; ++i)
+		keys[i] = (i % 2 == 0) ? values[gen() % n] : static_cast<int>(gen());
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::ostringstream text;
+	text << ms;
+	double t = elapsed_ms(start);
+	std::cout << "stampa testuale di " << ms.distinct_size() << " distinti: " << t << " ms, ";
+	std::cout << text.str().size() / 1024 << " KiB" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	{
+		std::ofstream out(path, std::ios::binary);
+		multiset_write(out, ms);
+	}
+	t = elapsed_ms(start);
+	std::ifstream size_in(path, std::ios::binary | std::ios::ate);
+	std::cout << "multiset_write() su file: " << t << " ms, " << static_cast<long long>(size_in.tellg()) / 1024;
+	std::cout << " KiB (indice compreso)" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	mshint loaded;
+	{
+		std::ifstream in(path, std::ios::binary);
+		multiset_read(in, loaded);
+	}
+	std::size_t sum = 0;
+	for(int i = 0; i < queries; ++i)
+		sum += loaded.nocc(keys[i]);
+	t = elapsed_ms(start);
+	std::cout << "multiset_read() e " << queries << " nocc(): " << t << " ms (" << sum << ")" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	sum = 0;
+	{
+		MappedMultiSet<int, std::equal_to<int>, std::hash<int>> view(path);
+		for(int i = 0; i < queries; ++i)
+			sum += view.nocc(keys[i]);
+	}
+	t = elapsed_ms(start);
+	std::cout << "MappedMultiSet e " << queries << " nocc(): " << t << " ms (" << sum << ")" << std::endl;
+	std::remove(path);
+	std::cout << std::endl;
+}
+
+int main() {
+
+	bench_add_distinct();
+	bench_destroy_large();
+	bench_pool_allocator();
+	bench_bulk_load();
+	bench_copy();
+	bench_algebra();
+	bench_nested_lookup();
+	bench_distinct();
+	bench_flat();
+	bench_sampler();
+	bench_top_k();
+	bench_approx();
+	bench_concurrent();
+	bench_parallel_build();
+	bench_snapshot();
+	bench_inline();
+	bench_nested_points_lookup();
+	bench_scan();
+	bench_plain_equal();
+	bench_transparent();
+	bench_string_multiset();
+	bench_binary();
+
+	return 0;
+}
@@ -0,0 +1,365 @@
+/**
+	@headerfile concurrent_multiset.h
+
+	@brief Dichiarazione e definizione di una classe templata ConcurrentMultiSet, che
+	permette a più thread di modificare e interrogare lo stesso MultiSet.
+*/
+
+// Guardie
+
+#ifndef CONCURRENT_MULTISET_H
+#define CONCURRENT_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t
+#include <functional> // std::hash, std::equal_to
+#include <limits> // std::numeric_limits
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_value_not_found, multiset_count_overflow
+#include "multiset.h" // MultiSet
+
+/**
+	@brief MultiSet thread-safe a lock partizionati, templato su tre parametri
+
+	@description
+	Gli elementi sono distribuiti, in base al loro hash, tra shard_count() partizioni:
+	ciascuna è un MultiSet con hash protetto da un proprio mutex. Le operazioni su un singolo
+	valore bloccano solo la partizione del valore, quindi thread che lavorano su valori diversi
+	procedono in parallelo a meno di collisioni tra partizioni. Per la scelta della partizione
+	sono usati i bit alti dell'hash rimescolato, mentre i bucket di ciascun MultiSet usano
+	quelli bassi: i valori di una partizione restano quindi distribuiti su tutti i suoi bucket.
+	L'hash rimescolato è calcolato una sola volta per operazione e passato al MultiSet della
+	partizione (MultiSet::add_hashed() e seguenti), che lo usa direttamente per la ricerca nei bucket.
+	Le operazioni sull'intero insieme (size(), snapshot(), ...) visitano le partizioni in ordine.
+
+	@tparam T tipo degli elementi del ConcurrentMultiSet
+	@tparam E funtore di uguaglianza tra due elementi
+	@tparam H funtore di hash degli elementi
+*/
+template <typename T, typename E = std::equal_to<T>, typename H = std::hash<T>>
+class ConcurrentMultiSet {
+
+public:
+
+	typedef MultiSet<T,E,H> multiset_type; ///< Tipo del MultiSet di ciascuna partizione
+	typedef std::size_t size_type; ///< Tipo dei numeri di occorrenze e delle dimensioni
+
+private:
+
+	// Sezione privata della classe
+
+	/**
+		Partizione del ConcurrentMultiSet
+	*/
+	struct shard {
+		std::mutex lock; ///< Mutex che protegge la partizione
+		multiset_type set; ///< Elementi della partizione
+		char pad[64]; ///< Separa i dati di partizioni diverse su linee di cache diverse
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct shard
+
+	/**
+		Valore di un MultiSet in attesa di essere sommato alla sua partizione
+	*/
+	struct pending {
+		const T *value; ///< Valore da sommare
+		std::size_t hash; ///< Hash rimescolato del valore
+		std::size_t count; ///< Numero di occorrenze da sommare
+	};
+
+	// Dati membro privati
+
+	std::unique_ptr<shard[]> _shards; ///< Array delle partizioni
+	std::size_t _nshards; ///< Numero di partizioni (una potenza di 2)
+	std::size_t _shift; ///< Bit dell'hash rimescolato da scartare per ottenere la partizione
+
+	/**
+		@brief Hash rimescolato di un valore
+
+		@description
+		È l'hash dei MultiSet delle partizioni (multiset_type::hash_value()), calcolato tramite
+		la prima partizione senza acquisirne il lock: il funtore di hash non è mai modificato.
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash rimescolato di v
+	*/
+	std::size_t hash_of(const T &v) const {
+		return _shards[0].set.hash_value(v);
+	}
+
+	/**
+		@brief Partizione di un hash
+
+		@param h hash rimescolato di un valore
+
+		@return riferimento alla partizione che contiene (o conterrebbe) il valore
+	*/
+	shard& shard_at(std::size_t h) const {
+		return _shards[index_at(h)];
+	}
+
+	/**
+		@brief Indice della partizione di un hash
+
+		@param h hash rimescolato di un valore
+
+		@return indice della partizione, formato dai bit alti di h
+	*/
+	std::size_t index_at(std::size_t h) const {
+		if(_nshards == 1)
+			return 0;
+		return h >> _shift;
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	ConcurrentMultiSet(const ConcurrentMultiSet &other) = delete; // Non copiabile: si veda snapshot()
+	ConcurrentMultiSet& operator=(const ConcurrentMultiSet &other) = delete; // Non assegnabile
+
+	/**
+		@brief Costruttore per ConcurrentMultiSet
+
+		@description
+		Il numero di partizioni è arrotondato alla potenza di 2 successiva (almeno 1). Più
+		partizioni riducono la contesa tra i thread, al costo di qualche MultiSet vuoto.
+
+		@param shards numero minimo di partizioni
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	explicit ConcurrentMultiSet(size_type shards = 64) : _nshards(1), _shift(std::numeric_limits<std::size_t>::digits) {
+		while(_nshards < shards) {
+			_nshards *= 2;
+			--_shift;
+		}
+		_shards.reset(new shard[_nshards]);
+	}
+
+	// Il distruttore è lasciato al compilatore
+
+	/**
+		@brief Numero di partizioni
+
+		@return numero di partizioni del ConcurrentMultiSet
+	*/
+	size_type shard_count() const {
+		return _nshards;
+	}
+
+	/**
+		@brief Inserimento di un elemento
+
+		@param v valore da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v) {
+		std::size_t h = hash_of(v);
+		shard &s = shard_at(h);
+		std::lock_guard<std::mutex> guard(s.lock);
+		s.set.add_hashed(v, h, 1);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento
+
+		@param v valore da inserire
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il ConcurrentMultiSet resta invariato)
+	*/
+	void add(const T &v, size_type k) {
+		std::size_t h = hash_of(v);
+		shard &s = shard_at(h);
+		std::lock_guard<std::mutex> guard(s.lock);
+		s.set.add_hashed(v, h, k);
+	}
+
+	/**
+		@brief Rimozione di un elemento
+
+		@param v valore da rimuovere
+
+		@throw Eccezione custom per elemento non presente
+	*/
+	void remove(const T &v) {
+		std::size_t h = hash_of(v);
+		shard &s = shard_at(h);
+		std::lock_guard<std::mutex> guard(s.lock);
+		s.set.remove_hashed(v, h, 1);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento
+
+		@param v valore da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove(const T &v, size_type k) {
+		std::size_t h = hash_of(v);
+		shard &s = shard_at(h);
+		std::lock_guard<std::mutex> guard(s.lock);
+		s.set.remove_hashed(v, h, k);
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento
+
+		@param v valore di cui sapere il numero di occorrenze
+
+		@return numero di occorrenze di v, 0 se non è presente
+	*/
+	size_type nocc(const T &v) const {
+		std::size_t h = hash_of(v);
+		shard &s = shard_at(h);
+		std::lock_guard<std::mutex> guard(s.lock);
+		return s.set.nocc_hashed(v, h);
+	}
+
+	/**
+		@brief Ricerca di un elemento
+
+		@param v elemento da cercare
+
+		@return true se l'elemento è presente, false altrimenti
+	*/
+	bool contains(const T &v) const {
+		return nocc(v) > 0;
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@description
+		Le partizioni sono bloccate una alla volta: se altri thread modificano il
+		ConcurrentMultiSet durante la chiamata, il risultato può non corrispondere ad alcuno
+		stato effettivamente raggiunto. Per un valore coerente si usi snapshot().
+
+		@return numero totale di elementi
+	*/
+	size_type size() const {
+		std::size_t total = 0;
+		for(std::size_t i = 0; i < _nshards; ++i) {
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			total += _shards[i].set.size();
+		}
+		return total;
+	}
+
+	/**
+		@brief Numero di elementi distinti
+
+		@description
+		Come size(), le partizioni sono bloccate una alla volta.
+
+		@return numero di elementi distinti
+	*/
+	size_type distinct_size() const {
+		std::size_t total = 0;
+		for(std::size_t i = 0; i < _nshards; ++i) {
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			total += _shards[i].set.distinct_size();
+		}
+		return total;
+	}
+
+	/**
+		@brief Rimozione di tutti gli elementi
+
+		@post Ogni partizione è vuota (salvo inserimenti concorrenti nelle partizioni già svuotate)
+	*/
+	void clear() {
+		for(std::size_t i = 0; i < _nshards; ++i) {
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			_shards[i].set.clear();
+		}
+	}
+
+	/**
+		@brief Somma di un MultiSet
+
+		@description
+		Gli elementi distinti di other sono prima raggruppati per partizione, poi ogni partizione
+		è bloccata una sola volta per aggiungere tutti i suoi valori: un thread che ha costruito
+		un MultiSet privato lo riversa così con shard_count() acquisizioni invece di una per valore.
+		L'hash di ogni valore è calcolato una sola volta, al raggruppamento.
+
+		@param other MultiSet da sommare
+
+		@return Riferimento al ConcurrentMultiSet corrente
+
+		@post nocc(v) è incrementato di other.nocc(v) per ogni valore v
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (le partizioni già
+		aggiornate restano modificate)
+	*/
+	ConcurrentMultiSet& operator+=(const multiset_type &other) {
+		std::vector<std::vector<pending>> groups(_nshards);
+		typename multiset_type::distinct_range r = other.distinct();
+		for(typename multiset_type::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			pending p = { &i.value(), hash_of(i.value()), i.count() };
+			groups[index_at(p.hash)].push_back(p);
+		}
+		for(std::size_t i = 0; i < _nshards; ++i) {
+			if(groups[i].empty())
+				continue;
+			std::lock_guard<std::mutex> guard(_shards[i].lock);
+			for(std::size_t j = 0; j < groups[i].size(); ++j)
+				_shards[i].set.add_hashed(*groups[i][j].value, groups[i][j].hash, groups[i][j].count);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Copia coerente del contenuto
+
+		@description
+		Tutte le partizioni sono bloccate, sempre nello stesso ordine (quindi senza rischio di
+		deadlock tra più chiamate concorrenti), e poi sommate in un unico MultiSet: il risultato
+		è uno stato effettivamente raggiunto dal ConcurrentMultiSet.
+
+		@return MultiSet con gli stessi elementi del ConcurrentMultiSet
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	multiset_type snapshot() const {
+		multiset_type res;
+		std::size_t locked = 0;
+		try {
+			for(; locked < _nshards; ++locked)
+				_shards[locked].lock.lock();
+			std::size_t distinct = 0;
+			for(std::size_t i = 0; i < _nshards; ++i)
+				distinct += _shards[i].set.distinct_size();
+			res.reserve(distinct);
+			for(std::size_t i = 0; i < _nshards; ++i)
+				res += _shards[i].set;
+		}
+		catch(...) { // Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+			while(locked > 0)
+				_shards[--locked].lock.unlock();
+			throw;
+		}
+		while(locked > 0)
+			_shards[--locked].lock.unlock();
+		return res;
+	}
+
+}; // class ConcurrentMultiSet
+
+#endif
+
+// Fine concurrent_multiset.h
@@ -0,0 +1,840 @@
+/**
+	@headerfile flat_multiset.h
+
+	@brief Dichiarazione e definizione di una classe templata FlatMultiSet, con i valori
+	ed i numeri di occorrenze memorizzati in array contigui, e ridefinizione dell'operatore
+	di stream <<.
+
+	@description
+	Definendo la macro MULTISET_NO_ITERATOR_CHECKS prima dell'inclusione, gli iteratori
+	non verificano di essere interni al contenitore (nessuna eccezione
+	multiset_iterator_out_of_bounds): l'uso di un iteratore fuori dai limiti ha allora
+	comportamento indefinito. La macro vale anche per MultiSet ed OrderedMultiSet.
+*/
+
+// Guardie
+
+#ifndef FLAT_MULTISET_H
+#define FLAT_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <ostream> // std::ostream
+#include <algorithm> // std::swap, std::upper_bound
+#include <iterator> // std::random_access_iterator_tag
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::integral_constant
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_iterator_out_of_bounds, multiset_value_not_found, multiset_count_overflow
+#include "multiset.h" // MultiSet
+#include "multiset_equal.h" // multiset_equal
+#include "multiset_simd.h" // multiset_key_scan, multiset_scan
+
+/**
+	@brief MultiSet a memoria contigua templato su due parametri
+
+	@description
+	Variante di MultiSet in cui i valori distinti ed i rispettivi numeri di occorrenze sono
+	memorizzati in due array paralleli. La ricerca è una scansione lineare degli array,
+	tramite il funtore di uguaglianza, ma senza attraversare puntatori. Se T è un tipo
+	aritmetico ed E equivale ad operator== (std::equal_to<T>, o un funtore per cui è
+	specializzato multiset_plain_equal), la scansione confronta più valori con una sola
+	istruzione (vedi multiset_scan()).
+	Le somme prefisse dei numeri di occorrenze sono calcolate su richiesta e mantenute
+	finché i numeri di occorrenze non cambiano: permettono di accedere alla k-esima
+	occorrenza in O(log d), con d il numero di elementi distinti, e di spostare gli
+	iteratori (ad accesso casuale) di più posizioni con lo stesso costo.
+	La rimozione di un valore distinto sposta l'ultimo valore nella sua posizione: l'ordine
+	degli elementi è quello di inserimento finché non vengono cancellati valori.
+
+	@tparam T tipo degli elementi di un FlatMultiSet
+	@tparam E funtore di uguaglianza tra due elementi
+*/
+template <typename T, typename E>
+class FlatMultiSet {
+
+	// Sezione privata della classe
+
+	std::vector<T> _values; ///< Valori distinti
+	std::vector<std::size_t> _counts; ///< Numero di occorrenze di ciascun valore
+	mutable std::vector<std::size_t> _prefix; ///< _prefix[i] è la somma di _counts[0..i]
+	mutable std::size_t _valid; ///< Numero di somme prefisse valide, a partire dalla prima
+	std::size_t _size; ///< Numero totale di elementi
+
+	E _eql; ///< Istanza del funtore di uguaglianza
+
+	/**
+		@brief Posizione di un valore negli array, tramite il funtore di uguaglianza
+
+		@param v valore da cercare
+
+		@return indice del valore, distinct_size() se non presente
+	*/
+	std::size_t find(const T &v, std::false_type) const {
+		std::size_t i = 0;
+		while(i < _values.size() && !multiset_equal(_eql, _values[i], v))
+			++i;
+		return i;
+	}
+
+	/**
+		@brief Posizione di un valore aritmetico negli array, a blocchi di valori
+
+		@param v valore da cercare
+
+		@return indice del valore, distinct_size() se non presente
+	*/
+	std::size_t find(const T &v, std::true_type) const {
+		return multiset_scan(_values.data(), _values.size(), v);
+	}
+
+	/**
+		@brief Posizione di un valore negli array
+
+		@param v valore da cercare
+
+		@return indice del valore, distinct_size() se non presente
+	*/
+	std::size_t find(const T &v) const {
+		return find(v, std::integral_constant<bool, multiset_key_scan<T,E>::value>());
+	}
+
+	/**
+		@brief Invalidazione delle somme prefisse a partire da una posizione
+
+		@param i indice del primo numero di occorrenze modificato
+	*/
+	void invalidate(std::size_t i) {
+		if(i < _valid)
+			_valid = i;
+	}
+
+	/**
+		@brief Calcolo delle somme prefisse non più valide
+
+		@post Tutte le somme prefisse sono valide
+	*/
+	void update_prefix() const {
+		std::size_t d = _counts.size();
+		if(_valid == d)
+			return;
+		_prefix.resize(d);
+		std::size_t sum = (_valid == 0) ? 0 : _prefix[_valid - 1];
+		for(std::size_t i = _valid; i < d; ++i) {
+			sum += _counts[i];
+			_prefix[i] = sum;
+		}
+		_valid = d;
+	}
+
+	/**
+		@brief Posizione dell'elemento di indice k nella sequenza delle occorrenze
+
+		@param k indice dell'occorrenza, minore di size()
+		@param idx indice del valore distinto (output)
+		@param t occorrenza del valore, a partire da 0 (output)
+	*/
+	void locate(std::size_t k, std::size_t &idx, std::size_t &t) const {
+		update_prefix();
+		idx = std::upper_bound(_prefix.begin(), _prefix.end(), k) - _prefix.begin();
+		t = k - ((idx == 0) ? 0 : _prefix[idx - 1]);
+	}
+
+	/**
+		@brief Cancellazione del valore distinto in posizione i
+
+		@description
+		L'ultimo valore è spostato nella posizione liberata.
+
+		@param i indice del valore da cancellare
+	*/
+	void erase_at(std::size_t i) {
+		std::size_t last = _values.size() - 1;
+		if(i != last) {
+			std::swap(_values[i], _values[last]);
+			_counts[i] = _counts[last];
+		}
+		_values.pop_back();
+		_counts.pop_back();
+		invalidate(i);
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	typedef std::size_t size_type; ///< Tipo dei numeri di occorrenze e delle dimensioni
+
+	// Metodi fondamentali
+
+	/**
+		@brief Costruttore di default per FlatMultiSet
+	*/
+	FlatMultiSet() : _valid(0), _size(0) {}
+
+	/**
+		@brief Creazione di un FlatMultiSet a partire da un MultiSet
+
+		@description
+		Ogni valore distinto di ms è copiato una sola volta, insieme al suo numero di occorrenze,
+		nell'ordine di visita di ms.
+
+		@tparam H funtore di hash di ms
+		@tparam A allocatore di ms
+		@tparam N numero di nodi interni di ms
+
+		@param ms MultiSet da copiare
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	template <typename H, typename A, std::size_t N>
+	explicit FlatMultiSet(const MultiSet<T,E,H,A,N> &ms) : _valid(0), _size(ms.size()) {
+		_values.reserve(ms.distinct_size());
+		_counts.reserve(ms.distinct_size());
+		typename MultiSet<T,E,H,A,N>::distinct_range r = ms.distinct();
+		for(typename MultiSet<T,E,H,A,N>::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			_values.push_back(i.value());
+			_counts.push_back(i.count());
+		}
+	}
+
+	/**
+		@brief Creazione di un FlatMultiSet a partire da una sequenza identificata da due iteratori generici
+
+		@tparam IterT tipo dell'iteratore
+
+		@param begin iteratore di inizio sequenza
+		@param end iteratore di fine sequenza
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di T
+	*/
+	template <typename IterT>
+	FlatMultiSet(IterT begin, IterT end) : _valid(0), _size(0) {
+		for(; begin != end; ++begin)
+			add(static_cast<T>(*begin));
+	}
+
+	// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	/**
+		@brief Numero di elementi di un FlatMultiSet
+
+		@return numero totale di elementi
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di elementi distinti di un FlatMultiSet
+
+		@return numero di elementi distinti
+	*/
+	size_type distinct_size() const {
+		return _values.size();
+	}
+
+	/**
+		@brief Ricerca di un elemento nel FlatMultiSet
+
+		@param v valore da cercare
+
+		@return true se v è presente, false altrimenti
+	*/
+	bool contains(const T &v) const {
+		return find(v) < _values.size();
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento del FlatMultiSet
+
+		@param v valore da cercare
+
+		@return numero di occorrenze di v (0 se non presente)
+	*/
+	size_type nocc(const T &v) const {
+		std::size_t i = find(v);
+		return (i < _values.size()) ? _counts[i] : 0;
+	}
+
+	/**
+		@brief Valore distinto in una posizione degli array
+
+		@param i indice del valore, minore di distinct_size()
+
+		@return riferimento costante al valore
+	*/
+	const T& value_at(size_type i) const {
+		return _values[i];
+	}
+
+	/**
+		@brief Numero di occorrenze del valore distinto in una posizione degli array
+
+		@param i indice del valore, minore di distinct_size()
+
+		@return numero di occorrenze del valore
+	*/
+	size_type count_at(size_type i) const {
+		return _counts[i];
+	}
+
+	/**
+		@brief Array dei valori distinti
+
+		@return puntatore al primo di distinct_size() valori contigui
+	*/
+	const T* values() const {
+		return _values.data();
+	}
+
+	/**
+		@brief Array dei numeri di occorrenze, parallelo a values()
+
+		@return puntatore al primo di distinct_size() numeri di occorrenze contigui
+	*/
+	const size_type* counts() const {
+		return _counts.data();
+	}
+
+	/**
+		@brief Inserimento di un elemento nel FlatMultiSet
+
+		@param v valore da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v) {
+		add(v, 1);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento nel FlatMultiSet
+
+		@param v valore da inserire
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il FlatMultiSet resta invariato)
+	*/
+	void add(const T &v, size_type k) {
+		if(k == 0)
+			return;
+		if(k > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		std::size_t i = find(v);
+		if(i < _values.size()) {
+			_counts[i] += k;
+			invalidate(i);
+		}
+		else {
+			_values.push_back(v);
+			try {
+				_counts.push_back(k);
+			}
+			catch(...) {
+				_values.pop_back();
+				throw;
+			}
+		}
+		_size += k;
+	}
+
+	/**
+		@brief Rimozione di un elemento dal FlatMultiSet
+
+		@param v valore da rimuovere
+
+		@throw Eccezione custom per elemento non presente
+	*/
+	void remove(const T &v) {
+		remove(v, 1);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento dal FlatMultiSet
+
+		@description
+		Se il numero di occorrenze diventa 0, l'elemento viene cancellato e l'ultimo valore
+		distinto prende il suo posto.
+
+		@param v valore da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove(const T &v, size_type k) {
+		if(k == 0)
+			return;
+		std::size_t i = find(v);
+		if(i == _values.size() || _counts[i] < k)
+			throw multiset_value_not_found();
+		_counts[i] -= k;
+		_size -= k;
+		if(_counts[i] == 0)
+			erase_at(i);
+		else
+			invalidate(i);
+	}
+
+	/**
+		@brief Metodo di rimozione contenuto del FlatMultiSet
+
+		@post Il FlatMultiSet è vuoto
+	*/
+	void clear() {
+		_values.clear();
+		_counts.clear();
+		_prefix.clear();
+		_valid = 0;
+		_size = 0;
+	}
+
+	/**
+		@brief Elemento di indice k nella sequenza delle occorrenze
+
+		@description
+		La sequenza delle occorrenze è quella visitata dagli iteratori: il costo è O(log d)
+		tramite ricerca binaria sulle somme prefisse. Con k estratto uniformemente in [0, size())
+		ogni valore è restituito con probabilità proporzionale al suo numero di occorrenze.
+
+		@param k indice dell'occorrenza
+
+		@return riferimento costante al valore
+
+		@throw multiset_iterator_out_of_bounds se k non è minore di size()
+	*/
+	const T& nth(size_type k) const {
+		if(k >= _size)
+			throw multiset_iterator_out_of_bounds();
+		std::size_t idx, t;
+		locate(k, idx, t);
+		return _values[idx];
+	}
+
+	/**
+		@brief Numero di elementi che precedono il valore distinto in una posizione
+
+		@param i indice del valore, non maggiore di distinct_size()
+
+		@return somma dei numeri di occorrenze dei valori di indice minore di i
+	*/
+	size_type prefix_count(size_type i) const {
+		if(i == 0)
+			return 0;
+		update_prefix();
+		return _prefix[i - 1];
+	}
+
+	/**
+		@brief Operatore di uguaglianza tra due FlatMultiSet
+
+		@param other FlatMultiSet con cui confrontare quello corrente
+
+		@return true se i due FlatMultiSet contengono gli stessi elementi con lo stesso numero di occorrenze
+	*/
+	bool operator==(const FlatMultiSet &other) const {
+		if(_size != other._size || _values.size() != other._values.size())
+			return false;
+		for(std::size_t i = 0; i < _values.size(); ++i) {
+			if(_counts[i] == other._counts[i] && multiset_equal(_eql, _values[i], other._values[i]))
+				continue;
+			std::size_t j = other.find(_values[i]);
+			if(j == other._values.size() || other._counts[j] != _counts[i])
+				return false;
+		}
+		return true;
+	}
+
+	/**
+		@brief Iteratore in lettura (costante) ad accesso casuale per un FlatMultiSet
+
+		@description
+		Ogni valore è ripetuto tante volte quante sono le sue occorrenze. Incremento e
+		decremento costano O(1), anche da end() verso l'ultimo elemento; gli spostamenti
+		di più posizioni costano O(log d).
+	*/
+	class const_iterator {
+
+	public:
+
+		// Traits dell'iteratore costante
+
+		typedef std::random_access_iterator_tag iterator_category; ///< Categoria dell'iteratore
+		typedef const T value_type; ///< Tipo dei dati puntati dall'iteratore costante
+		typedef std::ptrdiff_t difference_type; ///< Tipo per rappresentare la differenza tra due iteratori
+		typedef const T* pointer; ///< Tipo di puntatore ai dati puntati dall'iteratore costante
+		typedef const T& reference; ///< Tipo di reference ai dati puntati dall'iteratore costante
+
+		/**
+			@brief Costruttore di default dell'iteratore costante
+		*/
+		const_iterator() : owner(nullptr), idx(0), t(0), pos(0) {}
+
+		/**
+			@brief Operatore di deferenziamento
+
+			@return valore costante puntato dall'iteratore costante
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è alla fine
+		*/
+		reference operator*() const {
+			check(pos < owner->_size);
+			return owner->_values[idx];
+		}
+
+		/**
+			@brief Operatore di accesso tramite puntatore
+
+			@return puntatore al valore costante puntato dall'iteratore costante
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è alla fine
+		*/
+		pointer operator->() const {
+			return &(**this);
+		}
+
+		/**
+			@brief Operatore di accesso con indice
+
+			@param n spostamento rispetto all'iteratore corrente
+
+			@return valore costante che si trova n posizioni dopo l'iteratore
+
+			@throw multiset_iterator_out_of_bounds se la posizione è esterna al FlatMultiSet
+		*/
+		reference operator[](difference_type n) const {
+			return *(*this + n);
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return Riferimento all'iteratore costante corrente
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è già alla fine
+		*/
+		const_iterator& operator++() {
+			check(pos < owner->_size);
+			++pos;
+			if(++t == owner->_counts[idx]) {
+				++idx;
+				t = 0;
+			}
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@param int placeholder che distingue questo operatore da quello di pre-incremento
+
+			@return Copia dell'iteratore costante corrente prima dell'incremento
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è già alla fine
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-decremento
+
+			@return Riferimento all'iteratore costante corrente
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è all'inizio
+		*/
+		const_iterator& operator--() {
+			check(pos > 0);
+			--pos;
+			if(t == 0) {
+				--idx;
+				t = owner->_counts[idx];
+			}
+			--t;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di iterazione post-decremento
+
+			@param int placeholder che distingue questo operatore da quello di pre-decremento
+
+			@return Copia dell'iteratore costante corrente prima del decremento
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è all'inizio
+		*/
+		const_iterator operator--(int) {
+			const_iterator tmp(*this);
+			--(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Spostamento dell'iteratore di n posizioni
+
+			@description
+			Se la nuova posizione è nello stesso valore distinto lo spostamento costa O(1),
+			altrimenti il valore è trovato tramite le somme prefisse.
+
+			@param n spostamento (negativo per tornare indietro)
+
+			@return Riferimento all'iteratore costante corrente
+
+			@throw multiset_iterator_out_of_bounds se la nuova posizione è esterna al FlatMultiSet
+		*/
+		const_iterator& operator+=(difference_type n) {
+			std::size_t p = pos + static_cast<std::size_t>(n);
+			check(n >= 0 ? (p >= pos && p <= owner->_size) : p < pos);
+			if(idx < owner->_counts.size() && (n >= 0 ? t + static_cast<std::size_t>(n) < owner->_counts[idx] :
+				static_cast<std::size_t>(-n) <= t))
+				t += static_cast<std::size_t>(n);
+			else if(p == owner->_size) {
+				idx = owner->_counts.size();
+				t = 0;
+			}
+			else
+				owner->locate(p, idx, t);
+			pos = p;
+			return *this;
+		}
+
+		/**
+			@brief Spostamento dell'iteratore di n posizioni all'indietro
+
+			@param n spostamento
+
+			@return Riferimento all'iteratore costante corrente
+
+			@throw multiset_iterator_out_of_bounds se la nuova posizione è esterna al FlatMultiSet
+		*/
+		const_iterator& operator-=(difference_type n) {
+			return *this += -n;
+		}
+
+		/**
+			@brief Iteratore spostato di n posizioni
+
+			@param n spostamento
+
+			@return nuovo iteratore costante
+
+			@throw multiset_iterator_out_of_bounds se la nuova posizione è esterna al FlatMultiSet
+		*/
+		const_iterator operator+(difference_type n) const {
+			const_iterator tmp(*this);
+			return tmp += n;
+		}
+
+		/**
+			@brief Iteratore spostato di n posizioni all'indietro
+
+			@param n spostamento
+
+			@return nuovo iteratore costante
+
+			@throw multiset_iterator_out_of_bounds se la nuova posizione è esterna al FlatMultiSet
+		*/
+		const_iterator operator-(difference_type n) const {
+			const_iterator tmp(*this);
+			return tmp -= n;
+		}
+
+		/**
+			@brief Iteratore spostato di n posizioni, con lo spostamento come primo operando
+
+			@param n spostamento
+			@param i iteratore di partenza
+
+			@return nuovo iteratore costante
+
+			@throw multiset_iterator_out_of_bounds se la nuova posizione è esterna al FlatMultiSet
+		*/
+		friend const_iterator operator+(difference_type n, const const_iterator &i) {
+			return i + n;
+		}
+
+		/**
+			@brief Distanza tra due iteratori
+
+			@param other iteratore dello stesso FlatMultiSet
+
+			@return numero di posizioni da other all'iteratore corrente
+		*/
+		difference_type operator-(const const_iterator &other) const {
+			return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se i due iteratori costanti sono nella stessa posizione, false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return pos == other.pos;
+		}
+
+		/**
+			@brief Operatore di disuguaglianza
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se i due iteratori costanti sono in posizioni diverse, false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return pos != other.pos;
+		}
+
+		/**
+			@brief Operatore minore
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se l'iteratore corrente precede other
+		*/
+		bool operator<(const const_iterator &other) const {
+			return pos < other.pos;
+		}
+
+		/**
+			@brief Operatore maggiore
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se l'iteratore corrente segue other
+		*/
+		bool operator>(const const_iterator &other) const {
+			return pos > other.pos;
+		}
+
+		/**
+			@brief Operatore minore o uguale
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se l'iteratore corrente non segue other
+		*/
+		bool operator<=(const const_iterator &other) const {
+			return pos <= other.pos;
+		}
+
+		/**
+			@brief Operatore maggiore o uguale
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se l'iteratore corrente non precede other
+		*/
+		bool operator>=(const const_iterator &other) const {
+			return pos >= other.pos;
+		}
+
+		/**
+			@brief Numero di occorrenze del valore puntato dall'iteratore
+
+			@return numero di occorrenze del valore
+		*/
+		size_type count() const {
+			return owner->_counts[idx];
+		}
+
+	private:
+
+		// Dati privati dell'iteratore costante
+
+		const FlatMultiSet *owner; ///< FlatMultiSet su cui si itera
+		std::size_t idx; ///< Indice del valore distinto corrente
+		std::size_t t; ///< Occorrenza corrente del valore, a partire da 0
+		std::size_t pos; ///< Posizione nella sequenza delle occorrenze
+
+		friend class FlatMultiSet; // La classe container che utilizza l'iteratore costante dev'essere friend della classe iteratore
+
+		/**
+			@brief Costruttore privato
+
+			@param ms FlatMultiSet su cui si itera
+			@param i indice del valore distinto
+			@param o occorrenza del valore
+			@param p posizione nella sequenza delle occorrenze
+		*/
+		const_iterator(const FlatMultiSet *ms, std::size_t i, std::size_t o, std::size_t p) : owner(ms), idx(i), t(o), pos(p) {}
+
+		/**
+			@brief Verifica dei limiti, disattivata da MULTISET_NO_ITERATOR_CHECKS
+
+			@param inside condizione che l'iteratore deve rispettare
+
+			@throw multiset_iterator_out_of_bounds se inside è false
+		*/
+		static void check(bool inside) {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
+			if(!inside)
+				throw multiset_iterator_out_of_bounds();
+#else
+			(void)inside;
+#endif
+		}
+
+	}; // class const_iterator
+
+	// Funzioni membro per l'utilizzo di iteratori costanti
+
+	/**
+		@brief Iteratore costante che punta al primo elemento
+
+		@return iteratore costante che punta all'inizio del FlatMultiSet
+	*/
+	const_iterator begin() const {
+		return const_iterator(this, 0, 0, 0);
+	}
+
+	/**
+		@brief Iteratore costante che punta alla fine del FlatMultiSet
+
+		@return iteratore costante che punta alla fine del FlatMultiSet
+	*/
+	const_iterator end() const {
+		return const_iterator(this, _values.size(), 0, _size);
+	}
+
+}; // class FlatMultiSet
+
+// Funzioni globali
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per un FlatMultiSet
+
+	@description
+	Il formato di invio su stream è lo stesso del MultiSet:
+	{<X1, OccorrenzeX1>, <X2, OccorrenzeX2>, ..., <Xn, OccorrenzeXn>}.
+
+	@tparam T tipo del valore degli elementi del FlatMultiSet da stampare
+	@tparam E funtore di uguaglianza tra elementi
+
+	@param os oggetto di stream output
+	@param ms FlatMultiSet da stampare
+
+	@return riferimento allo stream di output
+*/
+template <typename T, typename E>
+std::ostream &operator<<(std::ostream &os, const FlatMultiSet<T,E> &ms) {
+	os << "{";
+	for(typename FlatMultiSet<T,E>::size_type i = 0; i < ms.distinct_size(); ++i) {
+		if(i != 0)
+			os << ", ";
+		os << "<" << ms.value_at(i) << ", " << ms.count_at(i) << ">";
+	}
+	os << "}";
+
+	return os;
+}
+
+#endif
+
+// Fine flat_multiset.h
@@ -15,7 +15,31 @@
 #include <cassert> // assert
 #include <string> // uso di oggetti std::string e relative funzioni associate
 #include <ostream> // std::ostream
+#include <functional> // std::hash
+#include <cstdlib> // std::rand, std::srand
+#include <pthread.h> // pthread_create, pthread_attr_setstacksize
+#include <vector> // std::vector
+#include <sstream> // std::istringstream
+#include <iterator> // std::istream_iterator
+#include <algorithm> // std::sort
+#include <random> // std::mt19937
+#include <cstring> // std::strlen, std::strcmp
+#include <cstdio> // std::sprintf, std::remove
+#include <fstream> // std::ofstream
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::is_nothrow_move_constructible
 #include "multiset.h" // Classe MultiSet, iteratori e funzioni globali associate
+#include "ordered_multiset.h" // Classe OrderedMultiSet
+#include "flat_multiset.h" // Classe FlatMultiSet
+#include "multiset_sampler.h" // Campionatore pesato multiset_sampler
+#include "approx_multiset.h" // Classe ApproxMultiSet
+#include "concurrent_multiset.h" // Classe ConcurrentMultiSet
+#include "multiset_parallel.h" // Costruzione parallela di un MultiSet
+#include "snapshot_multiset.h" // Classe SnapshotMultiSet
+#include "multiset_simd.h" // Ricerca vettoriale multiset_scan
+#include "multiset_equal.h" // Trait multiset_plain_equal, multiset_bytewise_equal
+#include "string_multiset.h" // Classe StringMultiSet
+#include "multiset_binary.h" // Formato binario, classe MappedMultiSet
 
 /**
 	@brief Struttura che definisce l'uguaglianza tra due interi, tramite funtore
@@ -226,6 +250,224 @@ struct equal_multiset {
 	}
 };
 
+/**
+	@brief Struttura che conta le proprie copie e i propri spostamenti
+
+	@description
+	Usata per verificare che inserimenti tramite spostamento e costruzione sul posto
+	non effettuino copie del valore.
+*/
+struct counted {
+	std::string s; ///< Valore della struttura
+	static int copies; ///< Numero di copie effettuate
+	static int moves; ///< Numero di spostamenti effettuati
+
+	/**
+		@brief Costruttore secondario
+
+		@param a lunghezza della stringa
+		@param c carattere ripetuto nella stringa
+	*/
+	counted(std::size_t a, char c) : s(a, c) {}
+
+	/**
+		@brief Copy constructor, che incrementa il contatore delle copie
+
+		@param other struttura da copiare
+	*/
+	counted(const counted &other) : s(other.s) {
+		copies++;
+	}
+
+	/**
+		@brief Costruttore di spostamento, che incrementa il contatore degli spostamenti
+
+		@param other struttura da spostare
+	*/
+	counted(counted &&other) : s(std::move(other.s)) {
+		moves++;
+	}
+};
+
+int counted::copies = 0;
+int counted::moves = 0;
+
+/**
+	@brief Funtore di hash degli int che conta le proprie chiamate
+
+	@description
+	Usato per verificare quante volte un'operazione calcola l'hash del valore.
+*/
+struct counting_hash_int {
+	static std::size_t calls; ///< Numero di hash calcolati
+
+	std::size_t operator()(int i) const {
+		calls++;
+		return std::hash<int>()(i);
+	}
+};
+
+std::size_t counting_hash_int::calls = 0;
+
+/**
+	@brief Struttura che definisce l'uguaglianza tra due counted, tramite funtore
+
+	@param c1 primo counted
+	@param c2 secondo counted
+
+	@return True se c1 e c2 hanno la stessa stringa, false altrimenti
+*/
+struct equal_counted {
+	bool operator()(const counted &c1, const counted &c2) const {
+		return (c1.s == c2.s);
+	}
+};
+
+/**
+	@brief Struttura che identifica una persona senza possederne le stringhe
+
+	@description
+	Usata come chiave di ricerca in un MultiSet di person: non è convertibile in person.
+*/
+struct person_key {
+	const char *name; ///< Nome della persona
+	const char *surname; ///< Cognome della persona
+	unsigned int age; ///< Età della persona
+
+	/**
+		@brief Costruttore secondario di person_key
+
+		@param n nome della persona
+		@param s cognome della persona
+		@param a età della persona
+	*/
+	person_key(const char *n, const char *s, unsigned int a) : name(n), surname(s), age(a) {}
+};
+
+/**
+	@brief Funtore trasparente di uguaglianza tra std::string, anche con stringhe C
+
+	@description
+	Dichiarando is_transparent, permette di cercare un const char* in un MultiSet di
+	std::string senza costruire una std::string temporanea.
+*/
+struct equal_string_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi di tipo diverso da std::string
+
+	bool operator()(const std::string &s1, const std::string &s2) const {
+		return (s1.compare(s2) == 0);
+	}
+
+	bool operator()(const std::string &s1, const char *s2) const {
+		return (s1.compare(s2) == 0);
+	}
+};
+
+/**
+	@brief Funtore trasparente di hash (FNV-1a) per std::string e stringhe C
+
+	@description
+	std::string e const char* con gli stessi caratteri hanno lo stesso hash.
+*/
+struct hash_string_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi di tipo diverso da std::string
+
+	std::size_t operator()(const char *s, std::size_t n) const {
+		std::size_t h = 14695981039346656037ULL;
+		for(std::size_t i = 0; i < n; ++i)
+			h = (h ^ static_cast<unsigned char>(s[i])) * 1099511628211ULL;
+		return h;
+	}
+
+	std::size_t operator()(const std::string &s) const {
+		return (*this)(s.data(), s.size());
+	}
+
+	std::size_t operator()(const char *s) const {
+		return (*this)(s, std::strlen(s));
+	}
+};
+
+/**
+	@brief Funtore trasparente di uguaglianza tra persone, anche con chiavi person_key
+
+	@description
+	Due persone sono uguali se i nomi, i cognomi e le età coincidono.
+*/
+struct equal_person_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi person_key
+
+	bool operator()(const person &p1, const person &p2) const {
+		return equal_person()(p1, p2);
+	}
+
+	bool operator()(const person &p, const person_key &k) const {
+		return (p.age == k.age) && (p.name.compare(k.name) == 0) && (p.surname.compare(k.surname) == 0);
+	}
+};
+
+/**
+	@brief Funtore trasparente di uguaglianza tra punti, anche con coppie (ascissa, ordinata)
+
+	@description
+	Confronta tutti i campi di point, quindi equivale al confronto byte per byte.
+*/
+struct equal_point_key {
+	typedef void is_transparent; ///< Il funtore accetta chiavi std::pair<int, int>
+
+	bool operator()(const point &p1, const point &p2) const {
+		return equal_point()(p1, p2);
+	}
+
+	bool operator()(const point &p, const std::pair<int, int> &k) const {
+		return (p.x == k.first) && (p.y == k.second);
+	}
+};
+
+// Trait di uguaglianza dei funtori definiti sopra (equal_person e equal_counted restano generici)
+
+template <> struct multiset_plain_equal<int, equal_int> : std::true_type {}; ///< equal_int equivale ad operator==
+template <> struct multiset_plain_equal<double, equal_double> : std::true_type {}; ///< equal_double equivale ad operator==
+template <> struct multiset_plain_equal<std::string, equal_string> : std::true_type {}; ///< compare() == 0 equivale ad operator==
+template <> struct multiset_bytewise_equal<point, equal_point> : std::true_type {}; ///< point non ha byte di riempimento
+template <> struct multiset_bytewise_equal<point, equal_point_key> : std::true_type {}; ///< Come equal_point
+
+/**
+	@brief Codec binario di un punto: ascissa ed ordinata come interi con segno (zigzag varint)
+*/
+template <>
+struct multiset_codec<point> {
+	static void write(multiset_writer &w, const point &p) {
+		multiset_codec<int>::write(w, p.x);
+		multiset_codec<int>::write(w, p.y);
+	}
+
+	static point read(multiset_reader &r) {
+		int x = multiset_codec<int>::read(r);
+		int y = multiset_codec<int>::read(r);
+		return point(x, y);
+	}
+};
+
+/**
+	@brief Codec binario di una persona: nome, cognome (lunghezza e caratteri) ed età (varint)
+*/
+template <>
+struct multiset_codec<person> {
+	static void write(multiset_writer &w, const person &p) {
+		multiset_codec<std::string>::write(w, p.name);
+		multiset_codec<std::string>::write(w, p.surname);
+		multiset_codec<unsigned int>::write(w, p.age);
+	}
+
+	static person read(multiset_reader &r) {
+		std::string name = multiset_codec<std::string>::read(r);
+		std::string surname = multiset_codec<std::string>::read(r);
+		unsigned int age = multiset_codec<unsigned int>::read(r);
+		return person(name, surname, age);
+	}
+};
+
 // Typedef per testare la classe MultiSet
 
 typedef MultiSet<int, equal_int> msint; // MultiSet di int
@@ -234,6 +476,23 @@ typedef MultiSet<std::string, equal_string> msstr; // MultiSet di std::string
 typedef MultiSet<point, equal_point> mspoint; // MultiSet di point
 typedef MultiSet<person, equal_person> msperson; // MultiSet di person
 typedef MultiSet<MultiSet<point, equal_point>, equal_multiset<point, equal_point>> ms_mspoint; // MultiSet di MultiSet di point
+typedef MultiSet<int, equal_int, std::hash<int>> mshint; // MultiSet di int con hash
+typedef MultiSet<std::string, equal_string, std::hash<std::string>> mshstr; // MultiSet di std::string con hash
+typedef MultiSet<int, equal_int, std::hash<int>, multiset_pool_allocator<int>> mspint; // MultiSet di int con hash e allocatore a blocchi
+typedef MultiSet<counted, equal_counted> mscounted; // MultiSet di counted
+typedef MultiSet<std::string, equal_string_key> mskstr; // MultiSet di std::string con ricerca per const char*
+typedef MultiSet<std::string, equal_string_key, hash_string_key> mshkstr; // MultiSet di std::string con hash e ricerca per const char*
+typedef MultiSet<person, equal_person_key> mskperson; // MultiSet di person con ricerca per person_key
+typedef MultiSet<point, equal_point_key> mskpoint; // MultiSet di point con ricerca per coppia (ascissa, ordinata)
+typedef OrderedMultiSet<int> omsint; // OrderedMultiSet di int
+typedef OrderedMultiSet<std::string> omsstr; // OrderedMultiSet di std::string
+typedef FlatMultiSet<int, equal_int> fmsint; // FlatMultiSet di int
+typedef MultiSet<mshint, std::equal_to<mshint>, multiset_hash> ms_mshint; // MultiSet di MultiSet di int con hash
+typedef ConcurrentMultiSet<int, equal_int> cmsint; // ConcurrentMultiSet di int
+typedef SnapshotMultiSet<int, equal_int> smsint; // SnapshotMultiSet di int
+typedef MultiSet<point, equal_point, multiset_no_hash, std::allocator<point>, 8> msspoint; // MultiSet di point con 8 nodi interni
+typedef MultiSet<msspoint, std::equal_to<msspoint>> ms_msspoint; // MultiSet di MultiSet di point con nodi interni
+typedef MultiSet<std::string, equal_string, std::hash<std::string>, multiset_pool_allocator<std::string>, 4> msspstr; // MultiSet di std::string con hash, allocatore a blocchi e 4 nodi interni
 
 /**
 	@brief Test della classe MultiSet su tipi int
@@ -1704,6 +1963,2232 @@ void test_multiset_multiset_point() {
 	std::cout << std::endl;
 }
 
+/**
+	@brief Test della classe MultiSet con funtore di hash
+
+	@description
+	Questa funzione globale si occupa di effettuare alcuni test delle funzionalità della
+	classe MultiSet quando è specificato un funtore di hash (MultiSet di interi e di stringhe),
+	anche su un numero di elementi distinti tale da richiedere più ridimensionamenti dei bucket.
+*/
+void test_multiset_hash() {
+	std::cout << "!!!### TEST DELLA CLASSE MULTISET CON FUNTORE DI HASH ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	mshstr ms1; // Test costruttore di default
+
+	std::cout << "Inserisco delle stringhe nel MultiSet ms1: ciao mondo ciao hash ciao" << std::endl;
+	ms1.add("ciao");
+	ms1.add("mondo");
+	ms1.add("ciao");
+	ms1.add("hash");
+	ms1.add("ciao");
+	std::cout << ms1 << std::endl;
+	std::cout << std::endl;
+
+	assert(ms1.size() == 5);
+	assert(ms1.nocc("ciao") == 3);
+	assert(ms1.nocc("mondo") == 1);
+	assert(ms1.contains("hash") == true);
+	assert(ms1.contains("bucket") == false);
+
+	ms1.remove("mondo");
+	assert(ms1.contains("mondo") == false);
+	assert(ms1.size() == 4);
+
+	try {
+		ms1.remove("mondo"); // Test remove
+	}
+	catch(multiset_value_not_found &e) { // Test eccezione custom
+		std::cout << "Eccezione verificata: impossibile cancellare un valore non esistente!" << std::endl;
+		std::cout << std::endl;
+	}
+	assert(ms1.size() == 4);
+
+	const int n = 100000; // Elementi distinti inseriti in ms2
+
+	std::cout << "Inserisco in ms2 gli interi da 0 a " << n - 1 << ", i pari due volte" << std::endl;
+	std::cout << std::endl;
+
+	mshint ms2;
+	for(int i = 0; i < n; ++i) {
+		ms2.add(i);
+		if(i % 2 == 0)
+			ms2.add(i);
+	}
+	assert(ms2.size() == static_cast<unsigned int>(n + n / 2));
+	assert(ms2.nocc(0) == 2);
+	assert(ms2.nocc(n - 1) == 1);
+	assert(ms2.nocc(n) == 0);
+
+	unsigned int count = 0; // Numero di elementi visitati dall'iteratore costante
+	for(mshint::const_iterator i = ms2.begin(), ie = ms2.end(); i != ie; ++i)
+		count++;
+	assert(count == ms2.size());
+
+	mshint ms3(ms2); // Copy constructor
+	assert(ms3 == ms2); // Test operator==
+
+	std::cout << "Rimuovo da ms2 tutte le occorrenze degli interi dispari" << std::endl;
+	std::cout << std::endl;
+
+	for(int i = 1; i < n; i += 2)
+		ms2.remove(i);
+	assert(ms2.size() == static_cast<unsigned int>(n));
+	assert(ms2.contains(1) == false);
+	assert(ms2.nocc(2) == 2);
+	assert((ms3 == ms2) == false);
+
+	int a[6] = {3, 1, 3, 3, 2, 1};
+	mshint msiter(a, a + 6); // Test creazione MultiSet da una seq. generica identificata da due iteratori generici
+	assert(msiter.size() == 6);
+	assert(msiter.nocc(3) == 3);
+	std::cout << "Stampa di msiter, creato da una seq. generica identificata da una coppia di iteratori" << std::endl;
+	std::cout << msiter << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "!!!### FINE TEST DELLA CLASSE MULTISET CON FUNTORE DI HASH ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della classe OrderedMultiSet
+
+	@description
+	Questa funzione globale si occupa di effettuare alcuni test delle funzionalità della
+	classe OrderedMultiSet: inserimenti e rimozioni casuali sono confrontati con un array
+	di conteggi, così da verificare anche divisioni, rotazioni ed unioni dei nodi del B-tree.
+*/
+void test_ordered_multiset() {
+	std::cout << "!!!### TEST DELLA CLASSE ORDEREDMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	omsstr ms1; // Test costruttore di default
+
+	std::cout << "Inserisco delle stringhe nell'OrderedMultiSet ms1: pera mela pera kiwi banana mela pera" << std::endl;
+	ms1.add("pera");
+	ms1.add("mela");
+	ms1.add("pera");
+	ms1.add("kiwi");
+	ms1.add("banana");
+	ms1.add("mela");
+	ms1.add("pera");
+	std::cout << ms1 << std::endl; // Test operator<<, elementi in ordine crescente
+	std::cout << std::endl;
+
+	assert(ms1.size() == 7);
+	assert(ms1.distinct_size() == 4);
+	assert(ms1.nocc("pera") == 3);
+	assert(*ms1.begin() == "banana");
+	assert(*ms1.lower_bound("l") == "mela");
+	assert(*ms1.upper_bound("mela") == "pera");
+	assert(ms1.upper_bound("pera") == ms1.end());
+	assert(ms1.count_range("kiwi", "mela") == 3);
+	assert(ms1.count_range("mela", "kiwi") == 0);
+
+	try {
+		ms1.remove("uva"); // Test remove
+	}
+	catch(multiset_value_not_found &e) { // Test eccezione custom
+		std::cout << "Eccezione verificata: impossibile cancellare un valore non esistente!" << std::endl;
+		std::cout << std::endl;
+	}
+
+	const int range = 5000; // I valori inseriti sono compresi tra 0 e range - 1
+	const int ops = 200000; // Numero di operazioni casuali
+
+	std::cout << "Eseguo " << ops << " inserimenti e rimozioni casuali su valori tra 0 e " << range - 1 << std::endl;
+	std::cout << std::endl;
+
+	std::srand(42);
+	unsigned int *expected = new unsigned int[range](); // Occorrenze attese di ciascun valore
+	unsigned int total = 0;
+	omsint ms2;
+
+	for(int k = 0; k < ops; ++k) {
+		int v = std::rand() % range;
+		if(std::rand() % 3 != 0 || expected[v] == 0) {
+			ms2.add(v);
+			expected[v]++;
+			total++;
+		}
+		else {
+			ms2.remove(v);
+			expected[v]--;
+			total--;
+		}
+	}
+	assert(ms2.size() == total);
+
+	unsigned int distinct = 0, below = 0;
+	for(int v = 0; v < range; ++v) {
+		assert(ms2.nocc(v) == expected[v]);
+		assert(ms2.rank(v) == below);
+		below += expected[v];
+		if(expected[v] > 0)
+			distinct++;
+	}
+	assert(ms2.distinct_size() == distinct);
+	assert(ms2.count_range(100, 199) == ms2.rank(200) - ms2.rank(100));
+
+	unsigned int count = 0; // Numero di elementi visitati dall'iteratore costante
+	int prev = -1;
+	for(omsint::const_iterator i = ms2.begin(), ie = ms2.end(); i != ie; ++i) {
+		assert(prev <= *i); // Iterazione in ordine crescente
+		prev = *i;
+		count++;
+	}
+	assert(count == total);
+
+	omsint ms3(ms2); // Copy constructor
+	assert(ms3 == ms2); // Test operator==
+
+	std::cout << "Svuoto ms2 rimuovendo tutti gli elementi" << std::endl;
+	std::cout << std::endl;
+
+	for(int v = 0; v < range; ++v)
+		for(; expected[v] > 0; --expected[v])
+			ms2.remove(v);
+	assert(ms2.size() == 0);
+	assert(ms2.begin() == ms2.end());
+	assert((ms3 == ms2) == false);
+	delete[] expected;
+
+	std::cout << "Svuoto un OrderedMultiSet rimuovendo valori tramite riferimenti ai suoi elementi" << std::endl;
+	std::cout << std::endl;
+
+	omsstr deep; // Abbastanza profondo da richiedere unioni e rotazioni dei nodi
+	std::srand(31);
+	for(int k = 0; k < 3000; ++k)
+		deep.add(std::to_string(std::rand() % 100000) + std::string(20, 'x'));
+	std::size_t left = deep.size();
+	for(int step = 0; left > 0; ++step) {
+		omsstr::const_iterator it = (step % 3 == 0) ? deep.begin() : deep.lower_bound(std::to_string(step % 100000));
+		if(it == deep.end())
+			it = deep.begin();
+		std::size_t k = deep.nocc(*it);
+		if(step % 3 == 2)
+			deep.set_count(*it, 0);
+		else
+			deep.remove(*it, k);
+		left -= k;
+		assert(deep.size() == left);
+	}
+	assert(deep.begin() == deep.end());
+
+	int a[7] = {9, 3, 7, 3, 1, 9, 9};
+	omsint msiter(a, a + 7); // Test creazione OrderedMultiSet da una seq. generica identificata da due iteratori generici
+	std::cout << "Stampa di msiter, creato da una seq. generica identificata da una coppia di iteratori" << std::endl;
+	std::cout << msiter << std::endl;
+	std::cout << std::endl;
+
+	omsint::const_iterator i = msiter.end();
+	try {
+		++i;
+	}
+	catch(multiset_iterator_out_of_bounds &e) { // Test eccezione custom
+		std::cout << "Eccezione verificata: incremento iteratore fuori dai limiti" << std::endl;
+		std::cout << std::endl;
+	}
+
+	std::cout << "!!!### FINE TEST DELLA CLASSE ORDEREDMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Dati condivisi con il thread di test della distruzione di un MultiSet
+*/
+struct clear_task {
+	msint *to_delete; ///< MultiSet da distruggere
+	msint *to_assign; ///< MultiSet a cui assegnare un MultiSet vuoto
+};
+
+/**
+	@brief Corpo del thread di test della distruzione di un MultiSet
+
+	@description
+	Distrugge un MultiSet e ne svuota un altro tramite operatore di assegnamento.
+	Il thread è creato con uno stack ridotto: una distruzione ricorsiva dei nodi
+	lo esaurirebbe.
+
+	@param arg puntatore ad un oggetto clear_task
+
+	@return nullptr
+*/
+void* clear_task_run(void *arg) {
+	clear_task *task = static_cast<clear_task*>(arg);
+	delete task->to_delete;
+	*(task->to_assign) = msint();
+	return nullptr;
+}
+
+/**
+	@brief Test della distruzione di MultiSet con molti elementi distinti
+
+	@description
+	Questa funzione globale si occupa di verificare che distruttore ed operatore di
+	assegnamento di un MultiSet con molti elementi distinti (una lista lunga) possano
+	essere eseguiti su un thread con uno stack di 256 KiB.
+*/
+void test_multiset_clear() {
+	std::cout << "!!!### TEST DELLA DISTRUZIONE DI MULTISET CON MOLTI ELEMENTI ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	const int n = 1000000; // Elementi distinti di ciascun MultiSet
+
+	std::vector<int> values(n);
+	for(int i = 0; i < n; ++i)
+		values[i] = i;
+	msint *ms1 = new msint(multiset_sorted_input, values.begin(), values.end()); // Una sola lista, in tempo lineare
+	msint ms2(multiset_sorted_input, values.begin(), values.end());
+	assert(ms1->size() == static_cast<unsigned int>(n) && ms2.distinct_size() == static_cast<unsigned int>(n));
+
+	std::cout << "Distruggo e riassegno due MultiSet di " << n << " elementi distinti su un thread con stack di 256 KiB" << std::endl;
+	std::cout << std::endl;
+
+	clear_task task = {ms1, &ms2};
+	pthread_attr_t attr;
+	pthread_t thread;
+	pthread_attr_init(&attr);
+	pthread_attr_setstacksize(&attr, 256 * 1024);
+	int err = pthread_create(&thread, &attr, clear_task_run, &task);
+	assert(err == 0);
+	pthread_join(thread, nullptr);
+	pthread_attr_destroy(&attr);
+
+	assert(ms2.size() == 0);
+	assert(ms2.begin() == ms2.end());
+
+	std::cout << "!!!### FINE TEST DELLA DISTRUZIONE DI MULTISET CON MOLTI ELEMENTI ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della classe MultiSet con allocatore a blocchi
+
+	@description
+	Questa funzione globale si occupa di verificare, tramite le statistiche dell'allocatore,
+	che i nodi di un MultiSet siano allocati a blocchi, che i nodi rimossi siano riutilizzati
+	e che clear() restituisca tutta la memoria in un'unica operazione.
+*/
+void test_multiset_pool() {
+	std::cout << "!!!### TEST DELLA CLASSE MULTISET CON ALLOCATORE A BLOCCHI ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	const int n = 1000; // Elementi distinti inseriti
+
+	mspint ms;
+	for(int i = 0; i < n; ++i)
+		ms.add(i);
+	for(int i = 0; i < n; i += 10)
+		ms.add(i);
+	assert(ms.size() == static_cast<unsigned int>(n + n / 10));
+
+	multiset_pool_stats st = ms.get_allocator().stats();
+	std::cout << "Inseriti " << n << " elementi distinti: " << st.slots_in_use << " celle in uso, ";
+	std::cout << st.system_allocations << " allocazioni di sistema, " << st.bytes_reserved << " byte riservati" << std::endl;
+	std::cout << std::endl;
+	assert(st.slots_in_use == static_cast<std::size_t>(n));
+	assert(st.system_allocations < static_cast<std::size_t>(n / 10));
+	assert(st.bytes_in_use <= st.bytes_reserved);
+
+	std::cout << "Rimuovo e reinserisco " << n / 10 << " elementi distinti: nessuna nuova allocazione di sistema" << std::endl;
+	std::cout << std::endl;
+	for(int i = 0; i < n / 10; ++i) {
+		while(ms.contains(i))
+			ms.remove(i);
+	}
+	assert(ms.get_allocator().stats().slots_in_use == static_cast<std::size_t>(n - n / 10));
+	for(int i = n; i < n + n / 10; ++i)
+		ms.add(i);
+	multiset_pool_stats st2 = ms.get_allocator().stats();
+	assert(st2.slots_in_use == static_cast<std::size_t>(n));
+	assert(st2.system_allocations == st.system_allocations);
+	assert(st2.bytes_reserved == st.bytes_reserved);
+
+	std::cout << "Copia di un MultiSet: la copia usa un pool nuovo" << std::endl;
+	std::cout << std::endl;
+	mspint copy(ms);
+	assert(copy == ms);
+	assert(copy.get_allocator() != ms.get_allocator());
+	assert(copy.get_allocator().stats().slots_in_use == static_cast<std::size_t>(n));
+	assert(ms.get_allocator().stats().slots_in_use == static_cast<std::size_t>(n));
+
+	std::cout << "Assegnamento di copia: il MultiSet assegnato mantiene il proprio pool" << std::endl;
+	std::cout << std::endl;
+	assert(!std::allocator_traits<multiset_pool_allocator<int>>::propagate_on_container_copy_assignment::value);
+	mspint assigned;
+	assigned.add(-1);
+	multiset_pool_allocator<int> own = assigned.get_allocator();
+	assigned = ms;
+	assert(assigned == ms && assigned.get_allocator() == own && assigned.get_allocator() != ms.get_allocator());
+	assert(own.stats().slots_in_use == static_cast<std::size_t>(n));
+	assert(ms.get_allocator().stats().slots_in_use == static_cast<std::size_t>(n));
+
+	std::cout << "Svuotamento: tutta la memoria è restituita in un'unica operazione" << std::endl;
+	std::cout << std::endl;
+	std::size_t deallocations = ms.get_allocator().stats().deallocations;
+	unsigned int size = ms.size();
+	ms.clear();
+	multiset_pool_stats st3 = ms.get_allocator().stats();
+	assert(st3.slots_in_use == 0);
+	assert(st3.bytes_in_use == 0);
+	assert(st3.bytes_reserved == 0);
+	assert(st3.deallocations == deallocations + 1); // Solo l'array dei bucket
+	ms.add(5);
+	assert(ms.contains(5) && ms.size() == 1);
+	assert(!copy.contains(5) && copy.contains(500) && copy.size() == size);
+
+	std::cout << "Richieste di array prima dei nodi: le celle restano della dimensione di un nodo" << std::endl;
+	std::cout << std::endl;
+	multiset_pool_allocator<int> pa;
+	int *arr = pa.allocate(4); // Array: fuori pool, non fissa la dimensione delle celle
+	mspint shared(pa);
+	for(int i = 0; i < n; ++i)
+		shared.add(i);
+	assert(pa.stats().slots_in_use == static_cast<std::size_t>(n));
+	assert(pa.stats().system_allocations < static_cast<std::size_t>(n / 10));
+	pa.deallocate(arr, 4);
+	assert(pa.stats().slots_in_use == static_cast<std::size_t>(n));
+	mspint reserved;
+	reserved.reserve(n); // L'array dei bucket è la prima allocazione
+	for(int i = 0; i < n; ++i)
+		reserved.add(i);
+	assert(reserved.get_allocator().stats().slots_in_use == static_cast<std::size_t>(n));
+	assert(reserved.get_allocator().stats().system_allocations < static_cast<std::size_t>(n / 10));
+
+	std::cout << "Due MultiSet che condividono il pool: lo svuotamento di uno non invalida l'altro" << std::endl;
+	std::cout << std::endl;
+	multiset_pool_allocator<int> alloc;
+	mspint ms1(alloc), ms2(alloc);
+	for(int i = 0; i < 100; ++i) {
+		ms1.add(i);
+		ms2.add(-i);
+	}
+	assert(alloc.stats().slots_in_use == 200);
+	ms1.clear();
+	assert(alloc.stats().slots_in_use == 100);
+	assert(ms2.size() == 100 && ms2.contains(-99));
+
+	std::cout << "!!!### FINE TEST DELLA CLASSE MULTISET CON ALLOCATORE A BLOCCHI ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dello spostamento e della costruzione sul posto di MultiSet
+
+	@description
+	Questa funzione globale si occupa di verificare che costruttore ed operatore di
+	assegnamento di spostamento, add() di un temporaneo, emplace() e swap() non
+	copino gli elementi.
+*/
+void test_multiset_move() {
+	std::cout << "!!!### TEST DELLO SPOSTAMENTO DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Inserimento di un temporaneo e costruzione sul posto: nessuna copia" << std::endl;
+	std::cout << std::endl;
+	mscounted mc;
+	counted::copies = 0;
+	counted::moves = 0;
+	mc.add(counted(3, 'a'));
+	assert(counted::copies == 0 && counted::moves == 1);
+	mc.emplace(3, 'b');
+	mc.emplace(3, 'b');
+	assert(counted::copies == 0 && counted::moves == 1);
+	counted c(3, 'a');
+	mc.add(std::move(c));
+	assert(c.s == "aaa"); // Valore già presente: c non viene spostato
+	assert(counted::copies == 0 && counted::moves == 1);
+	assert(mc.size() == 4 && mc.nocc(counted(3, 'a')) == 2 && mc.nocc(counted(3, 'b')) == 2);
+
+	std::cout << "Costruttore e assegnamento di spostamento: nessuna copia" << std::endl;
+	std::cout << std::endl;
+	mscounted mc2(std::move(mc));
+	assert(counted::copies == 0);
+	assert(mc.size() == 0 && mc.begin() == mc.end());
+	assert(mc2.size() == 4);
+	mc.emplace(1, 'z');
+	mc = std::move(mc2);
+	assert(counted::copies == 0);
+	assert(mc.size() == 4 && mc2.size() == 0 && !mc.contains(counted(1, 'z')));
+
+	std::cout << "Scambio di due MultiSet con funtore di hash" << std::endl;
+	std::cout << std::endl;
+	mshstr hs1, hs2;
+	for(int i = 0; i < 100; ++i)
+		hs1.emplace(static_cast<std::size_t>(i + 1), 'x');
+	hs2.add("y");
+	swap(hs1, hs2);
+	assert(hs1.size() == 1 && hs1.contains("y"));
+	assert(hs2.size() == 100 && hs2.contains(std::string(100, 'x')));
+	mshstr hs3;
+	hs3 = std::move(hs2);
+	assert(hs3.size() == 100 && hs2.size() == 0);
+	hs2.add("z");
+	assert(hs2.contains("z") && !hs3.contains("z"));
+
+	std::cout << "MultiSet di MultiSet di point costruito per spostamento" << std::endl;
+	std::cout << std::endl;
+	ms_mspoint nested;
+	for(int i = 0; i < 3; ++i) {
+		mspoint inner;
+		inner.add(point(i, i));
+		inner.add(point(0, 0));
+		nested.add(std::move(inner));
+		assert(inner.size() == 0);
+	}
+	assert(nested.size() == 3);
+	std::cout << nested << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "!!!### FINE TEST DELLO SPOSTAMENTO DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test del caricamento di sequenze in un MultiSet
+
+	@description
+	Questa funzione globale si occupa di verificare che i costruttori da sequenza (anche
+	ordinata) e add(first, last) producano gli stessi MultiSet ottenuti inserendo gli
+	elementi uno alla volta, sia con iteratori forward sia con iteratori di input.
+*/
+void test_multiset_bulk() {
+	std::cout << "!!!### TEST DEL CARICAMENTO DI SEQUENZE IN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::vector<int> v;
+	for(int i = 0; i < 2000; ++i)
+		v.push_back((i * 7919) % 53);
+	msint expected;
+	for(std::size_t i = 0; i < v.size(); ++i)
+		expected.add(v[i]);
+
+	std::cout << "Costruzione da sequenza non ordinata" << std::endl;
+	std::cout << std::endl;
+	msint ms1(v.begin(), v.end());
+	assert(ms1 == expected);
+	assert(ms1.size() == 2000 && ms1.nocc(0) == expected.nocc(0));
+
+	std::cout << "Costruzione da sequenza ordinata" << std::endl;
+	std::cout << std::endl;
+	std::vector<int> sorted;
+	for(int i = 0; i < 53; ++i)
+		for(unsigned int j = 0; j < expected.nocc(i); ++j)
+			sorted.push_back(i);
+	msint ms2(multiset_sorted_input, sorted.begin(), sorted.end());
+	assert(ms2 == expected);
+	msint::const_iterator it = ms2.begin();
+	for(std::size_t i = 0; i < sorted.size(); ++i, ++it)
+		assert(*it == sorted[i]); // Ordine di iterazione uguale a quello della sequenza
+	mshint hs(multiset_sorted_input, sorted.begin(), sorted.end());
+	assert(hs.size() == 2000 && hs.nocc(52) == expected.nocc(52));
+
+	std::cout << "Inserimento di una sequenza ordinata in un MultiSet non vuoto" << std::endl;
+	std::cout << std::endl;
+	ms2.add(multiset_sorted_input, sorted.begin(), sorted.end());
+	ms1.add(v.begin(), v.end());
+	assert(ms2 == ms1);
+	assert(ms2.size() == 4000 && ms2.nocc(7) == 2 * expected.nocc(7));
+
+	std::cout << "Costruzione da iteratori di input e da elementi di tipo diverso" << std::endl;
+	std::cout << std::endl;
+	std::istringstream in("3 1 3 3 2 1");
+	msint ms3((std::istream_iterator<int>(in)), std::istream_iterator<int>());
+	assert(ms3.size() == 6 && ms3.nocc(3) == 3 && ms3.nocc(1) == 2 && ms3.nocc(2) == 1);
+	std::vector<double> d(3, 2.5);
+	msint ms4(d.begin(), d.end());
+	assert(ms4.size() == 3 && ms4.nocc(2) == 3);
+
+	std::cout << "Preallocazione dei bucket" << std::endl;
+	std::cout << std::endl;
+	mshint hs2;
+	hs2.reserve(1000);
+	for(int i = 0; i < 1000; ++i)
+		hs2.add(i);
+	assert(hs2.size() == 1000 && hs2.contains(999));
+
+	std::cout << "!!!### FINE TEST DEL CARICAMENTO DI SEQUENZE IN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della copia strutturale di MultiSet
+
+	@description
+	Questa funzione globale si occupa di verificare che copia e assegnamento producano
+	MultiSet uguali all'originale, con lo stesso ordine di iterazione, e che l'assegnamento
+	riutilizzi i nodi del MultiSet di destinazione.
+*/
+void test_multiset_copy() {
+	std::cout << "!!!### TEST DELLA COPIA DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Copia di MultiSet con e senza funtore di hash: stesso ordine di iterazione" << std::endl;
+	std::cout << std::endl;
+	msint l;
+	mshint h;
+	for(int i = 0; i < 500; ++i) {
+		l.add(i % 37);
+		h.add(i % 101);
+	}
+	msint lc(l);
+	mshint hc(h);
+	assert(lc == l && hc == h);
+	msint::const_iterator li = l.begin(), lci = lc.begin();
+	for(; li != l.end(); ++li, ++lci)
+		assert(*li == *lci);
+	assert(lci == lc.end());
+	mshint::const_iterator hi = h.begin(), hci = hc.begin();
+	for(; hi != h.end(); ++hi, ++hci)
+		assert(*hi == *hci);
+	assert(hci == hc.end());
+
+	std::cout << "Assegnamento tra MultiSet di dimensioni diverse" << std::endl;
+	std::cout << std::endl;
+	mshint small;
+	small.add(1);
+	small.add(1);
+	hc = small; // Da bucket a lista
+	assert(hc == small && hc.size() == 2 && !hc.contains(50));
+	hc = h; // Da lista a bucket
+	assert(hc == h);
+	hc = hc;
+	assert(hc == h);
+
+	std::cout << "Assegnamento con allocatore a blocchi: i nodi sono riutilizzati" << std::endl;
+	std::cout << std::endl;
+	mspint p1, p2;
+	for(int i = 0; i < 300; ++i) {
+		p1.add(i);
+		p2.add(-i);
+		p2.add(-i);
+	}
+	multiset_pool_stats before = p1.get_allocator().stats();
+	p1 = p2;
+	multiset_pool_stats after = p1.get_allocator().stats();
+	assert(p1 == p2 && p1.size() == 600);
+	assert(after.allocations == before.allocations); // Nessun nuovo nodo né bucket
+	assert(after.slots_in_use == 300);
+
+	std::cout << "Copia di MultiSet di MultiSet di point" << std::endl;
+	std::cout << std::endl;
+	ms_mspoint nested, nested2;
+	mspoint inner;
+	inner.add(point(1, 2));
+	nested.add(inner);
+	inner.add(point(3, 4));
+	nested.add(inner);
+	nested.add(inner);
+	nested2.add(inner);
+	nested2 = nested;
+	assert(nested2 == nested && nested2.nocc(inner) == 2);
+
+	std::cout << "!!!### FINE TEST DELLA COPIA DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dell'inserimento e della rimozione di più occorrenze
+
+	@description
+	Questa funzione globale si occupa di verificare add(v, k), remove(v, k) e set_count(v, k)
+	su MultiSet con e senza funtore di hash e su OrderedMultiSet, anche con un numero di
+	occorrenze non rappresentabile su 32 bit, e la segnalazione degli overflow.
+*/
+void test_multiset_counts() {
+	std::cout << "!!!### TEST DELLE OPERAZIONI SU PIU' OCCORRENZE ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	const msint::size_type big = 5000000000ULL; // Numero di occorrenze maggiore di 2^32
+
+	msint l;
+	mshint h;
+	omsint o;
+
+	std::cout << "Inserimento di " << big << " occorrenze di un valore" << std::endl;
+	std::cout << std::endl;
+	l.add(7, big);
+	h.add(7, big);
+	o.add(7, big);
+	l.add(3, 2);
+	h.add(3, 2);
+	o.add(3, 2);
+	l.add(4, 0);
+	assert(!l.contains(4));
+	assert(l.nocc(7) == big && h.nocc(7) == big && o.nocc(7) == big);
+	assert(l.size() == big + 2 && h.size() == big + 2 && o.size() == big + 2);
+	assert(o.rank(7) == 2 && o.count_range(0, 10) == big + 2);
+
+	std::cout << "Rimozione di più occorrenze" << std::endl;
+	std::cout << std::endl;
+	l.remove(7, big - 1);
+	h.remove(7, big - 1);
+	o.remove(7, big - 1);
+	assert(l.nocc(7) == 1 && h.nocc(7) == 1 && o.nocc(7) == 1);
+	l.remove(3, 2);
+	h.remove(3, 2);
+	o.remove(3, 2);
+	assert(!l.contains(3) && !h.contains(3) && !o.contains(3));
+	assert(l.size() == 1 && h.size() == 1 && o.size() == 1 && o.distinct_size() == 1);
+
+	std::cout << "Test su rimozione di più occorrenze di quelle presenti" << std::endl;
+
+	try {
+		h.remove(7, 2);
+	}
+	catch(multiset_value_not_found &e) { // Test eccezione custom
+		std::cout << "Eccezione verificata: occorrenze insufficienti" << std::endl;
+		std::cout << std::endl;
+	}
+	assert(h.nocc(7) == 1 && h.size() == 1);
+
+	std::cout << "Impostazione del numero di occorrenze" << std::endl;
+	std::cout << std::endl;
+	for(int i = 0; i < 100; ++i) {
+		h.set_count(i, i);
+		o.set_count(i, i);
+	}
+	assert(h.nocc(7) == 7 && o.nocc(7) == 7 && !h.contains(0) && !o.contains(0));
+	assert(h.size() == 4950 && o.size() == 4950);
+	h.set_count(50, 0);
+	o.set_count(50, 0);
+	h.set_count(51, 1);
+	o.set_count(51, 1);
+	assert(!h.contains(50) && !o.contains(50) && h.nocc(51) == 1 && o.nocc(51) == 1);
+	assert(h.size() == 4850 && o.size() == 4850 && o.rank(52) == o.count_range(0, 51));
+
+	std::cout << "Test su numero di occorrenze fuori dai limiti" << std::endl;
+
+	try {
+		l.add(7, static_cast<msint::size_type>(-1));
+	}
+	catch(multiset_count_overflow &e) { // Test eccezione custom
+		std::cout << "Eccezione verificata: numero di occorrenze fuori dai limiti" << std::endl;
+		std::cout << std::endl;
+	}
+	assert(l.nocc(7) == 1 && l.size() == 1);
+
+	std::cout << "!!!### FINE TEST DELLE OPERAZIONI SU PIU' OCCORRENZE ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test delle operazioni insiemistiche tra MultiSet
+
+	@description
+	Questa funzione globale si occupa di verificare unione, intersezione, somma, differenza
+	ed inclusione su MultiSet con e senza funtore di hash e su OrderedMultiSet, sia nella
+	forma che restituisce un nuovo MultiSet sia in quella con assegnamento composto.
+*/
+void test_multiset_algebra() {
+	std::cout << "!!!### TEST DELLE OPERAZIONI INSIEMISTICHE TRA MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	mshint a, b;
+	omsint oa, ob;
+	msint la, lb;
+	int va[] = {1, 1, 1, 2, 2, 3, 5};
+	int vb[] = {1, 2, 2, 2, 4, 5, 5};
+	for(int i = 0; i < 7; ++i) {
+		a.add(va[i]);
+		oa.add(va[i]);
+		la.add(va[i]);
+		b.add(vb[i]);
+		ob.add(vb[i]);
+		lb.add(vb[i]);
+	}
+
+	std::cout << "A = " << oa << std::endl;
+	std::cout << "B = " << ob << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Unione (massimo delle occorrenze): " << (oa | ob) << std::endl;
+	mshint u = a | b;
+	assert(u.size() == 10 && u.nocc(1) == 3 && u.nocc(2) == 3 && u.nocc(4) == 1 && u.nocc(5) == 2);
+	assert((oa | ob).size() == 10 && (oa | ob).nocc(2) == 3);
+	assert((la | lb).size() == 10 && (la | lb).nocc(3) == 1);
+
+	std::cout << "Intersezione (minimo delle occorrenze): " << (oa & ob) << std::endl;
+	mshint in = a & b;
+	assert(in.size() == 4 && in.nocc(1) == 1 && in.nocc(2) == 2 && in.nocc(5) == 1 && !in.contains(3));
+	assert((oa & ob).size() == 4 && (oa & ob).distinct_size() == 3);
+	assert((la & lb) == (lb & la));
+
+	std::cout << "Somma: " << (oa + ob) << std::endl;
+	mshint su = a + b;
+	assert(su.size() == 14 && su.nocc(2) == 5 && su.nocc(5) == 3);
+	assert((oa + ob).size() == 14 && (oa + ob).nocc(1) == 4);
+	assert((la + lb).nocc(4) == 1);
+
+	std::cout << "Differenza troncata A - B: " << (oa - ob) << std::endl;
+	std::cout << std::endl;
+	mshint d = a - b;
+	assert(d.size() == 3 && d.nocc(1) == 2 && d.nocc(3) == 1 && !d.contains(2) && !d.contains(5));
+	assert((oa - ob).size() == 3 && !(oa - ob).contains(5));
+	assert((la - lb).size() == 3 && (lb - la).nocc(2) == 1);
+
+	std::cout << "Inclusione" << std::endl;
+	std::cout << std::endl;
+	assert(u.includes(a) && u.includes(b) && a.includes(in) && !a.includes(b));
+	assert((oa | ob).includes(oa) && !oa.includes(ob) && oa.includes(oa & ob));
+	assert((la + lb).includes(lb) && !lb.includes(la));
+
+	std::cout << "Assegnamenti composti, anche di un MultiSet con sé stesso" << std::endl;
+	std::cout << std::endl;
+	mshint c(a);
+	c += c;
+	assert(c.size() == 14 && c.nocc(1) == 6);
+	c &= b;
+	assert(c == ((a + a) & b));
+	c |= c;
+	c -= c;
+	assert(c.size() == 0 && c.begin() == c.end());
+	omsint oc(oa);
+	oc += oc;
+	oc -= ob;
+	assert(oc.size() == 8 && oc.nocc(1) == 5 && oc.nocc(2) == 1);
+
+	std::cout << "Operazioni su MultiSet con molti elementi distinti" << std::endl;
+	std::cout << std::endl;
+	mshint big1, big2;
+	omsint obig1, obig2;
+	for(int i = 0; i < 10000; ++i) {
+		big1.add(i, 2);
+		big2.add(i + 5000, 3);
+		obig1.add(i, 2);
+		obig2.add(i + 5000, 3);
+	}
+	assert((big1 | big2).size() == 40000 && (big1 & big2).size() == 10000);
+	assert((obig1 | obig2).size() == 40000 && (obig1 & obig2).size() == 10000);
+	assert((obig1 - obig2).distinct_size() == 5000 && (obig1 - obig2).rank(5000) == 10000);
+	assert((obig1 + obig2).count_range(5000, 9999) == 25000);
+
+	std::cout << "!!!### FINE TEST DELLE OPERAZIONI INSIEMISTICHE TRA MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dell'impronta e dell'uguaglianza tra MultiSet
+
+	@description
+	L'impronta non dipende dall'ordine di inserimento né dal numero di bucket, e torna al valore
+	precedente dopo la rimozione di un elemento. Viene infine usata come hash di un MultiSet di MultiSet.
+*/
+void test_multiset_fingerprint() {
+	std::cout << "!!!### TEST DELL'IMPRONTA DI UN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Impronta indipendente dall'ordine di inserimento" << std::endl;
+	std::cout << std::endl;
+	mshint a, b;
+	for(int i = 0; i < 1000; ++i) {
+		a.add(i, i % 3 + 1);
+		b.add(999 - i, (999 - i) % 3 + 1);
+	}
+	assert(a.fingerprint() == b.fingerprint() && a == b);
+	mshint c;
+	c.reserve(100000);
+	c += a;
+	assert(c.fingerprint() == a.fingerprint() && c == a && a == c);
+	mshint e;
+	assert(e.fingerprint() == 0 && e == mshint());
+
+	std::cout << "Impronta aggiornata ad ogni modifica" << std::endl;
+	std::cout << std::endl;
+	std::size_t fp = a.fingerprint();
+	a.add(5000);
+	assert(a.fingerprint() != fp && !(a == b));
+	a.remove(5000);
+	assert(a.fingerprint() == fp && a == b);
+	a.set_count(7, 10);
+	b.remove(7);
+	b.add(7, 9);
+	assert(a.fingerprint() == b.fingerprint() && a == b);
+	b.remove(4);
+	b.add(3);
+	assert(a.size() == b.size() && a.distinct_size() == b.distinct_size() && !(a == b));
+	assert((a | b).fingerprint() == (b | a).fingerprint() && (a & b) == (b & a));
+	mshint d(a);
+	d += d;
+	assert(d.fingerprint() == (a + a).fingerprint() && d == a + a);
+	d -= a;
+	assert(d == a);
+
+	std::cout << "Uguaglianza tra MultiSet senza hash" << std::endl;
+	std::cout << std::endl;
+	msint la, lb;
+	for(int i = 0; i < 10; ++i) {
+		la.add(i);
+		lb.add(9 - i);
+	}
+	assert(la == lb && la.fingerprint() == lb.fingerprint() && la.fingerprint() != la.size()); // Hash dei byte degli int
+	lb.remove(0);
+	lb.add(10);
+	assert(la.size() == lb.size() && la.fingerprint() != lb.fingerprint() && !(la == lb));
+	msstr sa, sb;
+	sa.add("a");
+	sb.add("b");
+	assert(sa.fingerprint() == sa.size() && sb.fingerprint() == sa.fingerprint() && !(sa == sb)); // Confronto non byte per byte
+
+	std::cout << "MultiSet di MultiSet con hash" << std::endl;
+	std::cout << std::endl;
+	ms_mshint mm;
+	for(int i = 0; i < 100; ++i) {
+		mshint s;
+		for(int j = 0; j <= i; ++j)
+			s.add(j);
+		mm.add(s);
+	}
+	mm.add(b);
+	mshint s;
+	for(int j = 10; j >= 0; --j)
+		s.add(j);
+	assert(mm.contains(s) && mm.nocc(s) == 1);
+	s.add(0);
+	assert(!mm.contains(s));
+	mm.add(s);
+	mm.add(s);
+	assert(mm.nocc(s) == 2 && mm.distinct_size() == 102);
+
+	std::cout << "MultiSet senza hash di MultiSet di point: l'impronta usa i byte dei point" << std::endl;
+	std::cout << std::endl;
+	ms_mspoint outer;
+	std::vector<mspoint> keys(200);
+	for(int i = 0; i < 200; ++i) {
+		for(int j = 0; j < 10; ++j) // Tutti i MultiSet interni hanno 10 elementi
+			keys[i].add(point(i, j));
+		outer.add(keys[i]);
+	}
+	for(int i = 0; i < 200; ++i) {
+		assert(keys[i].fingerprint() != keys[i].size());
+		assert(keys[i].fingerprint() != keys[(i + 1) % 200].fingerprint());
+		assert(outer.nocc(keys[i]) == 1);
+	}
+	mspoint missing, reversed;
+	for(int j = 0; j < 10; ++j) {
+		missing.add(point(j, j));
+		reversed.add(point(7, 9 - j));
+	}
+	assert(missing.size() == keys[0].size() && !outer.contains(missing));
+	assert(reversed.fingerprint() == keys[7].fingerprint() && reversed == keys[7] && outer.nocc(reversed) == 1);
+	reversed.remove(point(7, 3));
+	reversed.add(point(3, 7));
+	assert(reversed.size() == keys[7].size() && reversed.fingerprint() != keys[7].fingerprint() && !outer.contains(reversed));
+
+	std::cout << "!!!### FINE TEST DELL'IMPRONTA DI UN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dell'iterazione sugli elementi distinti di un MultiSet
+
+	@description
+	Ogni valore è visitato una sola volta, insieme al suo numero di occorrenze; la stampa
+	di un MultiSet vuoto produce {}.
+*/
+void test_multiset_distinct() {
+	std::cout << "!!!### TEST DEGLI ELEMENTI DISTINTI DI UN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Coppie (valore, occorrenze) di un MultiSet con hash" << std::endl;
+	std::cout << std::endl;
+	mshint h;
+	for(int i = 0; i < 1000; ++i)
+		h.add(i % 10, i % 10 == 0 ? 1000 : 1);
+	mshint::size_type total = 0, steps = 0;
+	for(mshint::distinct_iterator i = h.distinct().begin(); i != h.distinct().end(); ++i) {
+		assert((*i).second == h.nocc((*i).first) && i.count() == (*i).second);
+		total += i.count();
+		steps++;
+	}
+	assert(total == h.size() && steps == h.distinct_size() && h.distinct().size() == 10);
+	mshint::distinct_iterator it = h.distinct().begin();
+	mshint::distinct_iterator old = it++;
+	assert(old != it && old == h.distinct().begin());
+
+	std::cout << "Coppie (valore, occorrenze) di un MultiSet senza hash, nell'ordine di inserimento" << std::endl;
+	std::cout << std::endl;
+	msstr l;
+	l.add("b");
+	l.add("a");
+	l.add("b");
+	msstr::distinct_range r = l.distinct();
+	msstr::distinct_iterator j = r.begin();
+	assert(j.value() == "b" && j.count() == 2);
+	++j;
+	assert(j.value() == "a" && j.count() == 1);
+	++j;
+	assert(j == r.end());
+	bool thrown = false;
+	try {
+		++j;
+	}
+	catch(multiset_iterator_out_of_bounds &e) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "Stampa di un MultiSet vuoto e di un MultiSet con un elemento" << std::endl;
+	std::cout << std::endl;
+	std::ostringstream os;
+	msint e;
+	assert(e.distinct().empty() && e.distinct().begin() == e.distinct().end());
+	os << e;
+	assert(os.str() == "{}");
+	e.add(7, 3);
+	os.str("");
+	os << e;
+	assert(os.str() == "{<7, 3>}");
+	l.add("c");
+	os.str("");
+	os << l;
+	assert(os.str() == "{<b, 2>, <a, 1>, <c, 1>}");
+
+	std::cout << "!!!### FINE TEST DEGLI ELEMENTI DISTINTI DI UN MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della classe FlatMultiSet
+
+	@description
+	Oltre alle operazioni di base, vengono verificati gli iteratori ad accesso casuale
+	(anche all'indietro a partire da end()) e l'accesso alla k-esima occorrenza.
+*/
+void test_flat_multiset() {
+	std::cout << "!!!### TEST DEL FLATMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Inserimenti e rimozioni" << std::endl;
+	std::cout << std::endl;
+	fmsint f;
+	f.add(4, 3);
+	f.add(7);
+	f.add(2, 2);
+	f.add(7);
+	assert(f.size() == 7 && f.distinct_size() == 3 && f.nocc(7) == 2 && !f.contains(5));
+	std::cout << "F = " << f << std::endl;
+	std::cout << std::endl;
+	f.remove(7, 2);
+	assert(f.size() == 5 && f.distinct_size() == 2 && !f.contains(7) && f.value_at(1) == 2);
+	bool thrown = false;
+	try {
+		f.remove(4, 4);
+	}
+	catch(multiset_value_not_found &e) {
+		thrown = true;
+	}
+	assert(thrown && f.nocc(4) == 3);
+	f.add(7, 2);
+
+	std::cout << "Iteratori ad accesso casuale" << std::endl;
+	std::cout << std::endl;
+	int seq[] = {4, 4, 4, 2, 2, 7, 7};
+	fmsint::const_iterator i = f.begin();
+	for(int k = 0; k < 7; ++k, ++i)
+		assert(*i == seq[k] && f.begin()[k] == seq[k] && *(f.begin() + k) == seq[k]);
+	assert(i == f.end() && f.end() - f.begin() == 7);
+	for(int k = 6; k >= 0; --k)
+		assert(*--i == seq[k]);
+	assert(i == f.begin());
+	i += 6;
+	assert(*i == 7 && i.count() == 2 && *(i - 4) == 4 && *(2 + f.begin()) == 4);
+	i -= 3;
+	assert(*i == 2 && i > f.begin() && i <= f.end() && !(i < f.begin()));
+	assert(*(f.end() - 1) == 7);
+	thrown = false;
+	try {
+		f.end() + 1;
+	}
+	catch(multiset_iterator_out_of_bounds &e) {
+		thrown = true;
+	}
+	assert(thrown);
+
+	std::cout << "Accesso alla k-esima occorrenza" << std::endl;
+	std::cout << std::endl;
+	for(int k = 0; k < 7; ++k)
+		assert(f.nth(k) == seq[k]);
+	assert(f.prefix_count(0) == 0 && f.prefix_count(2) == 5 && f.prefix_count(3) == 7);
+	f.add(2);
+	assert(f.nth(5) == 2 && f.nth(6) == 7 && f.prefix_count(2) == 6);
+	f.remove(4, 3);
+	assert(f.size() == 5 && f.nth(0) == 7 && f.nth(2) == 2);
+
+	std::cout << "Conversione da MultiSet e confronto" << std::endl;
+	std::cout << std::endl;
+	mshint h;
+	for(int k = 0; k < 1000; ++k)
+		h.add(k % 100);
+	fmsint g(h);
+	assert(g.size() == 1000 && g.distinct_size() == 100 && g.nocc(42) == 10);
+	std::vector<int> v(g.begin(), g.end());
+	std::sort(v.begin(), v.end());
+	assert(v.size() == 1000 && v[0] == 0 && v[999] == 99);
+	fmsint g2(v.begin(), v.end());
+	assert(g == g2 && !(g == f));
+
+	std::cout << "!!!### FINE TEST DEL FLATMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test del campionatore pesato
+
+	@description
+	Le frequenze dei valori estratti devono essere vicine ai rapporti tra i numeri di occorrenze.
+*/
+void test_multiset_sampler() {
+	std::cout << "!!!### TEST DEL CAMPIONATORE PESATO ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Estrazioni da un MultiSet con frequenze 1, 3, 6" << std::endl;
+	std::cout << std::endl;
+	mshint h;
+	h.add(1);
+	h.add(2, 3);
+	h.add(3, 6);
+	multiset_sampler<int> s(h);
+	std::mt19937 g(42);
+	const int n = 100000;
+	int freq[4] = {0, 0, 0, 0};
+	for(int i = 0; i < n; ++i)
+		freq[s(g)]++;
+	assert(freq[0] == 0 && freq[1] + freq[2] + freq[3] == n);
+	assert(freq[1] > n / 10 - n / 100 && freq[1] < n / 10 + n / 100);
+	assert(freq[2] > 3 * n / 10 - n / 100 && freq[2] < 3 * n / 10 + n / 100);
+	assert(freq[3] > 6 * n / 10 - n / 100 && freq[3] < 6 * n / 10 + n / 100);
+
+	std::cout << "Estrazioni in blocco da un FlatMultiSet" << std::endl;
+	std::cout << std::endl;
+	fmsint f(h);
+	f.add(4, 10);
+	multiset_sampler<int> fsamp(f);
+	std::vector<int> out(n);
+	assert(fsamp.sample(g, n, out.begin()) == out.end() && fsamp.size() == 20);
+	int four = 0;
+	for(int i = 0; i < n; ++i) {
+		assert(out[i] >= 1 && out[i] <= 4);
+		four += (out[i] == 4);
+	}
+	assert(four > n / 2 - n / 100 && four < n / 2 + n / 100);
+
+	std::cout << "Estrazione da un MultiSet con un solo valore e da uno vuoto" << std::endl;
+	std::cout << std::endl;
+	msint one;
+	one.add(7, 5);
+	multiset_sampler<int> s1(one);
+	assert(s1(g) == 7 && s1(g) == 7);
+	multiset_sampler<int> empty((msint()));
+	bool thrown = false;
+	try {
+		empty(g);
+	}
+	catch(multiset_value_not_found &e) {
+		thrown = true;
+	}
+	assert(thrown && empty.sample(g, 0, out.begin()) == out.begin());
+
+	std::cout << "!!!### FINE TEST DEL CAMPIONATORE PESATO ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dei valori più frequenti di un MultiSet
+
+	@description
+	top_k() e most_common() devono dare lo stesso risultato con e senza l'indice, anche
+	dopo modifiche successive all'attivazione dell'indice.
+*/
+void test_multiset_top_k() {
+	std::cout << "!!!### TEST DEI VALORI PIU' FREQUENTI ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "top_k() e most_common() senza indice" << std::endl;
+	std::cout << std::endl;
+	mshint h;
+	msstr l;
+	for(int i = 1; i <= 100; ++i)
+		h.add(i, static_cast<mshint::size_type>(i * 7 % 101));
+	std::vector<std::pair<int, mshint::size_type>> top = h.top_k(3);
+	assert(top.size() == 3 && top[0].second == 100 && top[1].second == 99 && top[2].second == 98);
+	assert(h.nocc(top[0].first) == 100 && h.most_common() == top[0].first);
+	assert(h.top_k(0).empty() && h.top_k(1000).size() == 100);
+	l.add("a");
+	l.add("b", 3);
+	l.add("c", 2);
+	assert(l.most_common() == "b" && l.top_k(2)[1].first == "c");
+	bool thrown = false;
+	try {
+		msint().most_common();
+	}
+	catch(multiset_value_not_found &e) {
+		thrown = true;
+	}
+	assert(thrown && msint().top_k(5).empty());
+
+	std::cout << "Indice dei valori più frequenti aggiornato ad ogni modifica" << std::endl;
+	std::cout << std::endl;
+	mshint c(h);
+	assert(!c.top_index_enabled());
+	h.enable_top_index();
+	assert(h.top_index_enabled() && h.top_k(3) == top);
+	h.add(5, 200);
+	h.remove(top[0].first, 100);
+	h.set_count(50, 150);
+	assert(h.most_common() == 5 && h.top_k(2)[1].first == 50 && h.top_k(2)[1].second == 150);
+	assert(!h.contains(top[0].first) && h.top_k(1000).size() == 99);
+	c.add(5, 200);
+	c.remove(top[0].first, 100);
+	c.set_count(50, 150);
+	h &= c;
+	h += h;
+	c += c;
+	assert(h.top_k(10) == c.top_k(10) && h.most_common() == 5);
+	mshint m(std::move(h));
+	assert(m.top_index_enabled() && !h.top_index_enabled() && m.top_k(4) == c.top_k(4));
+	m.clear();
+	assert(m.top_k(3).empty() && m.top_index_enabled());
+	m.add(1);
+	assert(m.most_common() == 1);
+	m.disable_top_index();
+	assert(!m.top_index_enabled() && m.most_common() == 1);
+
+	std::cout << "!!!### FINE TEST DEI VALORI PIU' FREQUENTI ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della classe ApproxMultiSet
+
+	@description
+	Le stime su un flusso con frequenze sbilanciate sono confrontate con i valori esatti
+	di un MultiSet: non devono mai essere minori e, per questo flusso, non devono superarli
+	di più di epsilon * size(). L'unione di due ApproxMultiSet costruiti su metà del flusso
+	deve rispettare gli stessi limiti.
+*/
+void test_approx_multiset() {
+	std::cout << "!!!### TEST DELL'APPROXMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	const int n = 200000;
+	const double eps = 0.001;
+	ApproxMultiSet<int> a(eps, 0.01, 50), b(eps, 0.01, 50), whole(eps, 0.01, 50);
+	mshint exact;
+	std::srand(7);
+	for(int i = 0; i < n; ++i) {
+		int r = std::rand() % 1000;
+		int v = (r < 500) ? r % 10 : (r < 800 ? 10 + std::rand() % 100 : 1000 + std::rand() % 100000);
+		exact.add(v);
+		whole.add(v);
+		if(i % 2 == 0)
+			a.add(v);
+		else
+			b.add(v);
+	}
+
+	std::cout << "Stime per eccesso, con errore limitato" << std::endl;
+	std::cout << std::endl;
+	assert(whole.size() == exact.size() && whole.width() >= 2719 && whole.depth() == 5);
+	mshint::distinct_range r = exact.distinct();
+	for(mshint::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+		assert(whole.nocc(i.value()) >= i.count());
+		assert(whole.nocc(i.value()) - i.count() <= eps * n);
+	}
+	assert(!whole.contains(-1) || whole.nocc(-1) <= eps * n);
+
+	std::cout << "Valori più frequenti" << std::endl;
+	std::cout << std::endl;
+	std::vector<std::pair<int, ApproxMultiSet<int>::size_type>> top = whole.top_k(10);
+	assert(top.size() == 10);
+	for(std::size_t i = 0; i < top.size(); ++i) {
+		assert(top[i].first >= 0 && top[i].first < 10);
+		assert(top[i].second >= exact.nocc(top[i].first) && whole.guaranteed(top[i].first) <= exact.nocc(top[i].first));
+	}
+
+	std::cout << "Unione di due ApproxMultiSet" << std::endl;
+	std::cout << std::endl;
+	ApproxMultiSet<int> m = a + b;
+	assert(m.size() == exact.size());
+	for(mshint::distinct_iterator i = r.begin(); i != r.end(); ++i)
+		assert(m.nocc(i.value()) >= i.count() && m.nocc(i.value()) - i.count() <= eps * n);
+	top = m.top_k(10);
+	for(std::size_t i = 0; i < top.size(); ++i)
+		assert(top[i].first < 10 && top[i].second >= exact.nocc(top[i].first) && m.guaranteed(top[i].first) <= exact.nocc(top[i].first));
+	bool thrown = false;
+	try {
+		a += ApproxMultiSet<int>(0.01, 0.01, 50);
+	}
+	catch(multiset_incompatible &e) {
+		thrown = true;
+	}
+	assert(thrown && a.size() == static_cast<std::size_t>(n / 2));
+
+	std::cout << "!!!### FINE TEST DELL'APPROXMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+
+/**
+	@brief Dati di un thread di test del ConcurrentMultiSet
+*/
+struct concurrent_task {
+	cmsint *set; ///< ConcurrentMultiSet condiviso
+	int id; ///< Indice del thread
+	int n; ///< Numero di valori inseriti dal thread
+};
+
+/**
+	@brief Corpo di un thread di test del ConcurrentMultiSet
+
+	@description
+	Inserisce i valori da 0 a n - 1 (uno ciascuno, più id occorrenze di 0), poi rimuove
+	i valori multipli di 4 e quindi verifica che il valore 1 sia presente.
+
+	@param arg puntatore ad un concurrent_task
+
+	@return nullptr
+*/
+void* concurrent_task_run(void *arg) {
+	concurrent_task *task = static_cast<concurrent_task*>(arg);
+	for(int i = 0; i < task->n; ++i)
+		task->set->add(i);
+	task->set->add(0, task->id);
+	for(int i = 0; i < task->n; i += 4)
+		task->set->remove(i);
+	assert(task->set->contains(1));
+	return nullptr;
+}
+
+/**
+	@brief Test del ConcurrentMultiSet
+
+	@description
+	Questa funzione globale verifica le operazioni del ConcurrentMultiSet su un solo thread,
+	poi l'uso concorrente da parte di 4 thread, confrontando il risultato con quello atteso.
+*/
+void test_concurrent_multiset() {
+	std::cout << "!!!### TEST DEL CONCURRENTMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Operazioni su un solo thread" << std::endl;
+	std::cout << std::endl;
+	cmsint c(5);
+	assert(c.shard_count() == 8 && c.size() == 0 && !c.contains(3));
+	c.add(3);
+	c.add(3, 4);
+	c.add(7);
+	assert(c.nocc(3) == 5 && c.nocc(7) == 1 && c.size() == 6 && c.distinct_size() == 2);
+	c.remove(3, 2);
+	c.remove(7);
+	assert(c.nocc(3) == 3 && !c.contains(7) && c.size() == 3);
+	bool thrown = false;
+	try {
+		c.remove(7);
+	}
+	catch(multiset_value_not_found &e) {
+		thrown = true;
+	}
+	assert(thrown && c.size() == 3);
+
+	mshint m;
+	for(int i = 0; i < 100; ++i)
+		m.add(i % 30);
+	c += m;
+	assert(c.size() == 103 && c.distinct_size() == 30 && c.nocc(3) == 7 && c.nocc(29) == 3);
+	mshint snap = c.snapshot();
+	m.add(3, 3);
+	assert(snap == m);
+	c.clear();
+	assert(c.size() == 0 && cmsint(1).shard_count() == 1 && cmsint(0).shard_count() == 1);
+
+	std::cout << "Un solo calcolo dell'hash per operazione" << std::endl;
+	std::cout << std::endl;
+	mshint hm;
+	std::size_t h7 = hm.hash_value(7);
+	hm.add_hashed(7, h7, 3);
+	assert(hm.nocc(7) == 3 && hm.nocc_hashed(7, h7) == 3 && hm.nocc_hashed(8, hm.hash_value(8)) == 0);
+	hm.remove_hashed(7, h7, 2);
+	assert(hm.nocc(7) == 1 && hm.size() == 1 && mshint(hm).nocc_hashed(7, h7) == 1);
+	ConcurrentMultiSet<int, equal_int, counting_hash_int> ch(4);
+	counting_hash_int::calls = 0;
+	for(int i = 0; i < 1000; ++i)
+		ch.add(i % 100);
+	ch.add(5, 3);
+	ch.remove(5, 2);
+	ch.remove(6);
+	assert(counting_hash_int::calls == 1003);
+	assert(ch.nocc(5) == 11 && ch.nocc(6) == 9 && !ch.contains(1000));
+	assert(counting_hash_int::calls == 1006);
+	MultiSet<int, equal_int, counting_hash_int> chm;
+	chm.add(1, 2);
+	chm.add(1000);
+	counting_hash_int::calls = 0;
+	ch += chm;
+	assert(counting_hash_int::calls == 2 && ch.nocc(1) == 12 && ch.nocc(1000) == 1 && ch.size() == 1003);
+
+	std::cout << "Inserimenti e rimozioni concorrenti da 4 thread" << std::endl;
+	std::cout << std::endl;
+	const int nthreads = 4, n = 20000;
+	std::vector<concurrent_task> tasks(nthreads);
+	std::vector<pthread_t> threads(nthreads);
+	for(int i = 0; i < nthreads; ++i) {
+		tasks[i].set = &c;
+		tasks[i].id = i;
+		tasks[i].n = n;
+		int err = pthread_create(&threads[i], nullptr, concurrent_task_run, &tasks[i]);
+		assert(err == 0);
+	}
+	for(int i = 0; i < nthreads; ++i)
+		pthread_join(threads[i], nullptr);
+	assert(c.size() == static_cast<std::size_t>(nthreads * (n - n / 4) + 6));
+	assert(c.distinct_size() == static_cast<std::size_t>(n - n / 4 + 1));
+	assert(c.nocc(0) == 6 && c.nocc(1) == nthreads && c.nocc(4) == 0);
+	snap = c.snapshot();
+	assert(snap.size() == c.size());
+	for(int i = 1; i < n; ++i)
+		assert(snap.nocc(i) == ((i % 4 == 0) ? 0 : static_cast<std::size_t>(nthreads)));
+
+	std::cout << "!!!### FINE TEST DEL CONCURRENTMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della costruzione parallela di MultiSet
+
+	@description
+	Questa funzione globale verifica che multiset_parallel_build() produca lo stesso MultiSet
+	del costruttore da sequenza, con diversi numeri di thread e diversi tipi di MultiSet.
+*/
+void test_multiset_parallel_build() {
+	std::cout << "!!!### TEST DELLA COSTRUZIONE PARALLELA DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "MultiSet di int con hash, da 1 a 8 thread" << std::endl;
+	std::cout << std::endl;
+	std::vector<int> v(200000);
+	std::srand(11);
+	for(std::size_t i = 0; i < v.size(); ++i)
+		v[i] = std::rand() % 5000;
+	mshint seq(v.begin(), v.end());
+	for(std::size_t t = 1; t <= 8; ++t) {
+		mshint par = multiset_parallel_build<mshint>(v.begin(), v.end(), t);
+		assert(par == seq && par.size() == seq.size() && par.distinct_size() == seq.distinct_size());
+		assert(par.fingerprint() == seq.fingerprint());
+		par.add(-1);
+		par.remove(0, par.nocc(0));
+		assert(par.nocc(-1) == 1 && !par.contains(0) && par.size() == seq.size() + 1 - seq.nocc(0));
+	}
+
+	std::cout << "Sequenze corte o vuote, elementi distinti" << std::endl;
+	std::cout << std::endl;
+	assert(multiset_parallel_build<mshint>(v.begin(), v.begin(), 4).size() == 0);
+	assert((multiset_parallel_build<mshint>(v.begin(), v.begin() + 5, 4) == mshint(v.begin(), v.begin() + 5)));
+	std::vector<int> d(30000);
+	for(std::size_t i = 0; i < d.size(); ++i)
+		d[i] = static_cast<int>(i * 7919);
+	assert((multiset_parallel_build<mshint>(d.begin(), d.end(), 3) == mshint(d.begin(), d.end())));
+
+	std::cout << "Altri tipi di MultiSet ed iteratori" << std::endl;
+	std::cout << std::endl;
+	std::vector<std::string> words;
+	for(int i = 0; i < 5000; ++i)
+		words.push_back("w" + std::to_string(i % 700));
+	assert((multiset_parallel_build<mshstr>(words.begin(), words.end(), 4) == mshstr(words.begin(), words.end())));
+	mspint pooled = multiset_parallel_build<mspint>(v.begin(), v.end(), 4);
+	assert(pooled == mspint(v.begin(), v.end()));
+	assert((multiset_parallel_build<msint>(v.begin(), v.begin() + 1000, 4) == msint(v.begin(), v.begin() + 1000)));
+	std::istringstream in("3 1 4 1 5 9 2 6 5 3 5");
+	mshint fromstream = multiset_parallel_build<mshint>(std::istream_iterator<int>(in), std::istream_iterator<int>(), 4);
+	assert(fromstream.size() == 11 && fromstream.nocc(5) == 3);
+
+	std::cout << "!!!### FINE TEST DELLA COSTRUZIONE PARALLELA DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Dati condivisi tra lo scrittore ed i lettori del test dello SnapshotMultiSet
+*/
+struct snapshot_task {
+	smsint *set; ///< SnapshotMultiSet condiviso
+	int values; ///< I valori usati vanno da 0 a values - 1
+	std::size_t total; ///< Numero totale di elementi, invariante ad ogni pubblicazione
+	std::size_t versions; ///< Versioni distinte osservate da un lettore
+};
+
+/**
+	@brief Corpo di un thread lettore del test dello SnapshotMultiSet
+
+	@description
+	Somma i numeri di occorrenze di tutti i valori su una stessa vista: ogni gruppo di
+	modifiche dello scrittore sposta occorrenze tra valori, quindi la somma deve essere
+	sempre uguale al totale, altrimenti il lettore avrebbe visto un gruppo applicato a metà.
+
+	@param arg puntatore ad uno snapshot_task (copia privata del lettore)
+
+	@return nullptr
+*/
+void* snapshot_reader_run(void *arg) {
+	snapshot_task *task = static_cast<snapshot_task*>(arg);
+	std::size_t last = static_cast<std::size_t>(-1);
+	for(int round = 0; round < 300; ++round) {
+		smsint::view v = task->set->read();
+		std::size_t sum = 0;
+		for(int i = 0; i < task->values; ++i)
+			sum += v.nocc(i);
+		assert(sum == task->total && v.size() == task->total);
+		if(v.number() != last) {
+			last = v.number();
+			task->versions++;
+		}
+	}
+	return nullptr;
+}
+
+/**
+	@brief Test dello SnapshotMultiSet
+
+	@description
+	Questa funzione globale verifica la visibilità delle modifiche solo dopo la pubblicazione,
+	la stabilità delle viste (anche oltre il numero di posizioni dei lettori), e la lettura
+	concorrente con uno scrittore da parte di 3 thread, con 2 posizioni dei lettori.
+*/
+void test_snapshot_multiset() {
+	std::cout << "!!!### TEST DELLO SNAPSHOTMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Pubblicazione di gruppi di modifiche" << std::endl;
+	std::cout << std::endl;
+	smsint s(4);
+	assert(s.reader_slots() == 4 && s.size() == 0 && !s.contains(1));
+	s.add(1);
+	s.add(2, 3);
+	assert(s.nocc(1) == 0 && s.size() == 0);
+	s.publish();
+	assert(s.nocc(1) == 1 && s.nocc(2) == 3 && s.size() == 4);
+	smsint::view before = s.read();
+	s.remove(2, 2);
+	s.add(2);
+	s.remove(1);
+	s.add(5, 5);
+	s.remove(5, 4);
+	bool thrown = false;
+	try {
+		s.remove(1);
+	}
+	catch(multiset_value_not_found &e) {
+		thrown = true;
+	}
+	assert(thrown);
+	s.publish();
+	assert(s.nocc(2) == 2 && !s.contains(1) && s.nocc(5) == 1 && s.size() == 3);
+	assert(before.nocc(1) == 1 && before.nocc(2) == 3 && before.size() == 4 && before.number() == 1);
+	assert(s.read().number() == 2 && s.read().distinct_size() == 2);
+
+	std::cout << "Lettori oltre le posizioni disponibili e crescita dei bucket" << std::endl;
+	std::cout << std::endl;
+	{
+		smsint::view a = s.read(), b = s.read(), d = s.read();
+		smsint::view c = std::move(a);
+		smsint::view extra = s.read(); // Tutte le posizioni sono occupate: posizione di riserva
+		assert(c.nocc(5) == 1 && extra.nocc(5) == 1 && extra.number() == 2);
+		{
+			smsint::view extra2 = s.read();
+			smsint::view moved = std::move(extra2); // La vista spostata resta contata una sola volta
+			assert(moved.size() == 3 && s.read().size() == 3);
+		}
+		for(int i = 0; i < 1000; ++i)
+			s.add(i, i % 3 + 1);
+		s.publish(); // La versione vista da extra non è liberata
+		assert(b.size() == 3 && c.size() == 3 && d.number() == 2 && extra.size() == 3 && extra.nocc(2) == 2);
+	}
+	mshint expected;
+	for(int i = 0; i < 1000; ++i)
+		expected.add(i, i % 3 + 1);
+	expected.add(2, 2);
+	expected.add(5);
+	smsint::view after = s.read();
+	assert(after.size() == expected.size() && after.distinct_size() == expected.distinct_size());
+	for(int i = -1; i <= 1000; ++i)
+		assert(after.nocc(i) == expected.nocc(i));
+
+	std::cout << "Lettori concorrenti con uno scrittore" << std::endl;
+	std::cout << std::endl;
+	smsint shared(2); // Meno posizioni che lettori: alcune viste usano la posizione di riserva
+	const int values = 200, nreaders = 3;
+	for(int i = 0; i < values; ++i)
+		shared.add(i, 10);
+	shared.publish();
+	snapshot_task task = {&shared, values, static_cast<std::size_t>(values * 10), 0};
+	std::vector<snapshot_task> tasks(nreaders, task);
+	std::vector<pthread_t> threads(nreaders);
+	for(int i = 0; i < nreaders; ++i) {
+		int err = pthread_create(&threads[i], nullptr, snapshot_reader_run, &tasks[i]);
+		assert(err == 0);
+	}
+	std::vector<std::size_t> counts(values, 10);
+	std::srand(13);
+	for(int batch = 0; batch < 300; ++batch) {
+		for(int j = 0; j < 20; ++j) {
+			int from = std::rand() % values, to = std::rand() % values;
+			if(counts[from] > 0) {
+				shared.remove(from);
+				shared.add(to);
+				counts[from]--;
+				counts[to]++;
+			}
+		}
+		shared.publish();
+	}
+	for(int i = 0; i < nreaders; ++i)
+		pthread_join(threads[i], nullptr);
+	assert(shared.size() == static_cast<std::size_t>(values * 10));
+	for(int i = 0; i < values; ++i)
+		assert(shared.nocc(i) == counts[i]);
+	for(int i = 0; i < nreaders; ++i)
+		assert(tasks[i].versions >= 1);
+
+	std::cout << "!!!### FINE TEST DELLO SNAPSHOTMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test dei nodi interni di MultiSet
+
+	@description
+	Questa funzione globale verifica che un MultiSet con al più N elementi distinti non
+	richieda memoria all'allocatore, lo spostamento dei nodi nell'allocatore oltre N elementi
+	distinti, e copia, spostamento e scambio di MultiSet con nodi interni.
+*/
+void test_multiset_inline() {
+	std::cout << "!!!### TEST DEI NODI INTERNI DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Fino a N elementi distinti nessuna allocazione, poi tutti i nodi nell'allocatore" << std::endl;
+	std::cout << std::endl;
+	multiset_pool_allocator<std::string> alloc;
+	msspstr ms(alloc);
+	ms.add("a");
+	ms.add("b", 3);
+	ms.emplace(2, 'c');
+	ms.add("d");
+	ms.remove("d");
+	ms.add("e");
+	assert(alloc.stats().allocations == 0);
+	ms.emplace(1, 'a'); // Valore già presente con tutte le posizioni occupate: il nodo temporaneo è allocato
+	assert(alloc.stats().slots_in_use == 0);
+	assert(ms.size() == 7 && ms.distinct_size() == 4 && ms.nocc("a") == 2 && ms.nocc("cc") == 1);
+	ms.add("f");
+	assert(alloc.stats().slots_in_use == 5);
+	assert(ms.size() == 8 && ms.nocc("b") == 3 && ms.nocc("e") == 1 && ms.nocc("f") == 1);
+	for(int i = 0; i < 100; ++i)
+		ms.add(std::to_string(i));
+	ms.remove("b", 3);
+	assert(ms.distinct_size() == 104 && ms.size() == 105 && !ms.contains("b"));
+	ms.clear();
+	assert(alloc.stats().slots_in_use == 0);
+	std::size_t allocations = alloc.stats().allocations;
+	ms.add("x");
+	assert(alloc.stats().allocations == allocations && ms.nocc("x") == 1);
+
+	std::cout << "Copia, spostamento e scambio con nodi interni" << std::endl;
+	std::cout << std::endl;
+	msspoint p1;
+	p1.add(point(1,1));
+	p1.add(point(0,0), 2);
+	p1.enable_top_index();
+	msspoint p2(p1);
+	assert(p2 == p1 && p2.nocc(point(0,0)) == 2);
+	msspoint p3(std::move(p1));
+	assert(p1.size() == 0 && p3 == p2 && p3.most_common().x == 0 && p3.top_index_enabled());
+	p1.add(point(5,5));
+	p1.swap(p3);
+	assert(p1 == p2 && p3.nocc(point(5,5)) == 1 && p3.size() == 1);
+	for(int i = 0; i < 20; ++i)
+		p3.add(point(i,i));
+	p3.swap(p1);
+	assert(p3 == p2 && p1.size() == 21 && p1.nocc(point(5,5)) == 2);
+	p2 = p1; // Da 2 nodi interni a 20 nodi nell'allocatore
+	assert(p2 == p1);
+	p1 = p3; // Da 20 nodi nell'allocatore a 2 nodi riutilizzati
+	assert(p1 == p3 && p1.size() == 3);
+	p1 = std::move(p2);
+	assert(p1.size() == 21 && p2.size() == 0);
+
+	std::cout << "MultiSet di MultiSet di point con nodi interni" << std::endl;
+	std::cout << std::endl;
+	ms_msspoint outer;
+	for(int i = 0; i < 50; ++i) {
+		msspoint inner;
+		for(int j = 0; j <= i % 8; ++j)
+			inner.add(point(j, i % 8));
+		outer.add(std::move(inner));
+	}
+	assert(outer.size() == 50 && outer.distinct_size() == 8);
+	msspoint key;
+	key.add(point(0,2));
+	key.add(point(1,2));
+	key.add(point(2,2));
+	assert(outer.nocc(key) == 6);
+	ms_msspoint outer_copy(outer);
+	assert(outer_copy == outer);
+	std::cout << outer.most_common() << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "!!!### FINE TEST DEI NODI INTERNI DI MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Verifica di multiset_scan() su array di lunghezza da 0 a 40
+
+	@description
+	La chiave cercata è posta in ogni posizione (e in una seconda posizione successiva),
+	così da coprire i blocchi interi e la coda dell'array.
+
+	@tparam T tipo aritmetico delle chiavi
+*/
+template <typename T>
+void check_scan() {
+	for(std::size_t n = 0; n <= 40; ++n) {
+		std::vector<T> keys(n + 1);
+		for(std::size_t i = 0; i < n; ++i)
+			keys[i] = static_cast<T>(i + 1);
+		assert(multiset_scan(keys.data(), n, static_cast<T>(0)) == n);
+		for(std::size_t i = 0; i < n; ++i) {
+			keys[n] = keys[i]; // Oltre la fine: non deve essere trovata
+			assert(multiset_scan(keys.data(), n, static_cast<T>(i + 1)) == i);
+			if(i + 3 < n) {
+				keys[i + 3] = keys[i];
+				assert(multiset_scan(keys.data(), n, static_cast<T>(i + 1)) == i);
+				keys[i + 3] = static_cast<T>(i + 4);
+			}
+		}
+	}
+}
+
+/**
+	@brief Test della ricerca vettoriale di chiavi aritmetiche
+
+	@description
+	Questa funzione globale verifica multiset_scan() per ogni tipo con una variante dedicata,
+	e FlatMultiSet con std::equal_to su int e double (NaN e zero con segno compresi).
+*/
+void test_multiset_scan() {
+	std::cout << "!!!### TEST DELLA RICERCA VETTORIALE DI CHIAVI ARITMETICHE ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "multiset_scan() su interi a 8, 32 e 64 bit, float e double" << std::endl;
+	std::cout << std::endl;
+	check_scan<char>();
+	check_scan<int>();
+	check_scan<unsigned int>();
+	check_scan<long long>();
+	check_scan<unsigned long>();
+	check_scan<float>();
+	check_scan<double>();
+	long long big[9] = {0, 1, 2, 3, 4, 5, 6, 7, 0x100000000LL}; // Stessa metà bassa di 0
+	assert(multiset_scan(big, 9, 0x100000000LL) == 8);
+	assert(multiset_scan(big + 1, 8, 0LL) == 8);
+
+	std::cout << "FlatMultiSet con std::equal_to" << std::endl;
+	std::cout << std::endl;
+	FlatMultiSet<int, std::equal_to<int>> fi;
+	msint li;
+	std::srand(17);
+	for(int i = 0; i < 5000; ++i) {
+		int v = std::rand() % 300 - 150;
+		fi.add(v);
+		li.add(v);
+	}
+	for(int v = -160; v < 160; ++v)
+		assert(fi.nocc(v) == li.nocc(v));
+	fi.remove(0, fi.nocc(0));
+	assert(!fi.contains(0) && fi.size() == li.size() - li.nocc(0));
+
+	FlatMultiSet<double, std::equal_to<double>> fd;
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	fd.add(0.0);
+	fd.add(-0.0);
+	fd.add(nan);
+	fd.add(nan);
+	for(int i = 0; i < 20; ++i)
+		fd.add(i * 0.5);
+	assert(fd.nocc(0.0) == 3 && fd.nocc(-0.0) == 3);
+	assert(fd.nocc(nan) == 0 && fd.distinct_size() == 22);
+	assert(fd.nocc(9.5) == 1 && fd.nocc(9.75) == 0);
+
+	std::cout << "!!!### FINE TEST DELLA RICERCA VETTORIALE DI CHIAVI ARITMETICHE ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test del riconoscimento dei funtori di uguaglianza
+
+	@description
+	Questa funzione globale verifica i trait multiset_plain_equal e multiset_bytewise_equal,
+	il confronto multiset_equal() che ne dipende, e le operazioni tra MultiSet senza hash
+	che ordinano i nodi per byte (oltre 32 elementi distinti), confrontate con le formule attese.
+*/
+void test_multiset_equal_traits() {
+	std::cout << "!!!### TEST DEL RICONOSCIMENTO DEI FUNTORI DI UGUAGLIANZA ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Trait e confronto multiset_equal()" << std::endl;
+	std::cout << std::endl;
+	assert((multiset_plain_equal<int, std::equal_to<int>>::value && multiset_bytewise_equal<int, std::equal_to<int>>::value));
+	assert((multiset_plain_equal<int, equal_int>::value && multiset_bytewise_equal<int, equal_int>::value));
+	assert((multiset_plain_equal<double, equal_double>::value && !multiset_bytewise_equal<double, equal_double>::value));
+	assert((multiset_plain_equal<std::string, equal_string>::value && !multiset_bytewise_equal<std::string, equal_string>::value));
+	assert((!multiset_plain_equal<point, equal_point>::value && multiset_bytewise_equal<point, equal_point>::value));
+	assert((!multiset_plain_equal<person, equal_person>::value && !multiset_bytewise_equal<person, equal_person>::value));
+	assert((!multiset_plain_equal<int, std::equal_to<long>>::value && multiset_key_scan<double, equal_double>::value));
+	assert(multiset_equal(equal_double(), 0.0, -0.0));
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	assert(!multiset_equal(equal_double(), nan, nan));
+	assert(multiset_equal(equal_point(), point(3, 4), point(3, 4)) && !multiset_equal(equal_point(), point(3, 4), point(4, 3)));
+	assert(multiset_equal(equal_string(), std::string("abc"), std::string("abc")));
+	assert(!multiset_equal(equal_string(), std::string("abc"), std::string("abd")));
+
+	std::cout << "Operazioni tra MultiSet di int senza hash, con i nodi ordinati per byte" << std::endl;
+	std::cout << std::endl;
+	msint a, b;
+	for(int i = 0; i < 300; ++i)
+		a.add(i, i % 5 + 1);
+	for(int i = 399; i >= 100; --i)
+		b.add(i, i % 7 + 1);
+	msint c(a);
+	assert(c == a && !(a == b));
+	c.remove(7);
+	c.add(7);
+	assert(c == a);
+	c.add(1000);
+	c.remove(1000);
+	c.add(-1);
+	c.remove(0, 1);
+	assert(!(c == a) && !(a == c));
+	msint i(a), d(a), d2(b);
+	i &= b;
+	d -= b;
+	d2 -= a;
+	for(int v = -5; v < 405; ++v) {
+		std::size_t na = a.nocc(v), nb = b.nocc(v);
+		assert(i.nocc(v) == std::min(na, nb));
+		assert(d.nocc(v) == (na > nb ? na - nb : 0));
+		assert(d2.nocc(v) == (nb > na ? nb - na : 0));
+	}
+	assert(i.size() + d.size() == a.size());
+	assert(a.includes(i) && b.includes(i) && !a.includes(b) && a.includes(d) && !i.includes(a));
+	msint u(i);
+	u += d;
+	assert(u == a && a == u);
+
+	std::cout << "Uguaglianza tra MultiSet di point con ordine di inserimento diverso" << std::endl;
+	std::cout << std::endl;
+	mspoint p1, p2;
+	for(int k = 0; k < 100; ++k) {
+		p1.add(point(k, -k), k % 3 + 1);
+		p2.add(point(99 - k, k - 99), (99 - k) % 3 + 1);
+	}
+	assert(p1 == p2 && p2.includes(p1));
+	p2.remove(point(50, -50));
+	assert(!(p1 == p2) && !p2.includes(p1) && p1.includes(p2));
+	p1 -= p2;
+	assert(p1.size() == 1 && p1.nocc(point(50, -50)) == 1);
+
+	std::cout << "!!!### FINE TEST DEL RICONOSCIMENTO DEI FUNTORI DI UGUAGLIANZA ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test delle ricerche con chiavi di tipo diverso da quello degli elementi
+
+	@description
+	Questa funzione globale verifica contains(), nocc() e remove() con funtori trasparenti:
+	stringhe C in MultiSet di std::string (con e senza hash), person_key, che non è
+	convertibile in person, in un MultiSet di person e coppie di interi in un MultiSet di point
+	senza hash, i cui nodi memorizzano l'hash dei byte dei valori.
+*/
+void test_multiset_transparent() {
+	std::cout << "!!!### TEST DELLE RICERCHE CON CHIAVI DI TIPO DIVERSO ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	assert((multiset_is_transparent<equal_string_key>::value && !multiset_is_transparent<equal_string>::value));
+	assert((multiset_is_transparent<multiset_no_hash>::value && !multiset_is_transparent<std::hash<std::string>>::value));
+
+	std::cout << "MultiSet di std::string senza hash, ricerca per const char*" << std::endl;
+	std::cout << std::endl;
+	mskstr ks;
+	ks.add("alfa", 3);
+	ks.add("beta");
+	ks.add(std::string("gamma"));
+	assert(ks.contains("alfa") && ks.nocc("alfa") == 3 && ks.nocc(std::string("alfa")) == 3);
+	assert(!ks.contains("delta") && ks.nocc("delta") == 0);
+	ks.remove("alfa");
+	ks.remove("gamma", 1);
+	assert(ks.nocc("alfa") == 2 && !ks.contains("gamma") && ks.size() == 3);
+	try {
+		ks.remove("beta", 2);
+		assert(false);
+	}
+	catch(const multiset_value_not_found &) {
+		assert(ks.nocc("beta") == 1 && ks.size() == 3);
+	}
+	try {
+		ks.remove("delta");
+		assert(false);
+	}
+	catch(const multiset_value_not_found &) {}
+	ks.remove("beta", 0);
+	assert(ks.size() == 3);
+
+	std::cout << "MultiSet di std::string con hash trasparente, ricerca per const char*" << std::endl;
+	std::cout << std::endl;
+	mshkstr hs;
+	char buf[16];
+	for(int i = 0; i < 1000; ++i) {
+		std::sprintf(buf, "k%d", i);
+		hs.add(std::string(buf), static_cast<std::size_t>(i % 4 + 1));
+	}
+	for(int i = 0; i < 1200; ++i) {
+		std::sprintf(buf, "k%d", i);
+		assert(hs.nocc(static_cast<const char*>(buf)) == (i < 1000 ? static_cast<std::size_t>(i % 4 + 1) : 0));
+		assert(hs.nocc(static_cast<const char*>(buf)) == hs.nocc(std::string(buf)));
+	}
+	for(int i = 0; i < 1000; i += 2) {
+		std::sprintf(buf, "k%d", i);
+		hs.remove(static_cast<const char*>(buf), static_cast<std::size_t>(i % 4 + 1));
+	}
+	assert(hs.distinct_size() == 500 && !hs.contains("k0") && hs.contains("k1"));
+
+	std::cout << "MultiSet di person, ricerca per person_key" << std::endl;
+	std::cout << std::endl;
+	mskperson kp;
+	kp.add(person("Mario", "Rossi", 30), 2);
+	kp.add(person("Maria", "Rossi", 30));
+	assert(kp.nocc(person_key("Mario", "Rossi", 30)) == 2 && kp.contains(person_key("Maria", "Rossi", 30)));
+	assert(!kp.contains(person_key("Mario", "Rossi", 31)) && kp.nocc(person("Maria", "Rossi", 30)) == 1);
+	kp.remove(person_key("Mario", "Rossi", 30), 2);
+	assert(kp.size() == 1 && kp.distinct_size() == 1);
+
+	std::cout << "MultiSet di point senza hash con confronto byte per byte, ricerca per coppia" << std::endl;
+	std::cout << std::endl;
+	mskpoint pp;
+	for(int i = 0; i < 50; ++i)
+		pp.add(point(i, -i), static_cast<std::size_t>(i % 3 + 1));
+	assert(pp.nocc(std::make_pair(7, -7)) == 2 && pp.nocc(point(7, -7)) == 2 && !pp.contains(std::make_pair(7, 7)));
+	pp.remove(std::make_pair(7, -7), 2);
+	assert(!pp.contains(point(7, -7)) && pp.distinct_size() == 49);
+
+	std::cout << "!!!### FINE TEST DELLE RICERCHE CON CHIAVI DI TIPO DIVERSO ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test della classe StringMultiSet
+
+	@description
+	Questa funzione globale verifica inserimenti, ricerche e rimozioni di chiavi (comprese
+	la stringa vuota, stringhe con caratteri nulli e più lunghe di un blocco dell'arena),
+	il confronto con un MultiSet di std::string con hash su molte chiavi, la stabilità dei
+	riferimenti alle chiavi, compact(), copia, spostamento e stampa.
+*/
+void test_string_multiset() {
+	std::cout << "!!!### TEST DELLA CLASSE STRINGMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Inserimenti, ricerche e rimozioni" << std::endl;
+	std::cout << std::endl;
+	StringMultiSet sm;
+	assert(sm.size() == 0 && sm.distinct_size() == 0 && !sm.contains("a") && sm.nocc("") == 0);
+	sm.add("alfa", 2);
+	sm.add(std::string("beta"));
+	sm.add("");
+	sm.add(std::string("a\0b", 3));
+	sm.add(multiset_string_ref("alfabeto", 4));
+	assert(sm.nocc("alfa") == 3 && sm.nocc("beta") == 1 && sm.nocc("") == 1);
+	assert(sm.nocc(std::string("a\0b", 3)) == 1 && sm.nocc("a") == 0 && sm.nocc(std::string("a\0c", 3)) == 0);
+	assert(sm.size() == 6 && sm.distinct_size() == 4);
+	sm.add("gamma", 0);
+	assert(!sm.contains("gamma") && sm.interned_size() == 4);
+	std::ostringstream os;
+	os << sm;
+	assert(os.str() == std::string("{<alfa, 3>, <beta, 1>, <, 1>, <a\0b, 1>}", 39));
+	try {
+		sm.remove("alfa", 4);
+		assert(false);
+	}
+	catch(const multiset_value_not_found &) {
+		assert(sm.nocc("alfa") == 3 && sm.size() == 6);
+	}
+	try {
+		sm.remove("gamma");
+		assert(false);
+	}
+	catch(const multiset_value_not_found &) {}
+
+	std::cout << "Chiavi scese a 0 occorrenze, stabilità dei riferimenti e compact()" << std::endl;
+	std::cout << std::endl;
+	const char *alfa = sm.distinct().begin().value().data;
+	sm.remove("alfa", 3);
+	assert(!sm.contains("alfa") && sm.distinct_size() == 3 && sm.interned_size() == 4 && sm.size() == 3);
+	StringMultiSet::distinct_iterator it = sm.distinct().begin();
+	assert(it.value() == multiset_string_ref("beta") && (*it).second == 1);
+	std::string big(100000, 'x');
+	sm.add(big, 5);
+	for(int i = 0; i < 20000; ++i)
+		sm.add(std::to_string(i));
+	assert(std::strcmp(alfa, "alfa") == 0); // I caratteri internati non sono stati spostati
+	sm.add("alfa");
+	assert(sm.nocc("alfa") == 1 && sm.interned_size() == 20005 && sm.nocc(big) == 5);
+	sm.remove("alfa");
+	for(int i = 0; i < 20000; i += 2)
+		sm.remove(std::to_string(i));
+	std::size_t before = sm.memory_usage();
+	StringMultiSet copy(sm);
+	sm.compact();
+	assert(sm.interned_size() == sm.distinct_size() && sm.distinct_size() == 10004);
+	assert(sm.memory_usage() < before && sm == copy && copy == sm);
+	for(int i = 0; i < 20000; ++i)
+		assert(sm.nocc(std::to_string(i)) == static_cast<std::size_t>(i % 2));
+	assert(sm.nocc(big) == 5 && sm.nocc("") == 1 && !sm.contains("alfa"));
+
+	std::cout << "Vettore di StringMultiSet: la crescita sposta le arene senza copiarle" << std::endl;
+	std::cout << std::endl;
+	assert(std::is_nothrow_move_constructible<StringMultiSet>::value && std::is_nothrow_move_assignable<StringMultiSet>::value);
+	std::vector<StringMultiSet> many(1);
+	many[0].add("chiave", 2);
+	const char *key = many[0].distinct().begin().value().data;
+	for(int i = 1; i < 100; ++i)
+		many.push_back(StringMultiSet());
+	assert(many[0].distinct().begin().value().data == key && many[0].nocc("chiave") == 2);
+
+	std::cout << "Confronto con un MultiSet di std::string con hash" << std::endl;
+	std::cout << std::endl;
+	StringMultiSet words;
+	mshstr ref;
+	std::srand(23);
+	for(int i = 0; i < 50000; ++i) {
+		std::string w(static_cast<std::size_t>(std::rand() % 24), 'a');
+		for(std::size_t j = 0; j < w.size(); ++j)
+			w[j] = static_cast<char>('a' + std::rand() % 3);
+		words.add(w);
+		ref.add(w);
+	}
+	assert(words.size() == ref.size() && words.distinct_size() == ref.distinct_size());
+	std::size_t total = 0;
+	StringMultiSet::distinct_range r = words.distinct();
+	for(StringMultiSet::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+		assert(ref.nocc(i.value().str()) == i.count());
+		total += i.count();
+	}
+	assert(total == words.size());
+	try {
+		StringMultiSet::distinct_iterator e = r.end();
+		++e;
+		assert(false);
+	}
+	catch(const multiset_iterator_out_of_bounds &) {}
+
+	std::cout << "Copia, spostamento, assegnamento e svuotamento" << std::endl;
+	std::cout << std::endl;
+	StringMultiSet a(words);
+	const char *first = a.distinct().begin().value().data;
+	StringMultiSet b(std::move(a));
+	assert(a.size() == 0 && a.distinct_size() == 0 && !a.contains(""));
+	assert(b == words && b.distinct().begin().value().data == first);
+	a.add("nuova");
+	a = b;
+	assert(a == b && !a.contains("nuova"));
+	b.add("nuova");
+	assert(!(a == b));
+	b.clear();
+	assert(b.size() == 0 && b.memory_usage() == 0 && !(a == b));
+	b.add("nuova", 2);
+	assert(b.nocc("nuova") == 2);
+
+	std::cout << "!!!### FINE TEST DELLA CLASSE STRINGMULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
+/**
+	@brief Test del formato binario e della classe MappedMultiSet
+
+	@description
+	Questa funzione globale verifica la scrittura e la rilettura in formato binario di MultiSet
+	di interi (con e senza hash, con occorrenze oltre i 32 bit), point, person e MultiSet
+	annidati, più MultiSet sullo stesso stream, i limiti dei codec degli interi, il rifiuto
+	di dati troncati o corrotti e le ricerche di MappedMultiSet su file e in memoria, con e
+	senza indice.
+*/
+void test_multiset_binary() {
+	std::cout << "!!!### TEST DEL FORMATO BINARIO DEL MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+
+	std::cout << "Scrittura e lettura di MultiSet di int con e senza hash" << std::endl;
+	std::cout << std::endl;
+	mshint h;
+	std::srand(29);
+	for(int i = 0; i < 20000; ++i)
+		h.add(std::rand() % 5000 - 2500);
+	h.add(7, static_cast<mshint::size_type>(1) << 40);
+	std::ostringstream bin;
+	multiset_write(bin, h);
+	mshint h2;
+	h2.add(99999);
+	std::istringstream in(bin.str());
+	multiset_read(in, h2);
+	assert(h2 == h && h2.size() == h.size() && !h2.contains(99999));
+	msint plain; // Stesso codec, funtori diversi
+	std::istringstream in2(bin.str());
+	multiset_read(in2, plain);
+	assert(plain.size() == h.size() && plain.distinct_size() == h.distinct_size());
+	assert(plain.nocc(7) == h.nocc(7) && plain.nocc(-2500) == h.nocc(-2500));
+	std::ostringstream bin_plain; // Senza hash non è scritto l'indice
+	multiset_write(bin_plain, plain);
+	std::ostringstream text;
+	text << plain;
+	assert(bin_plain.str().size() * 2 < text.str().size());
+	mshint empty;
+	std::ostringstream bin_empty;
+	multiset_write(bin_empty, empty);
+	assert(bin_empty.str().size() == multiset_binary_format::header_size);
+	std::istringstream in_empty(bin_empty.str());
+	multiset_read(in_empty, h2);
+	assert(h2.size() == 0 && h2.distinct_size() == 0);
+
+	std::cout << "Codec di point, person e MultiSet annidati, più MultiSet sullo stesso stream" << std::endl;
+	std::cout << std::endl;
+	mspoint mp;
+	mp.add(point(0, 0), 3);
+	mp.add(point(-1, 1));
+	mp.add(point(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()), 2);
+	msperson mpe;
+	mpe.add(person("Mario", "Rossi", 30), 2);
+	mpe.add(person("", "", 0));
+	mpe.add(person(std::string("A\0B", 3), "Bianchi", 4000000000u));
+	ms_mspoint nested;
+	nested.add(mp, 2);
+	nested.add(MultiSet<point, equal_point>());
+	ms_mshint nested_hash;
+	nested_hash.add(h);
+	nested_hash.add(mshint(), 4);
+	std::ostringstream many;
+	multiset_write(many, mp);
+	multiset_write(many, mpe);
+	multiset_write(many, nested);
+	multiset_write(many, nested_hash);
+	std::istringstream in_many(many.str());
+	mspoint mp2;
+	msperson mpe2;
+	ms_mspoint nested2;
+	ms_mshint nested_hash2;
+	multiset_read(in_many, mp2);
+	multiset_read(in_many, mpe2);
+	multiset_read(in_many, nested2);
+	multiset_read(in_many, nested_hash2);
+	assert(mp2 == mp && mpe2 == mpe && nested2 == nested && nested_hash2 == nested_hash);
+	assert(in_many.peek() == std::char_traits<char>::eof());
+
+	std::cout << "Limiti dei codec degli interi" << std::endl;
+	std::cout << std::endl;
+	MultiSet<long long, std::equal_to<long long>> ll;
+	ll.add(std::numeric_limits<long long>::min());
+	ll.add(std::numeric_limits<long long>::max());
+	ll.add(-1);
+	std::ostringstream bin_ll;
+	multiset_write(bin_ll, ll);
+	MultiSet<long long, std::equal_to<long long>> ll2;
+	std::istringstream in_ll(bin_ll.str());
+	multiset_read(in_ll, ll2);
+	assert(ll2 == ll);
+	MultiSet<short, std::equal_to<short>> sh; // -1 entra in uno short, i limiti di long long no
+	std::istringstream in_sh(bin_ll.str());
+	try {
+		multiset_read(in_sh, sh);
+		assert(false);
+	}
+	catch(const multiset_bad_format &) {
+		assert(sh.size() == 0);
+	}
+
+	std::cout << "Dati troncati o corrotti" << std::endl;
+	std::cout << std::endl;
+	const std::string data = bin.str();
+	for(std::size_t cut = 0; cut < 200; cut += 7) {
+		std::istringstream truncated(data.substr(0, cut));
+		try {
+			multiset_read(truncated, h2);
+			assert(false);
+		}
+		catch(const multiset_bad_format &) {}
+		catch(const multiset_io_error &) {
+			assert(cut < multiset_binary_format::header_size);
+		}
+		assert(h2.size() == 0);
+	}
+	std::string corrupt = data;
+	corrupt[0] = 'X';
+	try {
+		MappedMultiSet<int, equal_int, std::hash<int>> v(corrupt.data(), corrupt.size());
+		assert(false);
+	}
+	catch(const multiset_bad_format &) {}
+	try {
+		MappedMultiSet<int, equal_int> v("file_inesistente.bin");
+		assert(false);
+	}
+	catch(const multiset_io_error &) {}
+
+	std::cout << "Ricerche di MappedMultiSet su file e in memoria" << std::endl;
+	std::cout << std::endl;
+	const char *path = "multiset_test.bin";
+	{
+		std::ofstream out(path, std::ios::binary);
+		multiset_write(out, h);
+	}
+	{
+		MappedMultiSet<int, equal_int, std::hash<int>> v(path);
+		assert(v.indexed() && v.size() == h.size() && v.distinct_size() == h.distinct_size());
+		for(int i = -3000; i < 3000; ++i)
+			assert(v.nocc(i) == h.nocc(i) && v.contains(i) == h.contains(i));
+		assert(v.nocc(7) == h.nocc(7));
+		MappedMultiSet<int, equal_int, std::hash<int>> moved(std::move(v));
+		assert(moved.nocc(7) == h.nocc(7) && v.size() == 0 && !v.contains(7));
+		MappedMultiSet<int, equal_int> scan(path); // Senza funtore di hash l'indice non è usato
+		assert(!scan.indexed() && scan.nocc(-2500) == h.nocc(-2500) && scan.nocc(2500) == 0);
+	}
+	std::remove(path);
+	const std::string pdata = many.str(); // La vista inizia dal primo MultiSet dello stream
+	MappedMultiSet<point, equal_point> vp(pdata.data(), pdata.size());
+	assert(!vp.indexed() && vp.nocc(point(0, 0)) == 3 && vp.nocc(point(-1, 1)) == 1 && !vp.contains(point(1, -1)));
+	mshkstr ks;
+	ks.add("uno");
+	ks.add("due", 2);
+	std::ostringstream bin_ks;
+	multiset_write(bin_ks, ks);
+	const std::string kdata = bin_ks.str();
+	MappedMultiSet<std::string, equal_string_key, hash_string_key> vk(kdata.data(), kdata.size());
+	assert(vk.indexed() && vk.nocc("due") == 2 && vk.nocc("tre") == 0);
+	try {
+		MappedMultiSet<std::string, equal_string, std::hash<std::string>> wrong(kdata.data(), kdata.size());
+		assert(false); // Funtore di hash diverso da quello usato in scrittura
+	}
+	catch(const multiset_bad_format &) {}
+	std::ostringstream bin_nested;
+	multiset_write(bin_nested, nested_hash);
+	const std::string ndata = bin_nested.str();
+	MappedMultiSet<mshint, std::equal_to<mshint>, multiset_hash> vn(ndata.data(), ndata.size());
+	mshint one;
+	one.add(1);
+	assert(vn.indexed() && vn.nocc(h) == 1 && vn.nocc(mshint()) == 4 && !vn.contains(one));
+
+	std::cout << "!!!### FINE TEST DEL FORMATO BINARIO DEL MULTISET ###!!!" << std::endl;
+	std::cout << std::endl;
+}
+
 int main () {
 
 	test_multiset_int();
@@ -1712,6 +4197,30 @@ int main () {
 	test_multiset_point();
 	test_multiset_person();
 	test_multiset_multiset_point();
+	test_multiset_hash();
+	test_ordered_multiset();
+	test_multiset_clear();
+	test_multiset_pool();
+	test_multiset_move();
+	test_multiset_bulk();
+	test_multiset_copy();
+	test_multiset_counts();
+	test_multiset_algebra();
+	test_multiset_fingerprint();
+	test_multiset_distinct();
+	test_flat_multiset();
+	test_multiset_sampler();
+	test_multiset_top_k();
+	test_approx_multiset();
+	test_concurrent_multiset();
+	test_multiset_parallel_build();
+	test_snapshot_multiset();
+	test_multiset_inline();
+	test_multiset_scan();
+	test_multiset_equal_traits();
+	test_multiset_transparent();
+	test_string_multiset();
+	test_multiset_binary();
 
 	return 0;
 }
@@ -3,6 +3,11 @@
 
 	@brief Dichiarazione e definizione di una classe templata MultiSet,
 	con ridefinizione dell'operatore di stream << per oggetti MultiSet.
+
+	@description
+	Definendo la macro MULTISET_NO_ITERATOR_CHECKS prima dell'inclusione, gli operatori di
+	incremento degli iteratori non verificano di essere interni al MultiSet: incrementare
+	end() ha allora comportamento indefinito invece di lanciare multiset_iterator_out_of_bounds.
 */
 
 // Guardie
@@ -13,29 +18,361 @@
 // Direttive pre-compilatore
 
 #include <ostream> // std::ostream
-#include <algorithm> //std::swap
+#include <algorithm> //std::swap, std::sort, std::lower_bound
+#include <cstring> // std::memcmp
 #include <iterator> // std::forward_iterator_tag
-#include <cstddef> // std::ptrdiff_t
-#include "multiset_exceptions.h" // multiset_iterator_out_of_bounds, multiset_value_not_found
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <memory> // std::allocator, std::allocator_traits
+#include <limits> // std::numeric_limits
+#include <type_traits> // std::is_trivially_destructible, std::integral_constant, std::enable_if
+#include <utility> // std::move, std::forward, std::pair
+#include <functional> // std::less
+#include <set> // std::set
+#include <vector> // std::vector
+#include <new> // std::bad_alloc
+#include "multiset_equal.h" // multiset_equal, multiset_bytewise_equal, multiset_bytewise_less, multiset_bytewise_hash
+#include "multiset_exceptions.h" // multiset_iterator_out_of_bounds, multiset_value_not_found, multiset_count_overflow
+#include "multiset_pool.h" // multiset_pool_traits
+
+/**
+	@brief Funtore di hash nullo
+
+	@description
+	Funtore usato come valore di default del parametro di hash del MultiSet.
+	Indica che il tipo degli elementi non dispone di una funzione di hash: in questo
+	caso il MultiSet è rappresentato da un'unica linked list, scandita tramite il solo
+	funtore di uguaglianza.
+*/
+struct multiset_no_hash {
+	typedef void is_transparent; ///< Accetta qualsiasi tipo di chiave
+
+	template <typename U>
+	std::size_t operator()(const U &) const {
+		return 0;
+	}
+};
+
+/**
+	@brief Trait che stabilisce se un funtore di hash è effettivamente utilizzabile
+
+	@tparam H funtore di hash
+
+	@description
+	Il valore è true per ogni funtore, tranne che per multiset_no_hash.
+*/
+template <typename H>
+struct multiset_is_hashed {
+	static const bool value = true;
+};
+
+/**
+	@brief Specializzazione del trait per il funtore di hash nullo
+*/
+template <>
+struct multiset_is_hashed<multiset_no_hash> {
+	static const bool value = false;
+};
+
+/**
+	@brief Tipo usato per rilevare un typedef membro tramite SFINAE
+
+	@tparam U tipo del typedef membro
+*/
+template <typename U>
+struct multiset_void {
+	typedef void type;
+};
+
+/**
+	@brief Trait che stabilisce se un funtore è trasparente
+
+	@description
+	Il valore è true se il funtore dichiara il tipo membro is_transparent, come
+	std::equal_to<> e std::less<>: il funtore accetta allora chiavi di tipo diverso da
+	quello degli elementi, e le ricerche non richiedono di costruire un elemento.
+
+	@tparam F funtore
+*/
+template <typename F, typename = void>
+struct multiset_is_transparent : std::false_type {};
+
+/**
+	@brief Specializzazione del trait per i funtori che dichiarano is_transparent
+*/
+template <typename F>
+struct multiset_is_transparent<F, typename multiset_void<typename F::is_transparent>::type> : std::true_type {};
+
+/**
+	@brief Tipo del segnaposto che indica una sequenza di input ordinata
+
+	@description
+	Passato al costruttore da sequenza o ad add(first, last), indica che gli elementi
+	uguali della sequenza sono tra loro adiacenti (come in una sequenza ordinata).
+*/
+struct multiset_sorted_input_t {};
+
+/**
+	@brief Segnaposto che indica una sequenza di input ordinata
+*/
+const multiset_sorted_input_t multiset_sorted_input = multiset_sorted_input_t();
+
+/**
+	@brief Rimescolamento dei bit di un valore di hash
+
+	@description
+	Molti funtori di hash (ad esempio std::hash<int>) restituiscono il valore stesso.
+	Poiché il MultiSet seleziona il bucket tramite i bit meno significativi, il valore
+	viene rimescolato con il finalizzatore a 64 bit di MurmurHash3.
+
+	@param h valore di hash da rimescolare
+
+	@return valore di hash rimescolato
+*/
+inline std::size_t multiset_mix(std::size_t h) {
+	unsigned long long x = h;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+	return static_cast<std::size_t>(x);
+}
+
+/**
+	@brief Posizioni per nodi interne ad un MultiSet
+
+	@description
+	Memoria non inizializzata per N nodi, contenuta nell'oggetto stesso, con una maschera
+	delle posizioni occupate. La costruzione e la distruzione dei nodi sono lasciate al MultiSet.
+
+	@tparam Node tipo dei nodi
+	@tparam N numero di posizioni (al massimo 64)
+*/
+template <typename Node, std::size_t N>
+class multiset_inline_nodes {
+
+	static_assert(N <= 64, "multiset_inline_nodes: al massimo 64 posizioni");
+
+	typename std::aligned_storage<sizeof(Node), alignof(Node)>::type _slots[N]; ///< Memoria delle posizioni
+	unsigned long long _mask; ///< Bit i a 1 se la posizione i è occupata
+	std::size_t _used; ///< Numero di posizioni occupate
+
+public:
+
+	/**
+		@brief Costruttore di default, con tutte le posizioni libere
+	*/
+	multiset_inline_nodes() : _mask(0), _used(0) {}
+
+	multiset_inline_nodes(const multiset_inline_nodes &other) = delete; // I nodi non possono essere copiati byte per byte
+	multiset_inline_nodes& operator=(const multiset_inline_nodes &other) = delete; // Non assegnabile
+
+	/**
+		@brief Occupazione di una posizione libera
+
+		@return puntatore alla memoria della posizione, nullptr se sono tutte occupate
+	*/
+	Node* acquire() {
+		if(_used == N)
+			return nullptr;
+		std::size_t i = 0;
+		while(_mask >> i & 1)
+			++i;
+		return take(i);
+	}
+
+	/**
+		@brief Occupazione di una posizione data
+
+		@pre La posizione i è libera
+
+		@param i indice della posizione
+
+		@return puntatore alla memoria della posizione
+	*/
+	Node* take(std::size_t i) {
+		_mask |= 1ULL << i;
+		_used++;
+		return slot(i);
+	}
+
+	/**
+		@brief Liberazione di una posizione (il nodo è già stato distrutto)
+
+		@param n nodo contenuto nella posizione
+	*/
+	void release(const Node *n) {
+		_mask &= ~(1ULL << index(n));
+		_used--;
+	}
+
+	/**
+		@brief Liberazione di tutte le posizioni (i nodi sono già stati distrutti)
+	*/
+	void reset() {
+		_mask = 0;
+		_used = 0;
+	}
+
+	/**
+		@brief Verifica che un nodo si trovi in una delle posizioni
+
+		@param n nodo da verificare
+
+		@return true se n è contenuto in una posizione, libera od occupata
+	*/
+	bool owns(const Node *n) const {
+		const char *p = reinterpret_cast<const char*>(n);
+		const char *base = reinterpret_cast<const char*>(_slots);
+		return !std::less<const char*>()(p, base) && std::less<const char*>()(p, base + sizeof(_slots));
+	}
+
+	/**
+		@brief Stato di una posizione
+
+		@param i indice della posizione
+
+		@return true se la posizione i è occupata
+	*/
+	bool in_use(std::size_t i) const {
+		return (_mask >> i & 1) != 0;
+	}
+
+	/**
+		@brief Numero di posizioni occupate
+
+		@return numero di nodi contenuti
+	*/
+	std::size_t used() const {
+		return _used;
+	}
+
+	/**
+		@brief Memoria di una posizione
+
+		@param i indice della posizione
+
+		@return puntatore alla memoria della posizione i
+	*/
+	Node* slot(std::size_t i) {
+		return reinterpret_cast<Node*>(&_slots[i]);
+	}
+
+	/**
+		@brief Indice della posizione di un nodo
+
+		@pre owns(n) è true
+
+		@param n nodo contenuto in una posizione
+
+		@return indice della posizione di n
+	*/
+	std::size_t index(const Node *n) const {
+		return (reinterpret_cast<const char*>(n) - reinterpret_cast<const char*>(_slots)) / sizeof(_slots[0]);
+	}
+};
+
+/**
+	@brief Specializzazione senza posizioni interne
+
+	@description
+	Tutti i nodi sono ottenuti dall'allocatore. La classe è vuota, quindi non aumenta
+	la dimensione del MultiSet.
+*/
+template <typename Node>
+class multiset_inline_nodes<Node, 0> {
+
+public:
+
+	Node* acquire() {
+		return nullptr;
+	}
+
+	Node* take(std::size_t) {
+		return nullptr;
+	}
+
+	void release(const Node *) {}
+
+	void reset() {}
+
+	bool owns(const Node *) const {
+		return false;
+	}
+
+	bool in_use(std::size_t) const {
+		return false;
+	}
+
+	std::size_t used() const {
+		return 0;
+	}
+
+	Node* slot(std::size_t) {
+		return nullptr;
+	}
+
+	std::size_t index(const Node *) const {
+		return 0;
+	}
+};
+
+/**
+	@brief Accesso ai nodi di un MultiSet per le estensioni che li collegano direttamente,
+	definito dopo la classe MultiSet
+*/
+struct multiset_access;
 
 /**
-	@brief MultiSet templato su due parametri
+	@brief MultiSet templato su tre parametri
+
+	@description
+	Se il funtore di hash H non è specificato, il MultiSet è una linked list e le
+	operazioni di ricerca hanno costo lineare nel numero di elementi distinti.
+	Se invece H è specificato, i nodi sono distribuiti in un array di bucket (ciascuno
+	una linked list) e ricerca, inserimento e rimozione hanno costo atteso costante.
+	Se N è maggiore di 0, l'oggetto MultiSet contiene spazio per N nodi: finché gli elementi
+	distinti sono al più N i nodi vi sono costruiti senza richiedere memoria all'allocatore. Al
+	primo elemento distinto oltre N tutti i nodi sono spostati nella memoria dell'allocatore, che
+	viene poi usata fino a quando il MultiSet non torna vuoto. Lo spostamento e lo scambio di
+	MultiSet con nodi interni spostano i valori dei nodi, quindi costano O(N) invece di O(1).
+	Se E equivale ad operator== o al confronto byte per byte (vedi multiset_equal.h), le
+	ricerche non invocano il funtore; senza funtore di hash e con il confronto byte per byte,
+	uguaglianza, inclusione, intersezione e differenza ordinano i nodi di uno dei due MultiSet
+	per cercarli in O(log d) invece di scandire la lista, ed ogni nodo memorizza un hash dei
+	byte del valore, usato per l'impronta (vedi fingerprint()).
+	Se E (ed H, se specificato) dichiarano il tipo membro is_transparent, contains(), nocc() e
+	remove() accettano anche chiavi di tipo diverso da T, senza costruire un elemento.
 
 	@tparam T tipo degli elementi di un MultiSet
 	@tparam E funtore di uguaglianza tra elementi del MultiSet
+	@tparam H funtore di hash degli elementi, coerente con E (opzionale)
+	@tparam A allocatore compatibile con gli allocatori standard, usato per i nodi e per
+	l'array dei bucket (opzionale, ad esempio multiset_pool_allocator)
+	@tparam N numero di nodi contenuti nell'oggetto MultiSet (opzionale, al massimo 64)
 */
-template <typename T, typename E>
+template <typename T, typename E, typename H = multiset_no_hash, typename A = std::allocator<T>, std::size_t N = 0>
 class MultiSet {
 
+	static_assert(N == 0 || std::is_nothrow_move_constructible<T>::value,
+		"MultiSet: i nodi interni richiedono un costruttore di spostamento noexcept");
+
 	// Sezione privata della classe
 
+	/**
+		Tipo vuoto usato per selezionare il costruttore di un nodo che costruisce il valore sul posto
+	*/
+	struct emplace_tag {};
+
 	/**
 		Struct che implementa un nodo di una linked list (struttura dati scelta per
-		rappresentare internamente il MultiSet)
+		rappresentare internamente il MultiSet). Con un funtore di hash, ogni bucket
+		è a sua volta una linked list di nodi.
 	*/
 	struct node {
-		const T value; ///< Valore dell'elemento nel nodo
-		unsigned int nocc; ///< Numero di volte in cui un valore compare nel MultiSet
+		T value; ///< Valore dell'elemento nel nodo (spostato se il nodo lascia le posizioni interne)
+		std::size_t nocc; ///< Numero di volte in cui un valore compare nel MultiSet
+		std::size_t hash; ///< Hash rimescolato del valore (vedi hash_of())
 		node *next; ///< Puntatore al nodo successivo
 
 		/**
@@ -44,7 +381,7 @@ class MultiSet {
 			@description
 			Questo metodo crea un nodo vuoto, con puntatore next a nullptr.
 		*/
-		node() : next(nullptr) {}
+		node() : hash(0), next(nullptr) {}
 
 		/**
 			@brief Costruttore secondario per un nodo
@@ -57,7 +394,7 @@ class MultiSet {
 
 			@param v reference costante al valore dell'elemento di un nodo
 		*/
-		explicit node(const T &v) : value(v), nocc(1), next(nullptr) {}
+		explicit node(const T &v) : value(v), nocc(1), hash(0), next(nullptr) {}
 
 		/**
 			@brief Costruttore secondario per un nodo
@@ -69,7 +406,38 @@ class MultiSet {
 			@param v reference costante al valore dell'elemento di un nodo
 			@param n puntatore al nodo successivo
 		*/
-		node(const T &v, node *n) : value(v), nocc(1), next(n) {}
+		node(const T &v, node *n) : value(v), nocc(1), hash(0), next(n) {}
+
+		/**
+			@brief Costruttore secondario per un nodo
+
+			@description
+			Questo metodo crea un nodo, con valore specificato v, hash h già calcolato
+			e puntatore al nodo successivo determinato da n.
+
+			@param v reference costante al valore dell'elemento di un nodo
+			@param h hash rimescolato del valore
+			@param n puntatore al nodo successivo
+		*/
+		node(const T &v, std::size_t h, node *n) : value(v), nocc(1), hash(h), next(n) {}
+
+		/**
+			@brief Costruttore di un nodo con valore costruito sul posto
+
+			@description
+			Il valore è costruito direttamente nel nodo, inoltrando gli argomenti
+			args al costruttore di T (nessuna copia né spostamento del valore).
+			Il primo parametro distingue questo costruttore dai precedenti.
+
+			@tparam Args tipi degli argomenti del costruttore di T
+
+			@param h hash rimescolato del valore
+			@param n puntatore al nodo successivo
+			@param args argomenti del costruttore di T
+		*/
+		template <typename... Args>
+		node(emplace_tag, std::size_t h, node *n, Args&&... args) : value(std::forward<Args>(args)...),
+			nocc(1), hash(h), next(n) {}
 
 		/**
 			@brief Distruttore per un nodo
@@ -84,402 +452,2315 @@ class MultiSet {
 
 	}; //struct node
 
-	// Altri dati membro privati
-
-	node *_head; ///< Puntatore al primo nodo della lista
-	unsigned int _size; ///< Numero totale di elementi nella lista
+	// Tipi privati
 
-	E _eql; ///< Istanza del funtore di uguaglianza
+	typedef typename std::allocator_traits<A>::template rebind_alloc<node> node_allocator; ///< Allocatore dei nodi
+	typedef std::allocator_traits<node_allocator> node_traits; ///< Traits dell'allocatore dei nodi
+	typedef typename std::allocator_traits<A>::template rebind_alloc<node*> bucket_allocator; ///< Allocatore dei bucket
+	typedef std::allocator_traits<bucket_allocator> bucket_traits; ///< Traits dell'allocatore dei bucket
+	typedef std::pair<std::size_t, const node*> top_entry; ///< Voce dell'indice dei valori più frequenti
 
-	// Altri metodi privati
+	/**
+		Ordinamento dell'indice dei valori più frequenti: numero di occorrenze decrescente,
+		a parità di occorrenze per indirizzo del nodo
+	*/
+	struct top_order {
+		bool operator()(const top_entry &a, const top_entry &b) const {
+			if(a.first != b.first)
+				return a.first > b.first;
+			return std::less<const node*>()(a.second, b.second);
+		}
+	};
 
 	/**
-		@brief Metodo di rimozione contenuto del MultiSet
+		Indice dei valori più frequenti. Le voci sono allocate in un pool proprio dell'indice:
+		l'erase e l'insert di un aggiornamento riutilizzano la stessa cella tramite la free list,
+		senza richieste al sistema.
+	*/
+	typedef std::set<top_entry, top_order, multiset_pool_allocator<top_entry>> top_index;
+	typedef multiset_inline_nodes<node, N> inline_nodes; ///< Posizioni dei nodi interni
 
-		@description
-		Metodo privato che rimuove tutto il contenuto di un MultiSet.
-		Si appoggia ad un altro metodo privato, richiamato sul nodo di testa.
+	friend struct multiset_access; // Unico accesso ai dati interni, per le estensioni (vedi multiset_access)
+
+	// Costanti private
 
-		@post La memoria allocata per il MultiSet è deallocata
+	static const bool hashed = multiset_is_hashed<H>::value; ///< True se il MultiSet usa il funtore di hash
+	static const std::size_t min_buckets = 16; ///< Numero di bucket allocati al primo rehash
+	static const std::size_t index_min = 32; ///< Elementi distinti oltre i quali le operazioni tra MultiSet senza hash ordinano i nodi
+
+	typedef std::integral_constant<bool, !hashed && multiset_bytewise_equal<T,E>::value> indexed; ///< True se i nodi possono essere ordinati per byte
+	typedef std::vector<const node*> node_index; ///< Nodi ordinati per byte
+
+	/**
+		Trait che stabilisce se l'hash di una chiave di tipo K è calcolato dai suoi byte: vale
+		per i MultiSet senza hash con il confronto byte per byte, solo per K uguale a T
 	*/
-	void clear() {
-		clear_helper(_head);
-		_head = nullptr;
-	}
+	template <typename K>
+	struct byte_hashed : std::integral_constant<bool, indexed::value && std::is_same<K,T>::value> {};
 
 	/**
-		@brief Metodo ausiliario ricorsivo di rimozione degli elementi
+		Trait che abilita le ricerche con una chiave di tipo K diverso da T: E (e H, se usato)
+		devono essere trasparenti
+	*/
+	template <typename K>
+	struct key_lookup : std::integral_constant<bool, !std::is_same<K,T>::value &&
+		multiset_is_transparent<E>::value && multiset_is_transparent<H>::value> {};
 
-		@description
-		Metodo privato ausiliario che, in modo ricorsivo, si occupa di eliminare ogni nodo
-		della lista che rappresenta il MultiSet. Tramite la ricorsione, la funzione elimina i nodi
-		successivi a quello passato come parametro.
+	// Altri dati membro privati
 
-		@param curr puntatore all'elemento da cui iniziare la rimozione degli elementi
+	node *_head; ///< Puntatore al primo nodo della lista (usato finché non sono allocati i bucket)
+	node **_buckets; ///< Array dei bucket, nullptr se il MultiSet è una lista semplice
+	std::size_t _nbuckets; ///< Numero di bucket (0 oppure una potenza di 2)
+	std::size_t _distinct; ///< Numero di elementi distinti (ovvero di nodi)
+	std::size_t _size; ///< Numero totale di elementi nella lista
+	std::size_t _fp; ///< Impronta del contenuto, indipendente dall'ordine (vedi fingerprint())
+	top_index *_top; ///< Indice dei valori più frequenti, nullptr se non attivo (vedi enable_top_index())
+	inline_nodes _inline; ///< Nodi interni (se ve n'è almeno uno, tutti i nodi sono interni)
 
-		@post Il puntatore a curr si riferisce ad una locazione di memoria non più valida
-		@post Il numero di elementi nel MultiSet è ridotto tenendo conto delle occorrenze di quelli eliminati
-		@post La memoria allocata per gli elementi a partire da curr è deallocata
-	*/
-	void clear_helper(node *curr) {
-		if (curr == nullptr)
-			return;
-		clear_helper(curr->next);
-		_size = _size - curr->nocc;
-		delete curr;
-		curr = nullptr;
-	}
+	E _eql; ///< Istanza del funtore di uguaglianza
+	H _hash; ///< Istanza del funtore di hash
+	node_allocator _alloc; ///< Istanza dell'allocatore dei nodi
+
+	// Altri metodi privati
 
 	/**
-		@brief Variante di ricerca di un elemento nel MultiSet
+		@brief Metodo ausiliario iterativo di rimozione degli elementi
 
 		@description
-		Questo metodo è una variante del metodo contains(). La logica è la medesima, ma
-		cambia il valore di ritorno. Metodo privato utilizzato negli altri metodi.
+		Metodo privato ausiliario che si occupa di eliminare ogni nodo della lista che
+		rappresenta il MultiSet, a partire da quello passato come parametro.
+		La lista è scorsa in modo iterativo, salvando il successivo di ogni nodo prima di
+		eliminarlo: il costo è lineare e l'uso dello stack è costante, indipendentemente
+		dalla lunghezza della lista.
 
-		@param v elemento da cercare nel MultiSet
+		I nodi interni non sono deallocati: le loro posizioni sono liberate da clear().
 
-		@return puntatore al nodo contenente l'elemento cercato, se presente, nullptr altrimenti
-	*/
-	node* contains_at(const T &v) const {
-		node *curr = _head;
+		@param curr puntatore all'elemento da cui iniziare la rimozione degli elementi
+		@param dealloc false se la memoria dei nodi sarà rilasciata in blocco dal pool,
+		true se ogni nodo va deallocato
 
+		@post Il puntatore a curr si riferisce ad una locazione di memoria non più valida
+		@post Il numero di elementi nel MultiSet è ridotto tenendo conto delle occorrenze di quelli eliminati
+		@post La memoria allocata per gli elementi a partire da curr è deallocata (se dealloc è true)
+	*/
+	void clear_helper(node *curr, bool dealloc) {
 		while(curr != nullptr) {
-			if(_eql(curr->value, v))
-				return curr;
-			curr = curr->next;
+			node *tmp = curr->next;
+			_size = _size - curr->nocc;
+			node_traits::destroy(_alloc, curr);
+			if(dealloc && !_inline.owns(curr))
+				node_traits::deallocate(_alloc, curr, 1);
+			curr = tmp;
 		}
-		return nullptr;
 	}
 
 	/**
-		@brief Metodo ausiliario di rimozione elemento dal MultiSet
+		@brief Memoria per un nuovo nodo
 
 		@description
-		Questo metodo viene richiamato da remove() e, tramite l'uso dei puntatori, elimina un elemento
-		dal MultiSet.
-		Se l'elemento da eliminare è la testa della lista, allora la nuova testa sarà l'elemento successivo a quello
-		che faceva da testa. Il nodo testa precedente viene eliminato.
-		Altrimenti, si scorre la lista dall'inizio fino a quando non viene trovato il nodo precedente a quello da eliminare.
-		Tramite l'uso dei puntatori, il nodo da eliminare viene "scollegato" sia dal precedente sia dal successivo. Il next del
-		nodo precedente diviene quindi il next del nodo da eliminare. Il nodo da eliminare è eliminato.
+		Il nodo occupa una posizione interna solo se tutti i nodi esistenti sono interni e, con
+		il nuovo nodo, gli elementi distinti saranno al più N; altrimenti la memoria è richiesta
+		all'allocatore.
 
-		@param curr nodo da eliminare
+		@param distinct numero di elementi distinti previsto dopo l'inserimento del nodo
 
-		@post Il puntatore della testa viene eventualmente aggiornato al nodo che le faceva da successivo
-		@post Il nodo precedente ed il successivo rispetto al nodo da eliminare vengono collegati tra di loro,
-		attraverso i puntatori
-		@post Il nodo da eliminare viene distrutto e la sua locazione di memoria viene deallocata
+		@return memoria non inizializzata per un nodo
+
+		@throw Eccezione di allocazione di memoria
 	*/
-	void remove_helper(node *curr) {
-		node *tmp = curr;
-		if(tmp == _head) {
-			_head = _head->next;
-			delete tmp;
-			tmp = nullptr;
-		}
-		else {
-			tmp = _head;
-			while(tmp->next != curr)
-				tmp = tmp->next;
-			tmp->next = curr->next;
-			delete curr;
-			curr = nullptr;
+	node* allocate_node(std::size_t distinct) {
+		if(distinct <= N && _inline.used() == _distinct) {
+			node *n = _inline.acquire();
+			if(n != nullptr)
+				return n;
 		}
+		return node_traits::allocate(_alloc, 1);
 	}
 
-public:
-	
-	// Sezione pubblica della classe
-
-	// Metodi pubblici fondamentali
-
 	/**
-		@brief Costruttore di default per MultiSet
+		@brief Restituzione della memoria di un nodo già distrutto
 
-		@description
-		Questo metodo istanzia un MultiSet vuoto, tramite initialization list.
-		Il puntatore alla testa della lista, che rappresenta il MultiSet, è inizializzato
-		a nullptr. La dimensione del MultiSet è 0.
+		@param n nodo distrutto
+
+		@post La posizione interna di n è liberata, o la sua memoria è restituita all'allocatore
 	*/
-	MultiSet() : _head(nullptr), _size(0) {}
+	void deallocate_node(node *n) {
+		if(_inline.owns(n))
+			_inline.release(n);
+		else
+			node_traits::deallocate(_alloc, n, 1);
+	}
 
 	/**
-		@brief Costruttore di copia per MultiSet
+		@brief Aggiornamento dei puntatori ai nodi spostati da un gruppo di posizioni interne
 
 		@description
-		Questo metodo permette di creare un MultiSet a partire da un altro.
-		Dei dati di default vengono inseriti tramite initialization list, poi vi è
-		l'effettiva copia del MultiSet. Nel caso si verifichi un'eccezione, questa è gestita
-		tramite il blocco try-catch ed il contenuto del MultiSet corrente è rimosso tramite il metodo
-		clear(). L'eventuale eccezione viene propagata al chiamante.
+		Ogni puntatore di testa o successivo che punta in from è sostituito con il nodo che ha
+		preso il posto di quello nella stessa posizione. Sono visitati solo i nodi e i bucket
+		del MultiSet, al più N nodi poiché i nodi interni sono usati solo finché lo sono tutti.
 
-		@param other MultiSet da copiare per istanziare quello corrente
+		@param from posizioni interne da cui i nodi sono stati spostati
+		@param moved nuovi nodi, indicizzati per posizione
+	*/
+	void redirect(const inline_nodes &from, node *const *moved) {
+		std::size_t nchains = (_nbuckets == 0) ? 1 : _nbuckets;
+		for(std::size_t i = 0; i < nchains; ++i)
+			for(node **p = (_nbuckets == 0) ? &_head : &_buckets[i]; *p != nullptr; p = &(*p)->next)
+				if(from.owns(*p))
+					*p = moved[from.index(*p)];
+	}
 
-		@throw eccezione di allocazione di memoria
+	/**
+		@brief Ricostruzione dell'indice dei valori più frequenti
 
+		@description
+		Richiamata quando cambiano i numeri di occorrenze di tutti i nodi o i loro indirizzi.
+		Se l'allocazione fallisce, l'indice è disattivato.
 	*/
-	MultiSet(const MultiSet &other) : _head(nullptr), _size(0) {
-		node *curr = other._head;
-
+	void refresh_top() noexcept {
+		if(_top == nullptr)
+			return;
 		try {
-			while(curr != nullptr) {
-				for(unsigned int i = curr->nocc; i > 0; --i) {
-					add(curr->value);
-				}
-				curr = curr->next;
-			}
+			fill_top(*_top);
 		}
-		catch(...) { // Eccezione di allocazione di memoria
-			clear();
-			throw;
+		catch(...) { // Eccezione di allocazione di memoria: l'indice è disattivato
+			delete _top;
+			_top = nullptr;
 		}
 	}
 
+	/**
+		@brief Spostamento dei nodi interni di un MultiSet in altre posizioni interne
+
+		@description
+		Ogni nodo di from è ricostruito nella stessa posizione di to, spostandone il valore, e
+		i puntatori di owner sono aggiornati. Usato dallo spostamento e dallo scambio di MultiSet.
+
+		@pre Le posizioni di to corrispondenti a quelle occupate in from sono libere
+
+		@param owner MultiSet a cui appartengono i nodi
+		@param from posizioni da cui spostare i nodi (liberate)
+		@param to posizioni in cui spostare i nodi
+	*/
+	static void relocate(MultiSet &owner, inline_nodes &from, inline_nodes &to) noexcept {
+		if(from.used() == 0)
+			return;
+		node *moved[N == 0 ? 1 : N] = {};
+		for(std::size_t i = 0; i < N; ++i) {
+			if(!from.in_use(i))
+				continue;
+			node *src = from.slot(i);
+			moved[i] = to.take(i);
+			node_traits::construct(owner._alloc, moved[i], emplace_tag(), src->hash, src->next, std::move(src->value));
+			moved[i]->nocc = src->nocc;
+			node_traits::destroy(owner._alloc, src);
+			from.release(src);
+		}
+		owner.redirect(from, moved);
+		owner.refresh_top();
+	}
+
+	/**
+		@brief Spostamento dei nodi interni nella memoria dell'allocatore
+
+		@description
+		Richiamato prima di collegare un nodo ottenuto dall'allocatore ad un MultiSet con nodi
+		interni. La memoria per tutti i nodi è richiesta prima di spostare qualsiasi valore.
+
+		@param keep puntatore ad un nodo, aggiornato se il nodo viene spostato
+
+		@post Nessun nodo è interno
+
+		@throw Eccezione di allocazione di memoria (il MultiSet resta invariato)
+	*/
+	void spill(node *&keep) {
+		node *moved[N == 0 ? 1 : N] = {};
+		try {
+			for(std::size_t i = 0; i < N; ++i)
+				if(_inline.in_use(i))
+					moved[i] = node_traits::allocate(_alloc, 1);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			for(std::size_t i = 0; i < N; ++i)
+				if(moved[i] != nullptr)
+					node_traits::deallocate(_alloc, moved[i], 1);
+			throw;
+		}
+		for(std::size_t i = 0; i < N; ++i) {
+			if(moved[i] == nullptr)
+				continue;
+			node *src = _inline.slot(i);
+			node_traits::construct(_alloc, moved[i], emplace_tag(), src->hash, src->next, std::move(src->value));
+			moved[i]->nocc = src->nocc;
+			node_traits::destroy(_alloc, src);
+		}
+		redirect(_inline, moved);
+		if(keep != nullptr && _inline.owns(keep))
+			keep = moved[_inline.index(keep)];
+		_inline.reset();
+		refresh_top();
+	}
+
+	/**
+		@brief Preparazione al collegamento di un nuovo nodo
+
+		@param n nuovo nodo
+		@param last nodo dopo cui n sarà collegato, aggiornato se viene spostato
+
+		@throw Eccezione di allocazione di memoria (il MultiSet resta invariato)
+	*/
+	void make_room(node *n, node *&last) {
+		if(_inline.used() > 0 && !_inline.owns(n))
+			spill(last);
+	}
+
+	/**
+		@brief Creazione di un nodo tramite l'allocatore
+
+		@description
+		Il valore del nodo è costruito sul posto a partire dagli argomenti args: un
+		valore T passato come rvalue viene quindi spostato, non copiato.
+
+		@tparam Args tipi degli argomenti del costruttore di T
+
+		@param h hash rimescolato del valore
+		@param args argomenti del costruttore di T
+
+		@return puntatore al nuovo nodo, con una occorrenza e senza successivo
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di T
+	*/
+	template <typename... Args>
+	node* create_node(std::size_t h, Args&&... args) {
+		node *n = allocate_node(_distinct + 1);
+		try {
+			node_traits::construct(_alloc, n, emplace_tag(), h, static_cast<node*>(nullptr), std::forward<Args>(args)...);
+		}
+		catch(...) { // Eccezione lanciata dal costruttore di T
+			deallocate_node(n);
+			throw;
+		}
+		return n;
+	}
+
+	/**
+		@brief Creazione della copia di un nodo, riutilizzando se possibile un nodo esistente
+
+		@description
+		Se la lista recycle non è vuota, il suo primo nodo viene rimosso dalla lista, il suo
+		valore è distrutto e la copia è costruita nella stessa memoria, senza richiedere
+		memoria all'allocatore. Altrimenti è allocato un nuovo nodo.
+
+		@param src nodo da copiare (valore, numero di occorrenze ed hash)
+		@param recycle lista di nodi riutilizzabili
+		@param distinct numero di elementi distinti della copia completa
+
+		@return puntatore alla copia, senza successivo
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	node* clone_node(const node *src, node *&recycle, std::size_t distinct) {
+		node *n;
+		if(recycle != nullptr) {
+			n = recycle;
+			recycle = recycle->next;
+			node_traits::destroy(_alloc, n);
+		}
+		else
+			n = allocate_node(distinct);
+		try {
+			node_traits::construct(_alloc, n, emplace_tag(), src->hash, static_cast<node*>(nullptr), src->value);
+		}
+		catch(...) { // Eccezione lanciata dal costruttore di copia di T
+			deallocate_node(n);
+			throw;
+		}
+		n->nocc = src->nocc;
+		return n;
+	}
+
+	/**
+		@brief Distruzione di una lista di nodi riutilizzabili
+
+		@param curr primo nodo della lista
+
+		@post I nodi della lista sono distrutti e la loro memoria è deallocata
+	*/
+	void destroy_chain(node *curr) {
+		while(curr != nullptr) {
+			node *tmp = curr->next;
+			destroy_node(curr);
+			curr = tmp;
+		}
+	}
+
+	/**
+		@brief Scollegamento di tutti i nodi del MultiSet
+
+		@description
+		I nodi sono raccolti in un'unica lista, senza essere distrutti, per essere riutilizzati
+		da clone(). L'array dei bucket resta allocato, con tutti i bucket vuoti.
+
+		@return lista dei nodi scollegati
+
+		@post Il MultiSet è vuoto
+	*/
+	node* detach_nodes() {
+		node *recycle = _head;
+
+		for(std::size_t i = 0; i < _nbuckets; ++i) {
+			node *curr = _buckets[i];
+			while(curr != nullptr) {
+				node *tmp = curr->next;
+				curr->next = recycle;
+				recycle = curr;
+				curr = tmp;
+			}
+			_buckets[i] = nullptr;
+		}
+		_head = nullptr;
+		_distinct = 0;
+		_size = 0;
+		_fp = 0;
+		if(_top != nullptr)
+			_top->clear();
+		return recycle;
+	}
+
+	/**
+		@brief Copia strutturale di un MultiSet
+
+		@description
+		Ogni nodo di other è copiato una sola volta, con il suo numero di occorrenze ed il
+		suo hash: non viene effettuata alcuna ricerca né alcun calcolo di hash. I bucket hanno
+		lo stesso numero di quelli di other e ciascuna lista mantiene l'ordine dei nodi, quindi
+		anche l'ordine di iterazione è quello di other. L'array dei bucket del MultiSet corrente
+		è riutilizzato se ha la dimensione giusta; i nodi della lista recycle sono riutilizzati
+		prima di allocarne di nuovi, e quelli avanzati sono distrutti; se la copia ha più di N
+		elementi distinti, i nodi interni non sono riutilizzati.
+		In caso di eccezione il MultiSet corrente è svuotato e l'eccezione è propagata.
+
+		@pre Il MultiSet corrente è vuoto (eventualmente con l'array dei bucket allocato)
+
+		@param other MultiSet da copiare
+		@param recycle lista di nodi riutilizzabili
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	void clone(const MultiSet &other, node *recycle) {
+		if(other._distinct > N && _inline.used() > 0) {
+			destroy_chain(recycle);
+			recycle = nullptr;
+		}
+		try {
+			if(_nbuckets != other._nbuckets) {
+				node **nb = (other._nbuckets == 0) ? nullptr : create_buckets(other._nbuckets);
+				destroy_buckets(_buckets, _nbuckets);
+				_buckets = nb;
+				_nbuckets = other._nbuckets;
+			}
+			std::size_t nchains = (other._nbuckets == 0) ? 1 : other._nbuckets;
+			for(std::size_t i = 0; i < nchains; ++i) {
+				const node *src = (other._nbuckets == 0) ? other._head : other._buckets[i];
+				node **dst = (other._nbuckets == 0) ? &_head : &_buckets[i];
+				while(src != nullptr) {
+					node *tmp = clone_node(src, recycle, other._distinct);
+					*dst = tmp;
+					dst = &tmp->next;
+					_distinct++;
+					account(tmp, 0, tmp->nocc);
+					src = src->next;
+				}
+			}
+		}
+		catch(...) { // Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+			destroy_chain(recycle);
+			clear();
+			throw;
+		}
+		destroy_chain(recycle);
+	}
+
+	/**
+		@brief Distruzione di un nodo tramite l'allocatore
+
+		@param n nodo da distruggere
+
+		@post La memoria del nodo è restituita all'allocatore, o la sua posizione interna è liberata
+	*/
+	void destroy_node(node *n) {
+		node_traits::destroy(_alloc, n);
+		deallocate_node(n);
+	}
+
+	/**
+		@brief Allocazione di un array di bucket vuoti tramite l'allocatore
+
+		@param n numero di bucket
+
+		@return puntatore all'array, con tutti i bucket a nullptr
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	node** create_buckets(std::size_t n) {
+		bucket_allocator ba(_alloc);
+		node **b = bucket_traits::allocate(ba, n);
+		for(std::size_t i = 0; i < n; ++i)
+			b[i] = nullptr;
+		return b;
+	}
+
+	/**
+		@brief Deallocazione di un array di bucket tramite l'allocatore
+
+		@param b array da deallocare (può essere nullptr)
+		@param n numero di bucket dell'array
+	*/
+	void destroy_buckets(node **b, std::size_t n) {
+		if(b == nullptr)
+			return;
+		bucket_allocator ba(_alloc);
+		bucket_traits::deallocate(ba, b, n);
+	}
+
+	/**
+		@brief Calcolo dell'hash di un valore
+
+		@description
+		Senza funtore di hash, se il confronto è byte per byte, l'hash è calcolato dai byte del
+		valore (multiset_bytewise_hash): non seleziona alcun bucket, ma dà il peso del valore
+		nell'impronta ed evita il confronto dei valori con hash diverso durante la scansione.
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash rimescolato del valore, 0 se il MultiSet non usa un funtore di hash e
+		l'hash non è calcolato dai byte
+	*/
+	template <typename K>
+	std::size_t hash_of(const K &v) const {
+		return hashed ? multiset_mix(_hash(v)) : bytes_hash(v, byte_hashed<K>());
+	}
+
+	/**
+		@brief Hash dei byte di un valore, per i MultiSet senza hash con il confronto byte per byte
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash rimescolato dei byte di v
+	*/
+	static std::size_t bytes_hash(const T &v, std::true_type) {
+		return multiset_mix(multiset_bytewise_hash<T>()(v));
+	}
+
+	/**
+		@brief Versione di bytes_hash() per gli altri MultiSet e chiavi
+
+		@return 0
+	*/
+	template <typename K>
+	static std::size_t bytes_hash(const K &, std::false_type) {
+		return 0;
+	}
+
+	/**
+		@brief Confronto tra il valore di un nodo ed un elemento
+
+		@param a valore del nodo
+		@param v elemento cercato
+
+		@return true se a e v sono uguali
+	*/
+	bool key_equal(const T &a, const T &v) const {
+		return multiset_equal(_eql, a, v);
+	}
+
+	/**
+		@brief Confronto tra il valore di un nodo ed una chiave di tipo diverso, tramite il funtore trasparente
+
+		@param a valore del nodo
+		@param k chiave cercata
+
+		@return true se a e k sono uguali secondo il funtore
+	*/
+	template <typename K>
+	bool key_equal(const T &a, const K &k) const {
+		return _eql(a, k);
+	}
+
+	/**
+		@brief Testa della lista che può contenere un valore con hash dato
+
+		@description
+		Se i bucket non sono allocati, tutti i nodi appartengono all'unica lista
+		che parte da _head. Altrimenti, il bucket è selezionato dai bit meno
+		significativi dell'hash.
+
+		@param h hash rimescolato del valore
+
+		@return reference al puntatore di testa della lista
+	*/
+	node*& chain(std::size_t h) {
+		if(_nbuckets == 0)
+			return _head;
+		return _buckets[h & (_nbuckets - 1)];
+	}
+
+	/**
+		@brief Versione costante di chain()
+
+		@param h hash rimescolato del valore
+
+		@return puntatore di testa della lista
+	*/
+	node* chain(std::size_t h) const {
+		if(_nbuckets == 0)
+			return _head;
+		return _buckets[h & (_nbuckets - 1)];
+	}
+
+	/**
+		@brief Primo nodo del MultiSet nell'ordine di iterazione
+
+		@return puntatore al primo nodo, nullptr se il MultiSet è vuoto
+	*/
+	node* first_node() const {
+		if(_nbuckets == 0)
+			return _head;
+		for(std::size_t i = 0; i < _nbuckets; ++i)
+			if(_buckets[i] != nullptr)
+				return _buckets[i];
+		return nullptr;
+	}
+
+	/**
+		@brief Nodo successivo nell'ordine di iterazione
+
+		@description
+		Se il nodo è l'ultimo del proprio bucket, la ricerca prosegue dal bucket
+		successivo, individuato tramite l'hash memorizzato nel nodo.
+
+		@param n nodo corrente
+
+		@return puntatore al nodo successivo, nullptr se n è l'ultimo nodo
+	*/
+	node* next_node(const node *n) const {
+		if(n->next != nullptr || _nbuckets == 0)
+			return n->next;
+		for(std::size_t i = (n->hash & (_nbuckets - 1)) + 1; i < _nbuckets; ++i)
+			if(_buckets[i] != nullptr)
+				return _buckets[i];
+		return nullptr;
+	}
+
+	/**
+		@brief Ridistribuzione dei nodi in un nuovo array di bucket
+
+		@description
+		Alloca un array di n bucket e vi sposta tutti i nodi, usando l'hash memorizzato
+		in ciascun nodo (i valori non vengono né copiati né ricalcolati).
+
+		@pre n è una potenza di 2
+
+		@param n nuovo numero di bucket
+
+		@post I nodi sono distribuiti negli n bucket e _head è nullptr
+
+		@throw Eccezione di allocazione di memoria (il MultiSet resta invariato)
+	*/
+	void rehash(std::size_t n) {
+		node **nb = create_buckets(n);
+		std::size_t nold = (_nbuckets == 0) ? 1 : _nbuckets;
+
+		for(std::size_t i = 0; i < nold; ++i) {
+			node *curr = (_nbuckets == 0) ? _head : _buckets[i];
+			while(curr != nullptr) {
+				node *tmp = curr->next;
+				node *&dst = nb[curr->hash & (n - 1)];
+				curr->next = dst;
+				dst = curr;
+				curr = tmp;
+			}
+		}
+		destroy_buckets(_buckets, _nbuckets);
+		_buckets = nb;
+		_nbuckets = n;
+		_head = nullptr;
+	}
+
+	/**
+		@brief Crescita dell'array dei bucket
+
+		@description
+		Con un funtore di hash, l'array dei bucket è raddoppiato quando il numero di
+		elementi distinti supera il numero di bucket (fattore di carico massimo 1).
+		Fino a min_buckets / 2 elementi distinti il MultiSet resta una lista semplice.
+		Una mancata allocazione viene ignorata: il MultiSet resta corretto, ma più lento.
+	*/
+	void grow() {
+		if(!hashed)
+			return;
+		if(_nbuckets == 0 ? (_distinct > min_buckets / 2) : (_distinct > _nbuckets)) {
+			try {
+				rehash(_nbuckets == 0 ? min_buckets : _nbuckets * 2);
+			}
+			catch(...) { // Eccezione di allocazione di memoria
+			}
+		}
+	}
+
+	/**
+		@brief Variante di ricerca di un elemento nel MultiSet
+
+		@description
+		Questo metodo è una variante del metodo contains(). La logica è la medesima, ma
+		cambia il valore di ritorno. Metodo privato utilizzato negli altri metodi.
+
+		@param v elemento (o chiave, con funtori trasparenti) da cercare nel MultiSet
+
+		@return puntatore al nodo contenente l'elemento cercato, se presente, nullptr altrimenti
+	*/
+	template <typename K>
+	node* contains_at(const K &v) const {
+		return contains_at(v, hash_of(v));
+	}
+
+	/**
+		@brief Variante di ricerca di un elemento nel MultiSet con hash già calcolato
+
+		@description
+		Viene scandita la sola lista che può contenere il valore. Il funtore di
+		uguaglianza è invocato solo sui nodi con lo stesso hash (salvo per le chiavi di
+		tipo diverso da T in un MultiSet senza hash, per cui l'hash dei nodi non è confrontabile).
+
+		@param v elemento da cercare nel MultiSet
+		@param h hash rimescolato di v
+
+		@return puntatore al nodo contenente l'elemento cercato, se presente, nullptr altrimenti
+	*/
+	template <typename K>
+	node* contains_at(const K &v, std::size_t h) const {
+		node *prev;
+		return contains_at(v, h, prev);
+	}
+
+	/**
+		@brief Variante di ricerca che restituisce anche il nodo precedente
+
+		@description
+		Oltre al nodo cercato, restituisce il nodo che lo precede nella sua lista.
+		Se il valore non è presente, la scansione termina sull'ultimo nodo della lista,
+		che viene restituito come precedente: un nuovo nodo può quindi essere accodato
+		senza scorrere la lista una seconda volta.
+
+		@param v elemento da cercare nel MultiSet
+		@param h hash rimescolato di v
+		@param prev nodo precedente a quello cercato (o ultimo nodo della lista se il valore
+		non è presente), nullptr se il nodo cercato è in testa o la lista è vuota
+
+		@return puntatore al nodo contenente l'elemento cercato, se presente, nullptr altrimenti
+	*/
+	template <typename K>
+	node* contains_at(const K &v, std::size_t h, node *&prev) const {
+		node *curr = chain(h);
+
+		prev = nullptr;
+		while(curr != nullptr) {
+			if((curr->hash == h || (!hashed && !byte_hashed<K>::value)) && key_equal(curr->value, v))
+				return curr;
+			prev = curr;
+			curr = curr->next;
+		}
+		return nullptr;
+	}
+
+	/**
+		@brief Ordinamento dei nodi byte per byte
+	*/
+	struct node_bytes_less {
+		bool operator()(const node *a, const node *b) const {
+			return multiset_bytewise_less<T>()(a->value, b->value);
+		}
+
+		bool operator()(const node *a, const T &v) const {
+			return multiset_bytewise_less<T>()(a->value, v);
+		}
+	};
+
+	/**
+		@brief Variante per i tipi senza ordinamento byte per byte: l'indice non è costruito
+	*/
+	bool index_nodes(node_index &, std::false_type) const {
+		return false;
+	}
+
+	/**
+		@brief Costruzione di un indice dei nodi ordinati byte per byte
+
+		@description
+		Usato dalle operazioni tra MultiSet senza hash, che altrimenti scandiscono la lista
+		per ogni elemento dell'altro MultiSet. L'indice non è costruito per MultiSet piccoli,
+		né se la memoria non è sufficiente: il chiamante scandisce allora la lista.
+
+		@param idx vettore (vuoto) in cui inserire i nodi
+
+		@return true se l'indice è stato costruito
+	*/
+	bool index_nodes(node_index &idx, std::true_type) const {
+		if(_distinct <= index_min)
+			return false;
+		try {
+			idx.reserve(_distinct);
+		}
+		catch(const std::bad_alloc &) {
+			return false;
+		}
+		for(const node *curr = first_node(); curr != nullptr; curr = next_node(curr))
+			idx.push_back(curr);
+		std::sort(idx.begin(), idx.end(), node_bytes_less());
+		return true;
+	}
+
+	/**
+		@brief Variante per i tipi senza ordinamento byte per byte (mai invocata)
+	*/
+	static const node* find_indexed(const node_index &, const T &, std::false_type) {
+		return nullptr;
+	}
+
+	/**
+		@brief Ricerca binaria di un valore nell'indice dei nodi
+
+		@param idx indice costruito da index_nodes()
+		@param v valore da cercare
+
+		@return nodo contenente v, nullptr se non presente
+	*/
+	static const node* find_indexed(const node_index &idx, const T &v, std::true_type) {
+		typename node_index::const_iterator it = std::lower_bound(idx.begin(), idx.end(), v, node_bytes_less());
+		if(it == idx.end() || std::memcmp(&(*it)->value, &v, sizeof(T)) != 0)
+			return nullptr;
+		return *it;
+	}
+
+	/**
+		@brief Peso di un valore nell'impronta del MultiSet
+
+		@description
+		L'hash del nodo è rimescolato nuovamente, così che il peso non dipenda dai soli bit
+		usati per selezionare il bucket. Senza funtore di hash è usato l'hash dei byte se il
+		confronto è byte per byte (vedi hash_of()); altrimenti il peso è sempre 1 e l'impronta
+		coincide con il numero di elementi.
+
+		@param h hash rimescolato del valore
+
+		@return peso del valore
+	*/
+	static std::size_t weight(std::size_t h) {
+		return (hashed || indexed::value) ? multiset_mix(h ^ static_cast<std::size_t>(0x9e3779b97f4a7c15ULL)) : 1;
+	}
+
+	/**
+		@brief Aggiornamento del numero di elementi, dell'impronta e dell'indice dei valori più frequenti
+
+		@description
+		Richiamato ad ogni variazione del numero di occorrenze di un valore, prima che un nodo
+		eliminato sia distrutto. L'impronta è la somma (modulo 2^N, con N i bit di std::size_t)
+		dei pesi dei valori moltiplicati per il loro numero di occorrenze: la differenza tra i
+		due numeri di occorrenze è calcolata anch'essa modulo 2^N, quindi l'aggiornamento è
+		corretto sia per gli incrementi sia per i decrementi. Se l'indice dei valori più
+		frequenti è attivo, la voce del nodo è spostata in O(log d): la cella liberata
+		dall'erase è riutilizzata dall'insert, quindi l'aggiornamento di un valore già presente
+		non alloca memoria. Se l'allocazione di una nuova voce fallisce (solo per un valore
+		nuovo, con il pool esaurito), l'indice è disattivato e il MultiSet resta valido.
+
+		@param n nodo di cui cambia il numero di occorrenze
+		@param old numero di occorrenze precedente (0 per un nodo nuovo)
+		@param now nuovo numero di occorrenze (0 per un nodo che sarà eliminato)
+	*/
+	void account(const node *n, std::size_t old, std::size_t now) {
+		_size += now - old;
+		_fp += weight(n->hash) * (now - old);
+		if(_top != nullptr) {
+			try {
+				if(old > 0)
+					_top->erase(top_entry(old, n));
+				if(now > 0)
+					_top->insert(top_entry(now, n));
+			}
+			catch(...) { // Eccezione di allocazione di memoria: l'indice non è più aggiornato
+				delete _top;
+				_top = nullptr;
+			}
+		}
+	}
+
+	/**
+		@brief Costruzione di un indice dei valori più frequenti
+
+		@description
+		Ogni nodo è inserito nell'indice, in O(d log d).
+
+		@param idx indice da riempire (il contenuto precedente è eliminato)
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	void fill_top(top_index &idx) const {
+		idx.clear();
+		for(const node *curr = first_node(); curr != nullptr; curr = next_node(curr))
+			idx.insert(top_entry(curr->nocc, curr));
+	}
+
+	/**
+		@brief Confronto tra nodi per numero di occorrenze, usato da top_k()
+
+		@param a primo nodo
+		@param b secondo nodo
+
+		@return true se a ha più occorrenze di b
+	*/
+	static bool more_frequent(const node *a, const node *b) {
+		return a->nocc > b->nocc;
+	}
+
+	/**
+		@brief Collegamento di un nuovo nodo in coda alla sua lista
+
+		@param n nodo da collegare, con hash già calcolato
+		@param last ultimo nodo della lista restituito dalla ricerca, nullptr se la lista è vuota
+
+		@post Il nodo è l'ultimo della sua lista e le dimensioni del MultiSet sono aggiornate
+
+		@throw Eccezione di allocazione di memoria (il nodo è distrutto e il MultiSet resta invariato)
+	*/
+	void link_node(node *n, node *last) {
+		try {
+			make_room(n, last);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			destroy_node(n);
+			throw;
+		}
+		if(last == nullptr)
+			chain(n->hash) = n;
+		else
+			last->next = n;
+		account(n, 0, n->nocc);
+		_distinct++;
+		grow();
+	}
+
+	/**
+		@brief Inserimento di più occorrenze di un elemento con una sola ricerca
+
+		@param v valore da inserire nel MultiSet
+		@param k numero di occorrenze da inserire
+
+		@post Il numero di occorrenze di v ed il numero totale di elementi sono incrementati di k
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	void add_count(const T &v, std::size_t k) {
+		add_count(v, hash_of(v), k);
+	}
+
+	/**
+		@brief Variante di add_count() con hash già calcolato
+
+		@param v valore da inserire nel MultiSet
+		@param h hash rimescolato di v
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	void add_count(const T &v, std::size_t h, std::size_t k) {
+		node *last;
+		node *curr = this->contains_at(v, h, last);
+
+		if(k > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		if(curr != nullptr) {
+			account(curr, curr->nocc, curr->nocc + k);
+			curr->nocc += k;
+		}
+		else {
+			node *tmp = create_node(h, v);
+			tmp->nocc = k;
+			link_node(tmp, last);
+		}
+	}
+
+	/**
+		@brief Inserimento di un nuovo elemento senza ricerca
+
+		@description
+		Usato dal caricamento di sequenze ordinate in un MultiSet vuoto: il valore non può
+		essere già presente. Senza bucket il nodo è accodato dopo tail, così da mantenere
+		l'ordine della sequenza; altrimenti è inserito in testa al suo bucket.
+
+		@pre v non è presente nel MultiSet
+
+		@param v valore da inserire nel MultiSet
+		@param k numero di occorrenze da inserire
+		@param tail ultimo nodo della lista (aggiornato se i bucket non sono allocati)
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	void append_new(const T &v, std::size_t k, node *&tail) {
+		node *tmp = create_node(hash_of(v), v);
+		tmp->nocc = k;
+		try {
+			make_room(tmp, tail);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			destroy_node(tmp);
+			throw;
+		}
+		if(_nbuckets == 0) {
+			if(tail == nullptr)
+				_head = tmp;
+			else
+				tail->next = tmp;
+			tail = tmp;
+		}
+		else {
+			node *&first = chain(tmp->hash);
+			tmp->next = first;
+			first = tmp;
+		}
+		account(tmp, 0, k);
+		_distinct++;
+		grow();
+	}
+
+	/**
+		@brief Inserimento di una sequenza con iteratori di input o di tipo diverso da T
+
+		@description
+		Gli elementi sono convertiti in T ed inseriti uno alla volta tramite add().
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param sorted ignorato
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	void add_range(IterT first, IterT last, bool sorted, std::false_type) {
+		(void)sorted;
+		while(first != last) {
+			add(static_cast<T>(*first));
+			++first;
+		}
+	}
+
+	/**
+		@brief Inserimento di una sequenza di elementi di tipo T con iteratori di tipo forward
+
+		@description
+		La sequenza è scandita una sola volta: gli elementi uguali adiacenti sono raggruppati
+		ed ogni gruppo è inserito con una sola ricerca, tramite add_count().
+		Se la sequenza è ordinata ed il MultiSet è inizialmente vuoto, ogni gruppo è un valore
+		nuovo e viene inserito senza alcuna ricerca, tramite append_new().
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param sorted true se gli elementi uguali della sequenza sono adiacenti
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	void add_range(IterT first, IterT last, bool sorted, std::true_type) {
+		bool append = sorted && _distinct == 0;
+		node *tail = nullptr;
+		IterT run = first;
+		std::size_t k = 0;
+
+		while(first != last) {
+			if(k > 0 && !_eql(*run, *first)) {
+				if(append)
+					append_new(*run, k, tail);
+				else
+					add_count(*run, k);
+				run = first;
+				k = 0;
+			}
+			++k;
+			++first;
+		}
+		if(k > 0) {
+			if(append)
+				append_new(*run, k, tail);
+			else
+				add_count(*run, k);
+		}
+	}
+
+	/**
+		@brief Selezione della strategia di inserimento di una sequenza
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param sorted true se gli elementi uguali della sequenza sono adiacenti
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	void add_range(IterT first, IterT last, bool sorted) {
+		typedef typename std::iterator_traits<IterT>::iterator_category category;
+		typedef typename std::iterator_traits<IterT>::value_type value;
+		typedef std::integral_constant<bool, std::is_convertible<category, std::forward_iterator_tag>::value &&
+			std::is_same<typename std::remove_cv<value>::type, typename std::remove_cv<T>::type>::value> grouped;
+
+		add_range(first, last, sorted, grouped());
+	}
+
+	/**
+		@brief Metodo ausiliario di inserimento di un elemento nel MultiSet
+
+		@description
+		Richiamato da entrambe le versioni di add(). Il valore viene copiato o spostato
+		nel nuovo nodo solo se non è già presente nel MultiSet.
+
+		@tparam U tipo del valore (reference costante o rvalue reference a T)
+
+		@param v valore da inserire nel MultiSet
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	template <typename U>
+	void add_helper(U &&v) {
+		std::size_t h = hash_of(v);
+		node *last;
+		node *curr = this->contains_at(v, h, last);
+
+		if(_size == std::numeric_limits<std::size_t>::max())
+			throw multiset_count_overflow();
+		if(curr != nullptr) {
+			account(curr, curr->nocc, curr->nocc + 1);
+			curr->nocc++;
+		}
+		else
+			link_node(create_node(h, std::forward<U>(v)), last);
+	}
+
+	/**
+		@brief Metodo ausiliario di rimozione elemento dal MultiSet
+
+		@description
+		Questo metodo viene richiamato da remove() e, tramite l'uso dei puntatori, elimina un elemento
+		dal MultiSet.
+		Se l'elemento da eliminare è la testa della sua lista, allora la nuova testa sarà l'elemento successivo a quello
+		che faceva da testa. Il nodo testa precedente viene eliminato.
+		Altrimenti, tramite il nodo precedente individuato durante la ricerca, il nodo da eliminare viene "scollegato"
+		sia dal precedente sia dal successivo. Il next del nodo precedente diviene quindi il next del nodo da eliminare.
+		Il nodo da eliminare è eliminato.
+
+		@param curr nodo da eliminare
+		@param prev nodo precedente a curr nella sua lista, nullptr se curr è in testa
+
+		@post Il puntatore della testa viene eventualmente aggiornato al nodo che le faceva da successivo
+		@post Il nodo precedente ed il successivo rispetto al nodo da eliminare vengono collegati tra di loro,
+		attraverso i puntatori
+		@post Il nodo da eliminare viene distrutto e la sua locazione di memoria viene deallocata
+	*/
+	void remove_helper(node *curr, node *prev) {
+		if(prev == nullptr) {
+			node *&first = chain(curr->hash);
+			first = first->next;
+		}
+		else
+			prev->next = curr->next;
+		destroy_node(curr);
+		curr = nullptr;
+		_distinct--;
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento, cercato tramite un elemento o una chiave
+
+		@param key elemento (o chiave, con funtori trasparenti) da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	template <typename K>
+	void remove_key(const K &key, std::size_t k) {
+		remove_key(key, hash_of(key), k);
+	}
+
+	/**
+		@brief Variante di remove_key() con hash già calcolato
+
+		@param key elemento (o chiave, con funtori trasparenti) da rimuovere
+		@param h hash rimescolato di key
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	template <typename K>
+	void remove_key(const K &key, std::size_t h, std::size_t k) {
+		if(k == 0)
+			return;
+
+		node *prev;
+		node *curr = this->contains_at(key, h, prev);
+
+		if(curr == nullptr || curr->nocc < k)
+			throw multiset_value_not_found();
+		account(curr, curr->nocc, curr->nocc - k);
+		curr->nocc -= k;
+		if(curr->nocc == 0)
+			remove_helper(curr, prev);
+	}
+
+public:
+	
+	// Sezione pubblica della classe
+
+	// Tipi pubblici
+
+	typedef std::size_t size_type; ///< Tipo del numero di occorrenze e del numero di elementi
+
+	// Metodi pubblici fondamentali
+
+	/**
+		@brief Costruttore di default per MultiSet
+
+		@description
+		Questo metodo istanzia un MultiSet vuoto, tramite initialization list.
+		Il puntatore alla testa della lista, che rappresenta il MultiSet, è inizializzato
+		a nullptr. La dimensione del MultiSet è 0.
+	*/
+	MultiSet() : _head(nullptr), _buckets(nullptr), _nbuckets(0), _distinct(0), _size(0), _fp(0), _top(nullptr) {}
+
+	/**
+		@brief Costruttore di un MultiSet vuoto con allocatore dato
+
+		@description
+		Come il costruttore di default, ma i nodi sono allocati tramite una copia
+		dell'allocatore alloc.
+		La keyword explicit è usata per impedire al compilatore di usare questo metodo
+		per effettuare conversioni implicite.
+
+		@param alloc allocatore da usare per i nodi e per l'array dei bucket
+	*/
+	explicit MultiSet(const A &alloc) : _head(nullptr), _buckets(nullptr), _nbuckets(0), _distinct(0), _size(0), _fp(0), _top(nullptr),
+		_alloc(alloc) {}
+
+	/**
+		@brief Costruttore di copia per MultiSet
+
+		@description
+		Questo metodo permette di creare un MultiSet a partire da un altro.
+		Dei dati di default vengono inseriti tramite initialization list, poi vi è
+		l'effettiva copia del MultiSet, tramite il metodo privato clone(): ogni nodo di other
+		è copiato una sola volta, con il suo numero di occorrenze. Nel caso si verifichi
+		un'eccezione, il contenuto del MultiSet corrente è rimosso tramite il metodo
+		clear(). L'eventuale eccezione viene propagata al chiamante.
+		L'allocatore è ottenuto da quello di other tramite select_on_container_copy_construction()
+		(un allocatore a blocchi crea quindi un pool nuovo).
+
+		@param other MultiSet da copiare per istanziare quello corrente
+
+		@throw eccezione di allocazione di memoria
+
+	*/
+	MultiSet(const MultiSet &other) : _head(nullptr), _buckets(nullptr), _nbuckets(0), _distinct(0), _size(0), _fp(0), _top(nullptr),
+		_alloc(node_traits::select_on_container_copy_construction(other._alloc)) {
+		clone(other, nullptr);
+	}
+
 	/**
 		@brief Operatore di assegnamento per MultiSet
 
 		@description
-		Questo metodo permette la copia tra MultiSet, controllando l'eventuale auto-assegnamento.
-		La copia avviene tramite copy-constructor ed utilizzo della funzione std::swap.
-		L'uso del metodo copy-constructor comporta la possibile propagazione di eccezioni.
+		Questo metodo permette la copia tra MultiSet, controllando l'eventuale auto-assegnamento.
+		I nodi del MultiSet corrente sono scollegati e riutilizzati per le copie dei nodi di other
+		(il valore è distrutto e ricostruito nella stessa memoria); anche l'array dei bucket è
+		riutilizzato se ha la dimensione giusta. L'allocatore del MultiSet corrente non cambia
+		(propagate_on_container_copy_assignment non è considerato: gli allocatori forniti,
+		compreso multiset_pool_allocator, lo dichiarano false). In caso di eccezione il MultiSet
+		corrente resta valido ma vuoto, e l'eccezione è propagata.
+
+		@param other MultiSet "sorgente" da copiare
+
+		@return Riferimento al MultiSet corrente
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	MultiSet& operator=(const MultiSet &other) {
+		if(this != &other)
+			clone(other, detach_nodes());
+		return *this;
+	}
+
+	/**
+		@brief Costruttore di spostamento per MultiSet
+
+		@description
+		I nodi, l'array dei bucket e l'allocatore di other sono trasferiti al MultiSet
+		corrente senza copiare alcun elemento. other rimane un MultiSet vuoto e valido.
+		Gli eventuali nodi interni di other sono ricostruiti nelle posizioni interne del
+		MultiSet corrente, spostandone i valori.
+
+		@param other MultiSet da spostare
+
+		@post other è vuoto
+	*/
+	MultiSet(MultiSet &&other) noexcept : _head(other._head), _buckets(other._buckets), _nbuckets(other._nbuckets),
+		_distinct(other._distinct), _size(other._size), _fp(other._fp), _top(other._top), _eql(other._eql), _hash(other._hash),
+		_alloc(other._alloc) {
+		other._head = nullptr;
+		other._buckets = nullptr;
+		other._nbuckets = 0;
+		other._distinct = 0;
+		other._size = 0;
+		other._fp = 0;
+		other._top = nullptr;
+		relocate(*this, other._inline, _inline);
+	}
+
+	/**
+		@brief Operatore di assegnamento di spostamento per MultiSet
+
+		@description
+		Il contenuto di other è spostato in un MultiSet temporaneo, che viene poi
+		scambiato con quello corrente: il vecchio contenuto è distrutto insieme al temporaneo.
+
+		@param other MultiSet "sorgente" da spostare
+
+		@return Riferimento al MultiSet corrente
+
+		@post other è vuoto
+	*/
+	MultiSet& operator=(MultiSet &&other) noexcept {
+		if(this != &other) {
+			MultiSet tmp(std::move(other));
+			this->swap(tmp);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Scambio del contenuto di due MultiSet
+
+		@description
+		Sono scambiati i puntatori ai nodi ed ai bucket, le dimensioni, i funtori e
+		gli allocatori: nessun elemento viene copiato e nessuna eccezione può essere lanciata.
+		I nodi interni sono scambiati spostandone i valori, tramite posizioni temporanee.
+
+		@param other MultiSet con cui scambiare il contenuto
+	*/
+	void swap(MultiSet &other) noexcept {
+		std::swap(this->_head, other._head);
+		std::swap(this->_buckets, other._buckets);
+		std::swap(this->_nbuckets, other._nbuckets);
+		std::swap(this->_distinct, other._distinct);
+		std::swap(this->_size, other._size);
+		std::swap(this->_fp, other._fp);
+		std::swap(this->_top, other._top);
+		std::swap(this->_eql, other._eql);
+		std::swap(this->_hash, other._hash);
+		std::swap(this->_alloc, other._alloc);
+		if(_inline.used() > 0 || other._inline.used() > 0) {
+			inline_nodes tmp;
+			relocate(other, _inline, tmp);
+			relocate(*this, other._inline, _inline);
+			relocate(other, tmp, other._inline);
+		}
+	}
+
+	/**
+		@brief Distruttore per MultiSet
+
+		@descrpition
+		Il distruttore del MultiSet sfrutta il metodo privato clear(), che si occupa
+		di distruggere tutti i nodi della lista, deallocando iterativamente la memoria
+		da loro occupata.
+
+		@post La memoria allocata da tutti gli elementi del MultiSet è deallocata
+		@post Tutte le locazioni di memoria per il MultiSet ed i suoi elementi non sono ora più valide
+	*/
+	~MultiSet() {
+		clear();
+		delete _top;
+	}
+
+	// Metodi pubblici non fondamentali
+
+	/**
+		@brief Ricerca di un elemento nel MultiSet
+
+		@description
+		Questo metodo si occupa di stabilire se un dato di tipo generico T è presente
+		o meno nel MultiSet. La ricerca avviene scorrendo la lista fino in fondo, o finchè
+		l'elemento viene trovato. Con un funtore di hash, è scandito il solo bucket del valore.
+
+		@param v elemento da cercare nel MultiSet
+
+		@return True se l'elemento è presenta, false altrimenti
+	*/
+	bool contains(const T &v) const {
+		return contains_at(v) != nullptr;
+	}
+
+	/**
+		@brief Ricerca di un elemento tramite una chiave di tipo diverso
+
+		@description
+		Disponibile se il funtore di uguaglianza (e quello di hash, se usato) dichiara il tipo
+		membro is_transparent: la chiave è confrontata direttamente con i valori dei nodi, senza
+		costruire un elemento di tipo T (ad esempio un const char* in un MultiSet di std::string).
+		L'hash della chiave deve coincidere con quello dell'elemento uguale.
+
+		@tparam K tipo della chiave, confrontabile con T dal funtore di uguaglianza
+
+		@param k chiave da cercare nel MultiSet
+
+		@return True se un elemento uguale alla chiave è presente, false altrimenti
+	*/
+	template <typename K>
+	typename std::enable_if<key_lookup<K>::value, bool>::type contains(const K &k) const {
+		return contains_at(k) != nullptr;
+	}
+
+	/**
+		@brief Metodo di rimozione contenuto del MultiSet
+
+		@description
+		Metodo che rimuove tutto il contenuto di un MultiSet (richiamato anche dal distruttore).
+		Si appoggia ad un altro metodo privato, richiamato sul nodo di testa
+		e sulla testa di ciascun bucket. L'array dei bucket viene deallocato.
+		Le posizioni dei nodi interni sono tutte liberate.
+		Se l'allocatore è un pool usato solo da questo MultiSet, i nodi non vengono
+		deallocati singolarmente: il pool è rilasciato in un'unica operazione, e se T ha
+		un distruttore banale i nodi non vengono nemmeno visitati.
+
+		@post Il MultiSet è vuoto e la memoria allocata per i suoi elementi è deallocata
+	*/
+	void clear() {
+		bool bulk = multiset_pool_traits<node_allocator>::owns_all(_alloc, _distinct - _inline.used());
+
+		if(!bulk || !std::is_trivially_destructible<T>::value) {
+			clear_helper(_head, !bulk);
+			for(std::size_t i = 0; i < _nbuckets; ++i)
+				clear_helper(_buckets[i], !bulk);
+		}
+		_head = nullptr;
+		_inline.reset();
+		destroy_buckets(_buckets, _nbuckets);
+		_buckets = nullptr;
+		_nbuckets = 0;
+		_distinct = 0;
+		_size = 0;
+		_fp = 0;
+		if(_top != nullptr)
+			_top->clear();
+		if(bulk)
+			multiset_pool_traits<node_allocator>::release(_alloc);
+	}
+
+	/**
+		@brief Allocatore del MultiSet
+
+		@return copia dell'allocatore usato per i nodi, convertita nel tipo A
+	*/
+	A get_allocator() const {
+		return A(_alloc);
+	}
+
+	/**
+		@brief Numero di elementi di un MultiSet
+
+		@return numero totale di elementi di un MultiSet
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di elementi distinti di un MultiSet
+
+		@return numero di elementi distinti (ovvero di nodi)
+	*/
+	size_type distinct_size() const {
+		return _distinct;
+	}
+
+	/**
+		@brief Inserimento di un elemento nel MultiSet
+
+		@description
+		Questo metodo permette l'inserimento di un elemento nel MultiSet.
+		Il valore passato come parametro viene cercato all'interno del MultiSet e, se presente,
+		il numero di occorrenze nel nodo che lo contiene viene incrementato di 1.
+		Se il valore non è presente, allora viene creato un nuovo nodo, con valore dato e puntatore
+		al nodo successivo impostato a nullptr.
+		Seguono due sottocasi: se la lista è vuota (ovvero la testa punta a nullptr), allora il nuovo nodo 
+		diviene la testa della lista. Altrimenti, il nuovo nodo viene aggiunto alla fine della stessa, dopo
+		l'ultimo nodo visitato dalla ricerca (la lista è quindi scandita una sola volta).
+		Con un funtore di hash, la lista considerata è quella del bucket del valore e, se necessario,
+		l'array dei bucket viene ingrandito.
+		
+		@param v valore da inserire nel MultiSet
+
+		@post Se l'elemento era già presente nel MultiSet, il suo numero di occorrenze è incrementato di 1
+		@post Se la lista era vuota (elemento non presente), il puntatore alla testa viene aggiornato con l'elemento inserito
+		@post Se la lista non era vuota (elemento non presente), il nuovo elemento inserito è l'ultimo della lista
+		@post Il numero totale di elementi è incrementato di 1
+
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v) {
+		add_helper(v);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento nel MultiSet
+
+		@description
+		Come add(const T &), ma il numero di occorrenze è incrementato di k con una sola ricerca.
+		Se k è 0 il MultiSet non viene modificato.
+
+		@param v valore da inserire nel MultiSet
+		@param k numero di occorrenze da inserire
+
+		@post Il numero di occorrenze di v ed il numero totale di elementi sono incrementati di k
+
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	void add(const T &v, size_type k) {
+		if(k > 0)
+			add_count(v, k);
+	}
+
+	/**
+		@brief Inserimento di un elemento temporaneo nel MultiSet
+
+		@description
+		Come add(const T &), ma se il valore non è presente viene spostato nel nuovo nodo
+		invece di essere copiato. Se il valore è già presente, v non viene modificato.
+
+		@param v valore da inserire nel MultiSet
+
+		@post Il numero totale di elementi è incrementato di 1
+	*/
+	void add(T &&v) {
+		add_helper(std::move(v));
+	}
+
+	/**
+		@brief Inserimento di un elemento costruito sul posto
+
+		@description
+		Il valore è costruito direttamente in un nuovo nodo a partire dagli argomenti args,
+		poi viene cercato nel MultiSet. Se è già presente, il nuovo nodo viene distrutto e
+		il numero di occorrenze del nodo esistente è incrementato di 1; altrimenti il nuovo
+		nodo è accodato alla sua lista, come in add().
+
+		@tparam Args tipi degli argomenti del costruttore di T
+
+		@param args argomenti del costruttore di T
+
+		@post Il numero totale di elementi è incrementato di 1
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	template <typename... Args>
+	void emplace(Args&&... args) {
+		if(_size == std::numeric_limits<std::size_t>::max())
+			throw multiset_count_overflow();
+		node *n = create_node(0, std::forward<Args>(args)...);
+		node *last;
+		node *curr;
+
+		try {
+			n->hash = hash_of(n->value);
+			curr = this->contains_at(n->value, n->hash, last);
+		}
+		catch(...) { // Eccezione lanciata dal funtore di hash o di uguaglianza
+			destroy_node(n);
+			throw;
+		}
+		if(curr != nullptr) {
+			destroy_node(n);
+			account(curr, curr->nocc, curr->nocc + 1);
+			curr->nocc++;
+		}
+		else
+			link_node(n, last);
+	}
+	
+	/**
+		@brief Numero di occorrenze di un elemento del MultiSet
+
+		@description
+		Questo metodo restituisce il numero di occorrenze di un elemento contenuto in un nodo.
+		Dato il valore v, si ricerca l'elemento nella lista e, se presente, viene restituito il suo
+		numero di occorrenze.
+
+		@param v valore di cui sapere il numero di occorrenze
+
+		@return numero di occorrenze se il valore è presente, 0 altrimenti (un elemento non presente ha 0 occorrenze)
+	*/
+	size_type nocc(const T &v) const {
+		node *curr = this->contains_at(v);
+		if(curr != nullptr)
+			return curr->nocc;
+		return 0;
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento, cercato tramite una chiave di tipo diverso
+
+		@description
+		Come contains(const K &), disponibile solo con funtori trasparenti.
+
+		@tparam K tipo della chiave, confrontabile con T dal funtore di uguaglianza
+
+		@param k chiave dell'elemento
+
+		@return numero di occorrenze dell'elemento uguale alla chiave, 0 se non presente
+	*/
+	template <typename K>
+	typename std::enable_if<key_lookup<K>::value, size_type>::type nocc(const K &k) const {
+		node *curr = this->contains_at(k);
+		return (curr == nullptr) ? 0 : curr->nocc;
+	}
+
+	/**
+		@brief Rimozione di un elemento dal MultiSet
+
+		@description
+		Questo metodo si occupa di cercare l'elemento da rimuovere e, se presente, ne riduce
+		il numero di occorrenze. Se il numero di occorrenze diventa 0, allora l'elemento viene
+		effettivamente cancellato dal MultiSet, tramite la funzione remove_helper(). Viene poi decrementata
+		la dimensione totale del MultiSet.
+		In caso l'elemento da eliminare non sia presente, viene lanciata un'eccezione custom con un messaggio.
+		
+		@pre L'elemento dev'essere presente nella lista
+		
+		@param v valore da rimuovere
+
+		@post Se l'elemento era presente, ne viene decrementato il numero di occorrenze
+		@post Se il numero di occorrenze (dopo il decremento) di un elemento è 0, la sua rimozione è lasciata al
+		metodo ausiliario remove_helper()
+		@post Il numero totale di elementi del MultiSet è diminuito di 1
+
+		@throw Eccezione custom per elemento non presente
+	*/
+	void remove(const T &v) {
+		node *prev;
+		node *curr = this->contains_at(v, hash_of(v), prev);
+
+		if(curr != nullptr) {
+			account(curr, curr->nocc, curr->nocc - 1);
+			curr->nocc--;
+			if(curr->nocc == 0)
+				remove_helper(curr, prev);
+			return;
+		}
+		else {
+			throw multiset_value_not_found();
+		}
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento dal MultiSet
+
+		@description
+		Come remove(const T &), ma il numero di occorrenze è decrementato di k con una sola
+		ricerca. Se il numero di occorrenze diventa 0, l'elemento viene cancellato dal MultiSet.
+		Se il valore ha meno di k occorrenze, viene lanciata un'eccezione custom e il MultiSet
+		non viene modificato.
+
+		@pre Il valore deve avere almeno k occorrenze
+
+		@param v valore da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@post Il numero di occorrenze di v ed il numero totale di elementi sono diminuiti di k
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove(const T &v, size_type k) {
+		remove_key(v, k);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento, cercato tramite una chiave di tipo diverso
+
+		@description
+		Come remove(const T &, size_type), disponibile solo con funtori trasparenti (vedi
+		contains(const K &)). L'elemento è cercato una sola volta, senza costruire un valore di tipo T.
+
+		@tparam K tipo della chiave, confrontabile con T dal funtore di uguaglianza
+
+		@param key chiave dell'elemento da rimuovere
+		@param k numero di occorrenze da rimuovere (default 1)
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	template <typename K>
+	typename std::enable_if<key_lookup<K>::value>::type remove(const K &key, size_type k = 1) {
+		remove_key(key, k);
+	}
+
+	/**
+		@brief Impostazione del numero di occorrenze di un elemento
+
+		@description
+		Il numero di occorrenze di v diventa k, con una sola ricerca: se k è 0 l'elemento viene
+		cancellato (se presente), se v non è presente viene inserito con k occorrenze.
+
+		@param v valore di cui impostare il numero di occorrenze
+		@param k nuovo numero di occorrenze
+
+		@post nocc(v) restituisce k
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	void set_count(const T &v, size_type k) {
+		std::size_t h = hash_of(v);
+		node *prev;
+		node *curr = this->contains_at(v, h, prev);
+		std::size_t old = (curr == nullptr) ? 0 : curr->nocc;
+
+		if(k > old && k - old > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		if(curr == nullptr) {
+			if(k > 0) {
+				node *tmp = create_node(h, v);
+				tmp->nocc = k;
+				link_node(tmp, prev);
+			}
+			return;
+		}
+		account(curr, old, k);
+		if(k == 0)
+			remove_helper(curr, prev);
+		else
+			curr->nocc = k;
+	}
+
+	// Operazioni con hash già rimescolato
+
+	/**
+		@brief Hash rimescolato di un valore
+
+		@description
+		È l'hash con cui il MultiSet cerca e memorizza v. Chi distribuisce i valori tra più
+		MultiSet dello stesso tipo (ad esempio ConcurrentMultiSet, per scegliere la partizione)
+		può calcolarlo una sola volta e passarlo a add_hashed(), nocc_hashed() e remove_hashed().
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash rimescolato di v
+	*/
+	std::size_t hash_value(const T &v) const {
+		return hash_of(v);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento, con hash già rimescolato
+
+		@pre h è uguale a hash_value(v) di un MultiSet dello stesso tipo
+
+		@param v valore da inserire
+		@param h hash rimescolato di v
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	void add_hashed(const T &v, std::size_t h, size_type k) {
+		add_count(v, h, k);
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento, con hash già rimescolato
+
+		@pre h è uguale a hash_value(v) di un MultiSet dello stesso tipo
+
+		@param v valore di cui sapere il numero di occorrenze
+		@param h hash rimescolato di v
+
+		@return numero di occorrenze di v, 0 se non è presente
+	*/
+	size_type nocc_hashed(const T &v, std::size_t h) const {
+		node *curr = this->contains_at(v, h);
+		return (curr == nullptr) ? 0 : curr->nocc;
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento, con hash già rimescolato
+
+		@pre h è uguale a hash_value(v) di un MultiSet dello stesso tipo
+
+		@param v valore da rimuovere
+		@param h hash rimescolato di v
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove_hashed(const T &v, std::size_t h, size_type k) {
+		remove_key(v, h, k);
+	}
+
+	/**
+		@brief Creazione di un MultiSet a partire da un insieme di elementi presi da
+		una sequenza identificata da due iteratori generici
+
+		@description
+		Questo metodo crea un Multiset, aggiungendo degli elementi presi da una sequenza
+		identificata da una coppia di iteratori, uno per l'inizio della sequenza ed uno
+		per la fine.
+		Gli elementi della sequenza non sono necessariamente di tipo T, pertanto al compilatore
+		è affidato il compito di effettuare l'eventuale conversione, tramite uno static cast a T.
+		Se gli elementi sono di tipo T e gli iteratori sono almeno di tipo forward, la sequenza
+		è scandita una sola volta e gli elementi uguali adiacenti sono inseriti con una sola ricerca
+		(vedi add(first, last)).
+		L'inserimento degli elementi ed il casting sono racchiusi in un blocco try-catch, che si 
+		occupa di intercettare un'eventuale eccezione, andando a svuotare il nuovo MultiSet creato e
+		rilanciando l'eccezione al chiamante.
+
+		@pre Il tipo dei valori della sequenza dev'essere castabile nel tipo T
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza generica da inserire nel MultiSet
+
+		@param begin iteratore che punta all'inizio della sequenza
+		@param end iteratore che punta alla fine della sequenza
+
+		@post Il numero di elementi inseriti nel MultiSet viene incrementato tante volte quanti sono
+		gli elementi che compongono la sequenza generica
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	MultiSet(IterT begin, IterT end) : _head(nullptr), _buckets(nullptr), _nbuckets(0), _distinct(0), _size(0), _fp(0), _top(nullptr) {
+		try {
+			add_range(begin, end, false);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			clear();
+			throw;
+		}
+	}
+
+	/**
+		@brief Creazione di un MultiSet a partire da una sequenza ordinata
+
+		@description
+		Come il costruttore da sequenza, ma gli elementi uguali della sequenza devono essere
+		adiacenti (ad esempio perché la sequenza è ordinata): ogni gruppo di elementi uguali
+		diventa un nodo senza alcuna ricerca, quindi il costo è lineare anche senza funtore di hash.
+		Senza funtore di hash, l'ordine di iterazione è quello della sequenza.
 
-		@param other MultiSet "sorgente" da copiare
+		@pre Gli elementi uguali della sequenza sono adiacenti
 
-		@return Riferimento al MultiSet corrente
+		@tparam IterT tipo degli iteratori che identificano la sequenza da inserire nel MultiSet
+
+		@param begin iteratore che punta all'inizio della sequenza
+		@param end iteratore che punta alla fine della sequenza
 
 		@throw Eccezione di allocazione di memoria
 	*/
-	MultiSet& operator=(const MultiSet &other) {
-		if(this != &other) {
-			MultiSet tmp(other);
-			std::swap(this->_head, tmp._head);
-			std::swap(this->_size, tmp._size);
+	template <typename IterT>
+	MultiSet(multiset_sorted_input_t, IterT begin, IterT end) : _head(nullptr), _buckets(nullptr), _nbuckets(0),
+		_distinct(0), _size(0), _fp(0), _top(nullptr) {
+		try {
+			add_range(begin, end, true);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			clear();
+			throw;
 		}
-		return *this;
 	}
 
 	/**
-		@brief Distruttore per MultiSet
+		@brief Inserimento di una sequenza di elementi nel MultiSet
 
-		@descrpition
-		Il distruttore del MultiSet sfrutta il metodo privato clear(), che si occupa
-		di distruggere tutti i nodi della lista, deallocando ricorsivamente la memoria
-		da loro occupata.
+		@description
+		Se gli elementi sono di tipo T e gli iteratori sono almeno di tipo forward, la sequenza
+		è scandita una sola volta: gli elementi uguali adiacenti sono raggruppati ed ogni gruppo
+		è inserito con una sola ricerca. Altrimenti gli elementi sono inseriti uno alla volta.
+		In caso di eccezione, gli elementi già inseriti restano nel MultiSet.
+		Il secondo parametro template esclude i tipi che non sono iteratori, così che una
+		chiamata come add(v, k) selezioni sempre l'inserimento di k occorrenze.
 
-		@post La memoria allocata da tutti gli elementi del MultiSet è deallocata
-		@post Tutte le locazioni di memoria per il MultiSet ed i suoi elementi non sono ora più valide
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+
+		@post Il numero totale di elementi è incrementato della lunghezza della sequenza
+
+		@throw Eccezione di allocazione di memoria
 	*/
-	~MultiSet() {
-		clear();
+	template <typename IterT, typename = typename std::iterator_traits<IterT>::iterator_category>
+	void add(IterT first, IterT last) {
+		add_range(first, last, false);
 	}
 
-	// Metodi pubblici non fondamentali
+	/**
+		@brief Inserimento di una sequenza ordinata di elementi nel MultiSet
+
+		@description
+		Come add(first, last), ma se il MultiSet è vuoto ogni gruppo di elementi uguali
+		diventa un nodo senza alcuna ricerca.
+
+		@pre Gli elementi uguali della sequenza sono adiacenti
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	void add(multiset_sorted_input_t, IterT first, IterT last) {
+		add_range(first, last, true);
+	}
 
 	/**
-		@brief Ricerca di un elemento nel MultiSet
+		@brief Preallocazione dei bucket per un numero atteso di elementi distinti
 
 		@description
-		Questo metodo si occupa di stabilire se un dato di tipo generico T è presente
-		o meno nel MultiSet. La ricerca avviene scorrendo la lista fino in fondo, o finchè
-		l'elemento viene trovato.
+		Con un funtore di hash, l'array dei bucket è ingrandito (una sola volta) fino ad
+		almeno n bucket, così che l'inserimento di n elementi distinti non richieda
+		ridimensionamenti successivi. Senza funtore di hash il metodo non ha effetto.
 
-		@param v elemento da cercare nel MultiSet
+		@param n numero atteso di elementi distinti
 
-		@return True se l'elemento è presenta, false altrimenti
+		@throw Eccezione di allocazione di memoria (il MultiSet resta invariato)
 	*/
-	bool contains(const T &v) const {
-		node *curr = _head;
+	void reserve(std::size_t n) {
+		if(!hashed || n <= min_buckets / 2 || n <= _nbuckets)
+			return;
+		std::size_t nb = min_buckets;
+		while(nb < n)
+			nb *= 2;
+		rehash(nb);
+	}
+
+	/**
+		@brief Operatore di uguaglianza tra due MultiSet
+
+		@description
+		Questo metodo si occupa di ridefinire l'operator==, per implementare un confronto
+		di uguaglianza tra due MultiSet.
+		Due MultiSet (dello stesso tipo) sono uguali se contengono i medesimi elementi, con lo stesso numero
+		di occorrenze per ciascun elemento.
+		Il controllo che entrambi i MultiSet contengano dati dello stesso tipo è affidata al compilatore.
+		Il primo controllo effettuato dal metodo è sul numero totale di elementi, di elementi distinti
+		e sull'impronta del contenuto (vedi fingerprint()): se uno dei tre differisce, i MultiSet
+		sono diversi e la risposta è data in tempo costante. L'impronta coincide con size() solo
+		senza funtore di hash e senza il confronto byte per byte: in quel caso due MultiSet
+		diversi della stessa dimensione sono confrontati elemento per elemento.
+		Altrimenti i due MultiSet sono scorsi in parallelo finché i nodi corrispondenti hanno lo stesso
+		valore e lo stesso numero di occorrenze (caso frequente per MultiSet copiati o costruiti nello
+		stesso ordine, in cui non serve alcuna ricerca); dal primo nodo diverso in poi, ogni elemento
+		del primo MultiSet è cercato nel secondo, tramite il valore dei nodi e del numero di occorrenze.
+		Nel caso un elemento non sia trovato o il suo numero di occorrenze non sia uguale in entrambi i MultiSet,
+		allora i due MultiSet non sono uguali. Senza hash e con il confronto byte per byte, la ricerca
+		usa i nodi del secondo MultiSet ordinati per byte.
 
+		@pre Il tipo di dati presenti nei MultiSet dev'essere lo stesso, per garantirne il confronto
+
+		@param other MultiSet con cui confrontare il primo
+
+		@return True se i due MultiSet sono uguali, false altrimenti
+	*/
+	bool operator==(const MultiSet &other) const {
+		if(this->size() != other.size() || this->_distinct != other._distinct || this->_fp != other._fp)
+			return false;
+		node *curr = this->first_node();
+		const node *theirs = other.first_node();
+		while(curr != nullptr && curr->hash == theirs->hash && curr->nocc == theirs->nocc &&
+			multiset_equal(_eql, curr->value, theirs->value)) {
+			curr = this->next_node(curr);
+			theirs = other.next_node(theirs);
+		}
+		node_index idx;
+		if(curr != nullptr && other.index_nodes(idx, indexed())) {
+			for(; curr != nullptr; curr = this->next_node(curr)) {
+				const node *tmp = find_indexed(idx, curr->value, indexed());
+				if(tmp == nullptr || tmp->nocc != curr->nocc)
+					return false;
+			}
+			return true;
+		}
 		while(curr != nullptr) {
-			if(_eql(curr->value, v))
-				return true;
-			curr = curr->next;
+			node *tmp = other.contains_at(curr->value, curr->hash);
+			if((tmp != nullptr) && (tmp->nocc == curr->nocc))
+				curr = this->next_node(curr);
+			else
+				return false;
 		}
-		return false;
+		return true;
 	}
 
 	/**
-		@brief Numero di elementi di un MultiSet
+		@brief Impronta del contenuto del MultiSet
 
-		@return numero totale di elementi di un MultiSet
+		@description
+		L'impronta è la somma, per ogni elemento distinto, del suo peso (ottenuto dall'hash)
+		moltiplicato per il numero di occorrenze: non dipende quindi dall'ordine di inserimento
+		né dal numero di bucket, ed è aggiornata in tempo costante ad ogni modifica.
+		MultiSet uguali hanno la stessa impronta; MultiSet con impronte diverse sono diversi.
+		Senza funtore di hash il peso è dato dall'hash dei byte dei valori, se il confronto è
+		byte per byte (multiset_bytewise_equal, ad esempio per gli interi o per strutture senza
+		byte di riempimento): anche un MultiSet di MultiSet senza hash esclude quindi in tempo
+		costante i MultiSet interni diversi della stessa dimensione. Negli altri casi l'impronta
+		coincide con il numero totale di elementi.
+
+		@return impronta del contenuto
 	*/
-	unsigned int size() const {
-		return _size;
+	std::size_t fingerprint() const {
+		return _fp;
 	}
 
 	/**
-		@brief Inserimento di un elemento nel MultiSet
+		@brief Valori con il maggior numero di occorrenze
 
 		@description
-		Questo metodo permette l'inserimento di un elemento nel MultiSet.
-		Il valore passato come parametro viene cercato all'interno del MultiSet e, se presente,
-		il numero di occorrenze nel nodo che lo contiene viene incrementato di 1.
-		Se il valore non è presente, allora viene creato un nuovo nodo, con valore dato e puntatore
-		al nodo successivo impostato a nullptr.
-		Seguono due sottocasi: se la lista è vuota (ovvero la testa punta a nullptr), allora il nuovo nodo 
-		diviene la testa della lista. Altrimenti, il metodo scorre la lista ed aggiunge il nuovo nodo alla fine
-		della stessa, avendo cura di aggiornare il puntatore next del nodo prima di quello inserito.
-		
-		@param v valore da inserire nel MultiSet
+		Senza indice, i nodi sono visitati una sola volta mantenendo un heap dei k nodi con
+		più occorrenze, in O(d log k); con l'indice attivo (vedi enable_top_index()) sono letti
+		i primi k nodi dell'indice, in O(k). A parità di occorrenze l'ordine non è specificato.
 
-		@post Se l'elemento era già presente nel MultiSet, il suo numero di occorrenze è incrementato di 1
-		@post Se la lista era vuota (elemento non presente), il puntatore alla testa viene aggiornato con l'elemento inserito
-		@post Se la lista non era vuota (elemento non presente), il nuovo elemento inserito è l'ultimo della lista
-		@post Il numero totale di elementi è incrementato di 1
-	*/
-	void add(const T &v) {
-		node *curr = this->contains_at(v);
+		@param k numero massimo di valori restituiti
 
-		_size++;
+		@return coppie (valore, numero di occorrenze) dei min(k, distinct_size()) valori più
+		frequenti, in ordine decrescente di occorrenze
 
-		if(curr != nullptr) {
-			curr->nocc++;
-			return;
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	std::vector<std::pair<T, size_type>> top_k(size_type k) const {
+		std::vector<std::pair<T, size_type>> res;
+		if(k > _distinct)
+			k = _distinct;
+		if(k == 0)
+			return res;
+		res.reserve(k);
+		if(_top != nullptr) {
+			typename top_index::const_iterator i = _top->begin();
+			for(; k > 0; --k, ++i)
+				res.push_back(std::pair<T, size_type>(i->second->value, i->first));
+			return res;
 		}
-		else {
-			node *tmp = new node(v, nullptr);
-			if(_head == nullptr)
-				_head = tmp;
-			else {
-				curr = _head;
-				while(curr->next != nullptr)
-					curr = curr->next;
-				curr->next = tmp;
+		std::vector<const node*> heap; // Heap con in cima il nodo meno frequente tra i k scelti
+		heap.reserve(k);
+		for(const node *curr = first_node(); curr != nullptr; curr = next_node(curr)) {
+			if(heap.size() < k) {
+				heap.push_back(curr);
+				std::push_heap(heap.begin(), heap.end(), more_frequent);
+			}
+			else if(curr->nocc > heap.front()->nocc) {
+				std::pop_heap(heap.begin(), heap.end(), more_frequent);
+				heap.back() = curr;
+				std::push_heap(heap.begin(), heap.end(), more_frequent);
 			}
 		}
+		std::sort_heap(heap.begin(), heap.end(), more_frequent);
+		for(std::size_t i = 0; i < heap.size(); ++i)
+			res.push_back(std::pair<T, size_type>(heap[i]->value, heap[i]->nocc));
+		return res;
 	}
-	
+
 	/**
-		@brief Numero di occorrenze di un elemento del MultiSet
+		@brief Valore con il maggior numero di occorrenze
 
 		@description
-		Questo metodo restituisce il numero di occorrenze di un elemento contenuto in un nodo.
-		Dato il valore v, si ricerca l'elemento nella lista e, se presente, viene restituito il suo
-		numero di occorrenze.
+		Costo O(d) senza indice, O(1) con l'indice attivo. A parità di occorrenze viene
+		restituito uno qualsiasi dei valori più frequenti.
 
-		@param v valore di cui sapere il numero di occorrenze
+		@return riferimento costante al valore più frequente
 
-		@return numero di occorrenze se il valore è presente, 0 altrimenti (un elemento non presente ha 0 occorrenze)
+		@throw multiset_value_not_found se il MultiSet è vuoto
 	*/
-	unsigned int nocc(const T &v) const {
-		node *curr = this->contains_at(v);
-		if(curr != nullptr)
-			return curr->nocc;
-		return 0;
+	const T& most_common() const {
+		if(_distinct == 0)
+			throw multiset_value_not_found();
+		if(_top != nullptr)
+			return _top->begin()->second->value;
+		const node *best = first_node();
+		for(const node *curr = next_node(best); curr != nullptr; curr = next_node(curr))
+			if(curr->nocc > best->nocc)
+				best = curr;
+		return best->value;
 	}
 
 	/**
-		@brief Rimozione di un elemento dal MultiSet
+		@brief Attivazione dell'indice dei valori più frequenti
 
 		@description
-		Questo metodo si occupa di cercare l'elemento da rimuovere e, se presente, ne riduce
-		il numero di occorrenze. Se il numero di occorrenze diventa 0, allora l'elemento viene
-		effettivamente cancellato dal MultiSet, tramite la funzione remove_helper(). Viene poi decrementata
-		la dimensione totale del MultiSet.
-		In caso l'elemento da eliminare non sia presente, viene lanciata un'eccezione custom con un messaggio.
-		
-		@pre L'elemento dev'essere presente nella lista
-		
-		@param v valore da rimuovere
-
-		@post Se l'elemento era presente, ne viene decrementato il numero di occorrenze
-		@post Se il numero di occorrenze (dopo il decremento) di un elemento è 0, la sua rimozione è lasciata al
-		metodo ausiliario remove_helper()
-		@post Il numero totale di elementi del MultiSet è diminuito di 1
-
-		@throw Eccezione custom per elemento non presente
+		L'indice ordina i nodi per numero di occorrenze ed è aggiornato ad ogni modifica, con
+		un costo aggiuntivo di O(log d) per ogni operazione che cambia un numero di occorrenze:
+		top_k() e most_common() non devono più visitare tutti i nodi. Le voci dell'indice sono
+		allocate in un multiset_pool_allocator proprio dell'indice (non con l'allocatore A): un
+		add() o remove() di un valore già presente sposta la voce senza allocare memoria, un
+		valore nuovo richiede una cella (un blocco al sistema ogni 256 voci). L'indice segue il
+		contenuto negli spostamenti e negli scambi, mentre una copia del MultiSet non lo attiva.
+		Se un aggiornamento non riesce ad allocare memoria, l'indice viene disattivato.
+
+		@post top_index_enabled() restituisce true
+
+		@throw Eccezione di allocazione di memoria (il MultiSet resta invariato)
 	*/
-	void remove(const T &v) {
-		node *curr = this->contains_at(v);
-
-		if(curr != nullptr) {
-			curr->nocc--;
-			if(curr->nocc == 0)
-				remove_helper(curr);
-			_size--;
+	void enable_top_index() {
+		if(_top != nullptr)
 			return;
+		top_index *idx = new top_index();
+		try {
+			fill_top(*idx);
 		}
-		else {
-			throw multiset_value_not_found();
+		catch(...) { // Eccezione di allocazione di memoria
+			delete idx;
+			throw;
 		}
+		_top = idx;
 	}
 
 	/**
-		@brief Creazione di un MultiSet a partire da un insieme di elementi presi da
-		una sequenza identificata da due iteratori generici
+		@brief Disattivazione dell'indice dei valori più frequenti
+
+		@post top_index_enabled() restituisce false
+	*/
+	void disable_top_index() {
+		delete _top;
+		_top = nullptr;
+	}
+
+	/**
+		@brief Stato dell'indice dei valori più frequenti
+
+		@return true se l'indice è attivo
+	*/
+	bool top_index_enabled() const {
+		return _top != nullptr;
+	}
+
+	// Operazioni insiemistiche
+
+	/**
+		@brief Somma di MultiSet
 
 		@description
-		Questo metodo crea un Multiset, aggiungendo (tramite add()) degli elementi presi da una sequenza
-		identificata da una coppia di iteratori, uno per l'inizio della sequenza ed uno
-		per la fine.
-		Gli elementi della sequenza non sono necessariamente di tipo T, pertanto al compilatore
-		è affidato il compito di effettuare l'eventuale conversione, tramite uno static cast a T.
-		L'inserimento degli elementi ed il casting sono racchiusi in un blocco try-catch, che si 
-		occupa di intercettare un'eventuale eccezione, andando a svuotare il nuovo MultiSet creato e
-		rilanciando l'eccezione al chiamante.
+		Le occorrenze di ogni elemento di other sono aggiunte a quelle del MultiSet corrente.
+		Ogni nodo di other è cercato una sola volta, usando il suo hash già calcolato: con un
+		funtore di hash il costo atteso è lineare nel numero di elementi distinti di other.
 
-		@pre Il tipo dei valori della sequenza dev'essere castabile nel tipo T
+		@param other MultiSet da sommare
 
-		@tparam IterT tipo degli iteratori che identificano la sequenza generica da inserire nel MultiSet
+		@return Riferimento al MultiSet corrente
 
-		@param begin iteratore che punta all'inizio della sequenza
-		@param end iteratore che punta alla fine della sequenza
+		@post nocc(v) è la somma dei numeri di occorrenze di v nei due MultiSet
 
-		@post Il numero di elementi inseriti nel MultiSet viene incrementato tante volte quanti sono
-		gli elementi che compongono la sequenza generica
-		@post L'iteratore begin di inizio sequenza punta ora alla fine della sequenza
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (il MultiSet resta invariato)
+	*/
+	MultiSet& operator+=(const MultiSet &other) {
+		if(other._size > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		if(this == &other) {
+			for(node *curr = first_node(); curr != nullptr; curr = next_node(curr))
+				curr->nocc *= 2;
+			_size *= 2;
+			_fp *= 2;
+			refresh_top();
+			return *this;
+		}
+		for(const node *curr = other.first_node(); curr != nullptr; curr = other.next_node(curr))
+			add_count(curr->value, curr->hash, curr->nocc);
+		return *this;
+	}
 
-		@throw Eccezione di allocazione di memoria
+	/**
+		@brief Unione di MultiSet
+
+		@description
+		Il numero di occorrenze di ogni elemento diventa il massimo tra quelli nei due MultiSet.
+		Ogni nodo di other è cercato una sola volta, usando il suo hash già calcolato: con un
+		funtore di hash il costo atteso è lineare nel numero di elementi distinti di other.
+
+		@param other MultiSet da unire
+
+		@return Riferimento al MultiSet corrente
+
+		@post nocc(v) è il massimo tra i numeri di occorrenze di v nei due MultiSet
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
 	*/
-	template <typename IterT>
-	MultiSet(IterT begin, IterT end) : _head(nullptr), _size(0) {
-		try {
-			while(begin != end) {
-				add(static_cast<T>(*begin));
-				++begin;
+	MultiSet& operator|=(const MultiSet &other) {
+		if(this == &other)
+			return *this;
+		for(const node *curr = other.first_node(); curr != nullptr; curr = other.next_node(curr)) {
+			node *last;
+			node *mine = this->contains_at(curr->value, curr->hash, last);
+			std::size_t old = (mine == nullptr) ? 0 : mine->nocc;
+			if(curr->nocc <= old)
+				continue;
+			if(curr->nocc - old > std::numeric_limits<std::size_t>::max() - _size)
+				throw multiset_count_overflow();
+			if(mine != nullptr) {
+				account(mine, old, curr->nocc);
+				mine->nocc = curr->nocc;
+			}
+			else {
+				node *tmp = create_node(curr->hash, curr->value);
+				tmp->nocc = curr->nocc;
+				link_node(tmp, last);
 			}
 		}
-		catch(...) { // Eccezione di allocazione di memoria
-			clear();
-			throw;
+		return *this;
+	}
+
+	/**
+		@brief Intersezione di MultiSet
+
+		@description
+		Il numero di occorrenze di ogni elemento diventa il minimo tra quelli nei due MultiSet:
+		gli elementi non presenti in other sono cancellati. Ogni nodo del MultiSet corrente è
+		cercato una sola volta in other: con un funtore di hash il costo atteso è lineare nel
+		numero di elementi distinti del MultiSet corrente; senza hash e con il confronto byte per
+		byte è O(d log d), cercando nei nodi di other ordinati per byte.
+
+		@param other MultiSet da intersecare
+
+		@return Riferimento al MultiSet corrente
+
+		@post nocc(v) è il minimo tra i numeri di occorrenze di v nei due MultiSet
+	*/
+	MultiSet& operator&=(const MultiSet &other) {
+		if(this == &other)
+			return *this;
+		node_index idx;
+		bool use_index = other.index_nodes(idx, indexed());
+		std::size_t nchains = (_nbuckets == 0) ? 1 : _nbuckets;
+		for(std::size_t i = 0; i < nchains; ++i) {
+			node *prev = nullptr;
+			node *curr = (_nbuckets == 0) ? _head : _buckets[i];
+			while(curr != nullptr) {
+				node *next = curr->next;
+				const node *theirs = use_index ? find_indexed(idx, curr->value, indexed()) :
+					other.contains_at(curr->value, curr->hash);
+				std::size_t k = (theirs == nullptr) ? 0 : theirs->nocc;
+				if(k == 0) {
+					account(curr, curr->nocc, 0);
+					remove_helper(curr, prev);
+				}
+				else {
+					if(k < curr->nocc) {
+						account(curr, curr->nocc, k);
+						curr->nocc = k;
+					}
+					prev = curr;
+				}
+				curr = next;
+			}
 		}
+		return *this;
 	}
 
 	/**
-		@brief Operatore di uguaglianza tra due MultiSet
+		@brief Differenza troncata di MultiSet
 
 		@description
-		Questo metodo si occupa di ridefinire l'operator==, per implementare un confronto
-		di uguaglianza tra due MultiSet.
-		Due MultiSet (dello stesso tipo) sono uguali se contengono i medesimi elementi, con lo stesso numero
-		di occorrenze per ciascun elemento.
-		Il controllo che entrambi i MultiSet contengano dati dello stesso tipo è affidata al compilatore.
-		Il primo controllo effettuato dal metodo è sul numero totale di elementi. In caso i due MultiSet
-		avessero lo stesso numero di elementi, si procede a scorrere la lista di elementi del primo MultiSet
-		e la si confronta con il secondo MultiSet, tramite il valore dei nodi e del numero di occorrenze.
-		Nel caso un elemento non sia trovato o il suo numero di occorrenze non sia uguale in entrambi i MultiSet,
-		allora i due MultiSet non sono uguali.
+		Il numero di occorrenze di ogni elemento è diminuito del numero di occorrenze in other,
+		senza scendere sotto 0: gli elementi che raggiungono 0 occorrenze sono cancellati.
+		Ogni nodo di other è cercato una sola volta: con un funtore di hash il costo atteso è
+		lineare nel numero di elementi distinti di other. Senza hash e con il confronto byte per
+		byte, sono invece i nodi del MultiSet corrente ad essere cercati tra quelli di other
+		ordinati per byte, in O(d log d).
+
+		@param other MultiSet da sottrarre
+
+		@return Riferimento al MultiSet corrente
+
+		@post nocc(v) è la differenza (o 0) tra i numeri di occorrenze di v nei due MultiSet
+	*/
+	MultiSet& operator-=(const MultiSet &other) {
+		if(this == &other) {
+			clear();
+			return *this;
+		}
+		node_index idx;
+		if(other.index_nodes(idx, indexed())) {
+			node *prev = nullptr;
+			node *curr = _head;
+			while(curr != nullptr) {
+				node *next = curr->next;
+				const node *theirs = find_indexed(idx, curr->value, indexed());
+				if(theirs == nullptr)
+					prev = curr;
+				else if(curr->nocc > theirs->nocc) {
+					account(curr, curr->nocc, curr->nocc - theirs->nocc);
+					curr->nocc -= theirs->nocc;
+					prev = curr;
+				}
+				else {
+					account(curr, curr->nocc, 0);
+					remove_helper(curr, prev);
+				}
+				curr = next;
+			}
+			return *this;
+		}
+		for(const node *curr = other.first_node(); curr != nullptr; curr = other.next_node(curr)) {
+			node *prev;
+			node *mine = this->contains_at(curr->value, curr->hash, prev);
+			if(mine == nullptr)
+				continue;
+			if(mine->nocc > curr->nocc) {
+				account(mine, mine->nocc, mine->nocc - curr->nocc);
+				mine->nocc -= curr->nocc;
+			}
+			else {
+				account(mine, mine->nocc, 0);
+				remove_helper(mine, prev);
+			}
+		}
+		return *this;
+	}
 
-		@pre Il tipo di dati presenti nei MultiSet dev'essere lo stesso, per garantirne il confronto
+	/**
+		@brief Inclusione tra MultiSet
 
-		@param other MultiSet con cui confrontare il primo
+		@description
+		Ogni nodo di other è cercato una sola volta: con un funtore di hash il costo atteso è
+		lineare nel numero di elementi distinti di other; senza hash e con il confronto byte per
+		byte è O(d log d), cercando nei nodi del MultiSet corrente ordinati per byte.
 
-		@return True se i due MultiSet sono uguali, false altrimenti
+		@param other MultiSet di cui verificare l'inclusione nel MultiSet corrente
+
+		@return True se ogni elemento di other compare nel MultiSet corrente almeno altrettante volte,
+		false altrimenti
 	*/
-	bool operator==(const MultiSet &other) const {
-		if(this->size() == other.size()) {
-			node *curr = this->_head;
-			while(curr != nullptr) {
-				node *tmp = other.contains_at(curr->value);
-				if((tmp != nullptr) && (tmp->nocc == curr->nocc))
-					curr = curr->next;
-				else
-					return false;
-			}
-			return true;
+	bool includes(const MultiSet &other) const {
+		if(other._size > _size || other._distinct > _distinct)
+			return false;
+		node_index idx;
+		bool use_index = other._distinct > index_min && index_nodes(idx, indexed());
+		for(const node *curr = other.first_node(); curr != nullptr; curr = other.next_node(curr)) {
+			const node *mine = use_index ? find_indexed(idx, curr->value, indexed()) :
+				this->contains_at(curr->value, curr->hash);
+			if(mine == nullptr || mine->nocc < curr->nocc)
+				return false;
 		}
-		return false;
+		return true;
 	}
 
 	// Supporto agli iteratori per un MultiSet
@@ -511,7 +2792,7 @@ public:
 			@description
 			Il costruttore di default istanzia un iteratore costante che punta a nullptr.
 		*/
-		const_iterator() : ptr(nullptr) {}
+		const_iterator() : ptr(nullptr), t(1), owner(nullptr) {}
 
 		/**
 			@brief Copy constructor dell'iteratore costante
@@ -522,7 +2803,7 @@ public:
 
 			@param other iteratore costante da copiare
 		*/
-		const_iterator(const const_iterator &other) : ptr(other.ptr) {}
+		const_iterator(const const_iterator &other) : ptr(other.ptr), t(other.t), owner(other.owner) {}
 
 		/**
 			@brief Operatore di assegnamento dell'iteratore costante
@@ -536,6 +2817,8 @@ public:
 		*/
 		const_iterator& operator=(const const_iterator &other) {
 			ptr = other.ptr;
+			t = other.t;
+			owner = other.owner;
 			return *this;
 		}
 
@@ -594,12 +2877,14 @@ public:
 			esterna al MultiSet
 		*/
 		const_iterator operator++(int) {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
 			if(ptr == nullptr)
 				throw multiset_iterator_out_of_bounds();
+#endif
 			if(t == ptr->nocc) {
 				t = 1;
 				const_iterator tmp(*this);
-				ptr = ptr->next;
+				ptr = owner->next_node(ptr);
 				return tmp;
 			}
 			else
@@ -625,11 +2910,13 @@ public:
 			esterna al MultiSet
 		*/
 		const_iterator& operator++() {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
 			if(ptr == nullptr)
 				throw multiset_iterator_out_of_bounds();
+#endif
 			if(t == ptr->nocc) {
 				t = 1;
-				ptr = ptr->next;
+				ptr = owner->next_node(ptr);
 			}
 			else
 				t++;
@@ -671,7 +2958,8 @@ public:
 		// Dati privati dell'iteratore costante
 
 		const node *ptr; ///< Puntatore ad un elemento costante della lista
-		unsigned int t; ///< Intero che memorizza il numero di occorrenze di un elemento della lista, usato negli operatori di incremento
+		std::size_t t; ///< Intero che memorizza il numero di occorrenze di un elemento della lista, usato negli operatori di incremento
+		const MultiSet *owner; ///< MultiSet su cui si itera, usato per passare da un bucket al successivo
 
 		friend class MultiSet; // La classe container che utilizza l'iteratore costante dev'essere friend della classe iteratore
 
@@ -682,11 +2970,11 @@ public:
 			Questo costruttore privato inizializza un iteratore costante, impostando il puntatore
 			ad un elemento n passato come parametro. Il dato membro t (che serve per contare le occorrenze)
 			è posto ad 1.
-			Il costruttore è explicit per evitare che il compilatore lo usi per effettuare conversioni implicite.
 
 			@param n puntatore ad un elemento costante della lista
+			@param ms MultiSet a cui appartiene l'elemento
 		*/
-		explicit const_iterator(const node *n) : ptr(n), t(1) {}
+		const_iterator(const node *n, const MultiSet *ms) : ptr(n), t(1), owner(ms) {}
 
 	}; // class const_iterator
 
@@ -696,12 +2984,12 @@ public:
 		@brief Iteratore costante che punta all'inizio del MultiSet
 
 		@description
-		L'iteratore punta all'elemento in testa.
+		L'iteratore punta al primo elemento (in testa alla lista o nel primo bucket non vuoto).
 
 		@return iteratore costante che punta all'inizio del MultiSet
 	*/
 	const_iterator begin() const {
-		return const_iterator(_head);
+		return const_iterator(first_node(), this);
 	}
 
 	/**
@@ -713,7 +3001,211 @@ public:
 		@return iteratore costante che punta alla fine del MultiSet
 	*/
 	const_iterator end() const {
-		return const_iterator(nullptr);
+		return const_iterator(nullptr, this);
+	}
+
+	/**
+		@brief Iteratore costante sugli elementi distinti del MultiSet
+
+		@description
+		A differenza di const_iterator, ogni nodo è visitato una sola volta: l'iteratore
+		restituisce la coppia (valore, numero di occorrenze), quindi scorrere il MultiSet
+		richiede distinct_size() passi invece di size().
+	*/
+	class distinct_iterator {
+
+	public:
+
+		// Traits dell'iteratore sugli elementi distinti
+
+		typedef std::forward_iterator_tag iterator_category; ///< Categoria dell'iteratore
+		typedef std::pair<const T&, size_type> value_type; ///< Coppia (valore, numero di occorrenze)
+		typedef ptrdiff_t difference_type; ///< Tipo per rappresentare la differenza tra due puntatori
+		typedef void pointer; ///< La coppia è restituita per valore: l'accesso tramite puntatore non è disponibile
+		typedef value_type reference; ///< Tipo restituito dal deferenziamento
+
+		/**
+			@brief Costruttore di default, che istanzia un iteratore che punta a nullptr
+		*/
+		distinct_iterator() : ptr(nullptr), owner(nullptr) {}
+
+		/**
+			@brief Operatore di deferenziamento
+
+			@return coppia formata dal valore del nodo puntato e dal suo numero di occorrenze
+		*/
+		reference operator*() const {
+			return value_type(ptr->value, ptr->nocc);
+		}
+
+		/**
+			@brief Valore del nodo puntato dall'iteratore
+
+			@return riferimento costante al valore
+		*/
+		const T& value() const {
+			return ptr->value;
+		}
+
+		/**
+			@brief Numero di occorrenze del valore puntato dall'iteratore
+
+			@return numero di occorrenze del valore
+		*/
+		size_type count() const {
+			return ptr->nocc;
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@pre L'iteratore deve puntare ad una locazione di memoria interna al MultiSet
+
+			@param int placeholder che distingue questo operatore da quello di pre-incremento
+
+			@return Copia dell'iteratore prima dell'incremento
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore punta ad una locazione di memoria
+			esterna al MultiSet
+		*/
+		distinct_iterator operator++(int) {
+			distinct_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@description
+			L'iteratore passa al nodo successivo, indipendentemente dal numero di occorrenze.
+
+			@pre L'iteratore deve puntare ad una locazione di memoria interna al MultiSet
+
+			@return Riferimento all'iteratore corrente, incrementato
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore punta ad una locazione di memoria
+			esterna al MultiSet
+		*/
+		distinct_iterator& operator++() {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
+			if(ptr == nullptr)
+				throw multiset_iterator_out_of_bounds();
+#endif
+			ptr = owner->next_node(ptr);
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore con cui confrontare quello corrente
+
+			@return true se i due iteratori puntano allo stesso elemento, false altrimenti
+		*/
+		bool operator==(const distinct_iterator &other) const {
+			return(ptr == other.ptr);
+		}
+
+		/**
+			@brief Operatore di disuguaglianza
+
+			@param other iteratore con cui confrontare quello corrente
+
+			@return true se i due iteratori non puntano allo stesso elemento, false altrimenti
+		*/
+		bool operator!=(const distinct_iterator &other) const {
+			return(ptr != other.ptr);
+		}
+
+	private:
+
+		const node *ptr; ///< Puntatore al nodo corrente
+		const MultiSet *owner; ///< MultiSet su cui si itera, usato per passare da un bucket al successivo
+
+		friend class MultiSet;
+
+		/**
+			@brief Costruttore privato
+
+			@param n puntatore al nodo corrente
+			@param ms MultiSet a cui appartiene il nodo
+		*/
+		distinct_iterator(const node *n, const MultiSet *ms) : ptr(n), owner(ms) {}
+
+	}; // class distinct_iterator
+
+	/**
+		@brief Intervallo degli elementi distinti del MultiSet, utilizzabile in un range-for
+
+		@description
+		L'intervallo fa riferimento al MultiSet, che deve sopravvivergli: viene invalidato
+		dalle stesse operazioni che invalidano gli iteratori.
+	*/
+	class distinct_range {
+
+		const MultiSet *owner; ///< MultiSet su cui si itera
+
+		friend class MultiSet;
+
+		/**
+			@brief Costruttore privato
+
+			@param ms MultiSet su cui si itera
+		*/
+		explicit distinct_range(const MultiSet *ms) : owner(ms) {}
+
+	public:
+
+		/**
+			@brief Iteratore al primo elemento distinto
+
+			@return iteratore che punta al primo nodo del MultiSet
+		*/
+		distinct_iterator begin() const {
+			return distinct_iterator(owner->first_node(), owner);
+		}
+
+		/**
+			@brief Iteratore alla fine dell'intervallo
+
+			@return iteratore che punta a nullptr
+		*/
+		distinct_iterator end() const {
+			return distinct_iterator(nullptr, owner);
+		}
+
+		/**
+			@brief Numero di elementi dell'intervallo
+
+			@return numero di elementi distinti del MultiSet
+		*/
+		size_type size() const {
+			return owner->distinct_size();
+		}
+
+		/**
+			@brief Verifica che l'intervallo sia vuoto
+
+			@return true se il MultiSet è vuoto, false altrimenti
+		*/
+		bool empty() const {
+			return owner->_distinct == 0;
+		}
+
+	}; // class distinct_range
+
+	/**
+		@brief Elementi distinti del MultiSet, con il rispettivo numero di occorrenze
+
+		@description
+		Esempio: for(auto e : ms.distinct()) os << e.first << " " << e.second;
+		L'ordine di visita è lo stesso di const_iterator.
+
+		@return intervallo degli elementi distinti del MultiSet
+	*/
+	distinct_range distinct() const {
+		return distinct_range(this);
 	}
 
 }; //class MultiSet
@@ -725,44 +3217,33 @@ public:
 
 	@description
 	L'operatore è ridefinito per inviare su stream il contenuto di un MultiSet.
-	L'invio in stream di un elemento del MultiSet è effettuata solo quando il suo numero di
-	occorrenze è stato consumato. L'ultimo elemento del MultiSet viene inviato in stream
-	quando l'incremento	dell'iteratore lo porterebbe alla fine del MultiSet.
-	Il formato di invio su stream è {<X1, OccorrenzeX1>, <X2, OccorrenzeX2>, ..., <Xn, OccorrenzeXn>}.
+	Gli elementi sono visitati tramite distinct(), una sola volta per ciascun valore distinto.
+	Il formato di invio su stream è {<X1, OccorrenzeX1>, <X2, OccorrenzeX2>, ..., <Xn, OccorrenzeXn>};
+	un MultiSet vuoto è inviato come {}.
 
 	@tparam T tipo del valore degli elementi del MultiSet da stampare
 	@tparam E funtore di uguaglianza del valore di due elementi di un MultiSet
+	@tparam H funtore di hash del valore degli elementi di un MultiSet
+	@tparam A allocatore dei nodi del MultiSet
+	@tparam N numero di nodi interni del MultiSet
 
 	@param os oggetto di stream output
 	@param ms MultiSet da stampare
 
 	@return riferimento allo stream di output
 */
-template <typename T, typename E>
-std::ostream &operator<<(std::ostream &os, const MultiSet<T,E> &ms) {
+template <typename T, typename E, typename H, typename A, std::size_t N>
+std::ostream &operator<<(std::ostream &os, const MultiSet<T,E,H,A,N> &ms) {
 
-	typename MultiSet<T,E>::const_iterator i = ms.begin(), ie = ms.end();
-	T curr_val;
-	unsigned int count;
-	
-	curr_val = *i;
-	count = 0;
+	typename MultiSet<T,E,H,A,N>::distinct_range r = ms.distinct();
 
 	os << "{";
 
-	while(i != ie) {
-		if(curr_val == *i)
-			count++;
-		else {
-			os << "<" << curr_val << ", " << count << ">";
-			if(i != ms.begin())
-				os << ", ";
-			curr_val = *i;
-			count = 1;
-		}
-		i++;
-		if(i == ms.end())
-			os << "<" << curr_val << ", " << count << ">";
+	typename MultiSet<T,E,H,A,N>::distinct_iterator i = r.begin(), ie = r.end();
+	for(bool first = true; i != ie; ++i, first = false) {
+		if(!first)
+			os << ", ";
+		os << "<" << i.value() << ", " << i.count() << ">";
 	}
 
 	os << "}";
@@ -770,6 +3251,280 @@ std::ostream &operator<<(std::ostream &os, const MultiSet<T,E> &ms) {
 	return os;
 }
 
+/**
+	@brief Scambio del contenuto di due MultiSet
+
+	@description
+	Versione globale di MultiSet::swap(), trovata tramite argument-dependent lookup
+	(ad esempio dagli algoritmi della libreria standard).
+
+	@tparam T tipo del valore degli elementi dei MultiSet
+	@tparam E funtore di uguaglianza del valore di due elementi di un MultiSet
+	@tparam H funtore di hash del valore degli elementi di un MultiSet
+	@tparam A allocatore dei nodi del MultiSet
+	@tparam N numero di nodi interni del MultiSet
+
+	@param a primo MultiSet
+	@param b secondo MultiSet
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+void swap(MultiSet<T,E,H,A,N> &a, MultiSet<T,E,H,A,N> &b) noexcept {
+	a.swap(b);
+}
+
+/**
+	@brief Funtore di hash per MultiSet
+
+	@description
+	Restituisce l'impronta del MultiSet (vedi MultiSet::fingerprint()), disponibile in tempo
+	costante e indipendente dall'ordine degli elementi: permette di usare un MultiSet come
+	elemento di un MultiSet con funtore di hash (ad esempio MultiSet di MultiSet).
+*/
+struct multiset_hash {
+	template <typename T, typename E, typename H, typename A, std::size_t N>
+	std::size_t operator()(const MultiSet<T,E,H,A,N> &ms) const {
+		return ms.fingerprint();
+	}
+};
+
+/**
+	@brief Somma di due MultiSet
+
+	@description
+	Viene copiato il MultiSet con più elementi distinti e vi viene sommato l'altro,
+	così che le ricerche siano effettuate per gli elementi del MultiSet più piccolo.
+
+	@param a primo MultiSet
+	@param b secondo MultiSet
+
+	@return nuovo MultiSet, somma di a e b
+
+	@throw Eccezione di allocazione di memoria o custom di numero di occorrenze fuori dai limiti
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+MultiSet<T,E,H,A,N> operator+(const MultiSet<T,E,H,A,N> &a, const MultiSet<T,E,H,A,N> &b) {
+	bool swapped = a.distinct_size() < b.distinct_size();
+	MultiSet<T,E,H,A,N> res(swapped ? b : a);
+	res += (swapped ? a : b);
+	return res;
+}
+
+/**
+	@brief Unione di due MultiSet
+
+	@description
+	Viene copiato il MultiSet con più elementi distinti e vi viene unito l'altro.
+
+	@param a primo MultiSet
+	@param b secondo MultiSet
+
+	@return nuovo MultiSet, unione di a e b (massimo dei numeri di occorrenze)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+MultiSet<T,E,H,A,N> operator|(const MultiSet<T,E,H,A,N> &a, const MultiSet<T,E,H,A,N> &b) {
+	bool swapped = a.distinct_size() < b.distinct_size();
+	MultiSet<T,E,H,A,N> res(swapped ? b : a);
+	res |= (swapped ? a : b);
+	return res;
+}
+
+/**
+	@brief Intersezione di due MultiSet
+
+	@description
+	Viene copiato il MultiSet con meno elementi distinti e lo si interseca con l'altro.
+
+	@param a primo MultiSet
+	@param b secondo MultiSet
+
+	@return nuovo MultiSet, intersezione di a e b (minimo dei numeri di occorrenze)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+MultiSet<T,E,H,A,N> operator&(const MultiSet<T,E,H,A,N> &a, const MultiSet<T,E,H,A,N> &b) {
+	bool swapped = b.distinct_size() < a.distinct_size();
+	MultiSet<T,E,H,A,N> res(swapped ? b : a);
+	res &= (swapped ? a : b);
+	return res;
+}
+
+/**
+	@brief Differenza troncata di due MultiSet
+
+	@param a primo MultiSet
+	@param b secondo MultiSet
+
+	@return nuovo MultiSet, con le occorrenze di a diminuite di quelle di b (senza scendere sotto 0)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+MultiSet<T,E,H,A,N> operator-(const MultiSet<T,E,H,A,N> &a, const MultiSet<T,E,H,A,N> &b) {
+	MultiSet<T,E,H,A,N> res(a);
+	res -= b;
+	return res;
+}
+
+/**
+	@brief Accesso ai nodi di un MultiSet per le estensioni che li collegano direttamente
+
+	@description
+	È l'unica classe amica di MultiSet: le estensioni che costruiscono un MultiSet spostando
+	nodi già esistenti invece di inserire valori (ad esempio multiset_parallel_build()) usano
+	queste operazioni, senza dipendere dalla rappresentazione interna. Le operazioni non
+	verificano gli invarianti del MultiSet: sono a carico del chiamante, come indicato dalle
+	precondizioni. Le operazioni sui valori con hash già calcolato sono invece pubbliche
+	(MultiSet::add_hashed() e seguenti).
+*/
+struct multiset_access {
+
+	/**
+		@brief Tipo dei nodi di un MultiSet
+
+		@tparam MS tipo del MultiSet
+	*/
+	template <typename MS>
+	struct node_of {
+		typedef typename MS::node type; ///< Tipo dei nodi di MS
+	};
+
+	/**
+		@brief Numero di bucket allocati al primo rehash
+
+		@tparam MS tipo del MultiSet
+
+		@return numero minimo di bucket di MS
+	*/
+	template <typename MS>
+	static std::size_t min_buckets() {
+		return MS::min_buckets;
+	}
+
+	/**
+		@brief Primo nodo di un MultiSet
+
+		@param ms MultiSet
+
+		@return primo nodo, nullptr se ms è vuoto
+	*/
+	template <typename MS>
+	static const typename MS::node* first(const MS &ms) {
+		return ms.first_node();
+	}
+
+	/**
+		@brief Nodo successivo di un MultiSet
+
+		@param ms MultiSet
+		@param n nodo di ms
+
+		@return nodo successivo ad n, nullptr se n è l'ultimo
+	*/
+	template <typename MS>
+	static const typename MS::node* next(const MS &ms, const typename MS::node *n) {
+		return ms.next_node(n);
+	}
+
+	/**
+		@brief Spostamento dei nodi interni nella memoria dell'allocatore
+
+		@param ms MultiSet
+
+		@post ms non usa nodi interni
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di T (ms resta invariato)
+	*/
+	template <typename MS>
+	static void spill(MS &ms) {
+		typename MS::node *none = nullptr;
+		if(ms._inline.used() > 0)
+			ms.spill(none);
+	}
+
+	/**
+		@brief Allocazione dei bucket di un MultiSet vuoto
+
+		@pre ms è vuoto e non ha bucket; n è una potenza di 2
+
+		@param ms MultiSet
+		@param n numero di bucket
+
+		@throw Eccezione di allocazione di memoria (ms resta invariato)
+	*/
+	template <typename MS>
+	static void allocate_buckets(MS &ms, std::size_t n) {
+		ms._buckets = ms.create_buckets(n);
+		ms._nbuckets = n;
+	}
+
+	/**
+		@brief Spostamento di tutti i nodi di un MultiSet nei bucket di un altro
+
+		@description
+		I nodi non sono copiati: sono scollegati da from e inseriti in testa ai bucket di to,
+		dopo averne corretto l'hash con fix. I contatori di to non sono aggiornati, così che più
+		thread possano spostare in to i nodi di MultiSet diversi, purché su bucket disgiunti;
+		vanno impostati al termine con set_totals().
+
+		@pre to ha i bucket allocati; from e to hanno allocatori intercambiabili e from non usa
+		nodi interni; i bucket di to raggiunti da from non sono modificati da altri thread
+
+		@param from MultiSet da svuotare
+		@param to MultiSet che riceve i nodi
+		@param fix funzione che restituisce l'hash di un nodo in to dato quello in from
+
+		@return contributo dei nodi spostati all'impronta di to
+
+		@post from è vuoto
+	*/
+	template <typename MS, typename F>
+	static std::size_t splice(MS &from, MS &to, F fix) {
+		typedef typename MS::node node;
+		std::size_t fp = 0;
+		std::size_t nchains = (from._nbuckets == 0) ? 1 : from._nbuckets;
+		for(std::size_t i = 0; i < nchains; ++i) {
+			node *&src = (from._nbuckets == 0) ? from._head : from._buckets[i];
+			node *curr = src;
+			while(curr != nullptr) {
+				node *tmp = curr->next;
+				curr->hash = fix(curr->hash);
+				node *&dst = to._buckets[curr->hash & (to._nbuckets - 1)];
+				curr->next = dst;
+				dst = curr;
+				fp += MS::weight(curr->hash) * curr->nocc;
+				curr = tmp;
+			}
+			src = nullptr;
+		}
+		from._head = nullptr;
+		from._distinct = 0;
+		from._size = 0;
+		from._fp = 0;
+		return fp;
+	}
+
+	/**
+		@brief Impostazione dei contatori di un MultiSet costruito con splice()
+
+		@param ms MultiSet
+		@param distinct numero di elementi distinti
+		@param size numero totale di elementi
+		@param fp impronta del contenuto
+
+		@pre I valori corrispondono ai nodi collegati in ms
+	*/
+	template <typename MS>
+	static void set_totals(MS &ms, std::size_t distinct, std::size_t size, std::size_t fp) {
+		ms._distinct = distinct;
+		ms._size = size;
+		ms._fp = fp;
+	}
+
+}; // struct multiset_access
+
 #endif
 
 // Fine multiset.h
\ No newline at end of file
@@ -0,0 +1,850 @@
+/**
+	@headerfile multiset_binary.h
+
+	@brief Formato binario compatto per MultiSet: scrittura e lettura da stream
+	(multiset_write, multiset_read) e vista in sola lettura di un file mappato in memoria
+	(classe MappedMultiSet).
+
+	@description
+	Il formato è composto da un'intestazione di 40 byte, dai record e da un indice opzionale:
+
+	- intestazione: "MSB1", versione, numero di elementi, numero di elementi distinti,
+	  lunghezza in byte dei record, numero di posizioni dell'indice (0 se assente);
+	- record: per ogni valore distinto, il numero di occorrenze (varint) seguito dal valore,
+	  codificato da multiset_codec<T>;
+	- indice, scritto solo per i MultiSet con funtore di hash: tabella a indirizzamento aperto,
+	  allineata a 8 byte, in cui ogni posizione contiene la posizione del record nel file
+	  aumentata di 1 (40 bit, 0 per le posizioni vuote) e 24 bit dell'hash del valore.
+
+	Gli interi di lunghezza fissa sono little-endian su ogni macchina. I codec sono forniti
+	per i tipi interi, float, double, std::string e MultiSet annidati; per gli altri tipi
+	multiset_codec va specializzato (vedi point e person in main.cpp).
+	L'indice usa il funtore di hash del MultiSet scritto: MappedMultiSet va istanziato con lo
+	stesso funtore, che deve dare gli stessi valori in scrittura ed in lettura (std::hash
+	lo garantisce solo per la stessa implementazione della libreria standard).
+*/
+
+// Guardie
+
+#ifndef MULTISET_BINARY_H
+#define MULTISET_BINARY_H
+
+// Direttive pre-compilatore
+
+#include <algorithm> // std::min, std::swap
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy, std::memcmp
+#include <fstream> // std::ifstream
+#include <istream> // std::istream
+#include <iterator> // std::istreambuf_iterator
+#include <limits> // std::numeric_limits
+#include <ostream> // std::ostream
+#include <string> // std::string
+#include <type_traits> // std::enable_if, std::is_integral, std::is_signed, std::is_same
+#include <utility> // std::move, std::pair
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_bad_format, multiset_io_error
+#include "multiset_equal.h" // multiset_equal
+#include "multiset.h" // Classe MultiSet, multiset_no_hash, multiset_mix
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+#define MULTISET_BINARY_MMAP
+#endif
+
+/**
+	@brief Scrittura sequenziale dei dati binari in un buffer
+*/
+class multiset_writer {
+
+	std::string &_out; ///< Buffer in cui sono accodati i byte
+
+public:
+
+	/**
+		@brief Costruttore
+
+		@param out buffer in cui accodare i byte
+	*/
+	explicit multiset_writer(std::string &out) : _out(out) {}
+
+	/**
+		@brief Numero di byte presenti nel buffer
+
+		@return lunghezza del buffer
+	*/
+	std::size_t size() const {
+		return _out.size();
+	}
+
+	/**
+		@brief Scrittura di un intero senza segno in formato varint
+
+		@description
+		7 bit per byte, dal meno significativo; il bit più alto indica che segue un altro byte.
+		I valori minori di 128 occupano un solo byte.
+
+		@param v intero da scrivere
+	*/
+	void put_varint(unsigned long long v) {
+		char buf[10];
+		std::size_t n = 0;
+		for(; v >= 0x80; v >>= 7)
+			buf[n++] = static_cast<char>((v & 0x7f) | 0x80);
+		buf[n++] = static_cast<char>(v);
+		_out.append(buf, n);
+	}
+
+	/**
+		@brief Scrittura di un intero senza segno su un numero fisso di byte, little-endian
+
+		@param v intero da scrivere
+		@param n numero di byte (al più 8)
+	*/
+	void put_fixed(unsigned long long v, std::size_t n) {
+		char buf[8];
+		for(std::size_t i = 0; i < n; ++i, v >>= 8)
+			buf[i] = static_cast<char>(v & 0xff);
+		_out.append(buf, n);
+	}
+
+	/**
+		@brief Scrittura di una sequenza di byte
+
+		@param p primo byte
+		@param n numero di byte
+	*/
+	void put_bytes(const char *p, std::size_t n) {
+		_out.append(p, n);
+	}
+};
+
+/**
+	@brief Lettura sequenziale dei dati binari da un intervallo di memoria
+
+	@description
+	Ogni lettura verifica di non superare la fine dell'intervallo.
+*/
+class multiset_reader {
+
+	const unsigned char *_p; ///< Prossimo byte da leggere
+	const unsigned char *_end; ///< Fine dell'intervallo
+
+public:
+
+	/**
+		@brief Costruttore
+
+		@param p primo byte dell'intervallo
+		@param end fine dell'intervallo
+	*/
+	multiset_reader(const char *p, const char *end) :
+		_p(reinterpret_cast<const unsigned char*>(p)), _end(reinterpret_cast<const unsigned char*>(end)) {}
+
+	/**
+		@brief Posizione corrente
+
+		@return puntatore al prossimo byte da leggere
+	*/
+	const char* position() const {
+		return reinterpret_cast<const char*>(_p);
+	}
+
+	/**
+		@brief Numero di byte ancora da leggere
+
+		@return byte tra la posizione corrente e la fine dell'intervallo
+	*/
+	std::size_t remaining() const {
+		return static_cast<std::size_t>(_end - _p);
+	}
+
+	/**
+		@brief Lettura di un intero senza segno in formato varint
+
+		@return intero letto
+
+		@throw multiset_bad_format se l'intervallo finisce prima dell'intero o se
+		l'intero supera i 64 bit
+	*/
+	unsigned long long get_varint() {
+		unsigned long long v = 0;
+		for(unsigned shift = 0; shift < 64; shift += 7) {
+			if(_p == _end)
+				throw multiset_bad_format();
+			unsigned long long b = *_p++;
+			if(shift == 63 && b > 1)
+				throw multiset_bad_format();
+			v |= (b & 0x7f) << shift;
+			if(b < 0x80)
+				return v;
+		}
+		throw multiset_bad_format();
+	}
+
+	/**
+		@brief Lettura di un intero senza segno da un numero fisso di byte, little-endian
+
+		@param n numero di byte (al più 8)
+
+		@return intero letto
+
+		@throw multiset_bad_format se l'intervallo finisce prima dell'intero
+	*/
+	unsigned long long get_fixed(std::size_t n) {
+		if(remaining() < n)
+			throw multiset_bad_format();
+		unsigned long long v = 0;
+		for(std::size_t i = 0; i < n; ++i)
+			v |= static_cast<unsigned long long>(_p[i]) << (8 * i);
+		_p += n;
+		return v;
+	}
+
+	/**
+		@brief Lettura di una sequenza di byte, senza copiarli
+
+		@param n numero di byte
+
+		@return puntatore al primo byte della sequenza, valido quanto l'intervallo
+
+		@throw multiset_bad_format se l'intervallo finisce prima della sequenza
+	*/
+	const char* get_bytes(std::size_t n) {
+		if(remaining() < n)
+			throw multiset_bad_format();
+		const char *p = position();
+		_p += n;
+		return p;
+	}
+};
+
+/**
+	@brief Codifica binaria di un valore
+
+	@description
+	Ogni specializzazione definisce:
+
+	static void write(multiset_writer &w, const T &v);
+	static T read(multiset_reader &r);
+
+	read() deve lanciare multiset_bad_format se i dati non sono validi. Il template generale
+	non è definito: scrivere un MultiSet di un tipo senza codec non compila.
+
+	@tparam T tipo del valore
+*/
+template <typename T, typename = void>
+struct multiset_codec;
+
+/**
+	@brief Codec degli interi senza segno (compreso bool): varint
+*/
+template <typename T>
+struct multiset_codec<T, typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type> {
+	static void write(multiset_writer &w, T v) {
+		w.put_varint(v);
+	}
+
+	static T read(multiset_reader &r) {
+		unsigned long long v = r.get_varint();
+		if(v > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+			throw multiset_bad_format();
+		return static_cast<T>(v);
+	}
+};
+
+/**
+	@brief Codec degli interi con segno: varint del valore in codifica zigzag
+
+	@description
+	0, -1, 1, -2, ... diventano 0, 1, 2, 3, ...: i valori piccoli in modulo occupano
+	pochi byte anche se negativi.
+*/
+template <typename T>
+struct multiset_codec<T, typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type> {
+	static void write(multiset_writer &w, T v) {
+		long long x = v;
+		w.put_varint((static_cast<unsigned long long>(x) << 1) ^ static_cast<unsigned long long>(x >> 63));
+	}
+
+	static T read(multiset_reader &r) {
+		unsigned long long u = r.get_varint();
+		long long x = static_cast<long long>(u >> 1) ^ -static_cast<long long>(u & 1);
+		if(x < std::numeric_limits<T>::min() || x > std::numeric_limits<T>::max())
+			throw multiset_bad_format();
+		return static_cast<T>(x);
+	}
+};
+
+/**
+	@brief Codec di float: 4 byte della rappresentazione IEEE 754
+*/
+template <>
+struct multiset_codec<float> {
+	static void write(multiset_writer &w, float v) {
+		unsigned int bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		w.put_fixed(bits, 4);
+	}
+
+	static float read(multiset_reader &r) {
+		unsigned int bits = static_cast<unsigned int>(r.get_fixed(4));
+		float v;
+		std::memcpy(&v, &bits, sizeof(v));
+		return v;
+	}
+};
+
+/**
+	@brief Codec di double: 8 byte della rappresentazione IEEE 754
+*/
+template <>
+struct multiset_codec<double> {
+	static void write(multiset_writer &w, double v) {
+		unsigned long long bits;
+		std::memcpy(&bits, &v, sizeof(bits));
+		w.put_fixed(bits, 8);
+	}
+
+	static double read(multiset_reader &r) {
+		unsigned long long bits = r.get_fixed(8);
+		double v;
+		std::memcpy(&v, &bits, sizeof(v));
+		return v;
+	}
+};
+
+/**
+	@brief Codec di std::string: lunghezza (varint) seguita dai caratteri
+*/
+template <>
+struct multiset_codec<std::string> {
+	static void write(multiset_writer &w, const std::string &s) {
+		w.put_varint(s.size());
+		w.put_bytes(s.data(), s.size());
+	}
+
+	static std::string read(multiset_reader &r) {
+		unsigned long long n = r.get_varint();
+		if(n > r.remaining())
+			throw multiset_bad_format();
+		return std::string(r.get_bytes(static_cast<std::size_t>(n)), static_cast<std::size_t>(n));
+	}
+};
+
+/**
+	@brief Lettura di un record (numero di occorrenze e valore) ed inserimento nel MultiSet
+
+	@param r lettore posizionato all'inizio del record
+	@param ms MultiSet a cui aggiungere il valore
+
+	@throw multiset_bad_format se il record non è valido, eccezione di allocazione di memoria
+	o custom di numero di occorrenze fuori dai limiti
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+void multiset_read_record(multiset_reader &r, MultiSet<T,E,H,A,N> &ms) {
+	unsigned long long k = r.get_varint();
+	if(k == 0 || k > std::numeric_limits<typename MultiSet<T,E,H,A,N>::size_type>::max())
+		throw multiset_bad_format();
+	T v = multiset_codec<T>::read(r);
+	if(k == 1)
+		ms.add(std::move(v));
+	else
+		ms.add(v, static_cast<typename MultiSet<T,E,H,A,N>::size_type>(k));
+}
+
+/**
+	@brief Codec di un MultiSet annidato: numero di elementi distinti (varint) seguito
+	dai record, nello stesso formato di quelli del file
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+struct multiset_codec<MultiSet<T,E,H,A,N>> {
+	static void write(multiset_writer &w, const MultiSet<T,E,H,A,N> &ms) {
+		w.put_varint(ms.distinct_size());
+		typename MultiSet<T,E,H,A,N>::distinct_range r = ms.distinct();
+		for(typename MultiSet<T,E,H,A,N>::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			w.put_varint(i.count());
+			multiset_codec<T>::write(w, i.value());
+		}
+	}
+
+	static MultiSet<T,E,H,A,N> read(multiset_reader &r) {
+		unsigned long long distinct = r.get_varint();
+		if(distinct > r.remaining()) // Ogni record occupa almeno un byte
+			throw multiset_bad_format();
+		MultiSet<T,E,H,A,N> ms;
+		ms.reserve(static_cast<std::size_t>(distinct));
+		for(unsigned long long i = 0; i < distinct; ++i)
+			multiset_read_record(r, ms);
+		if(ms.distinct_size() != distinct)
+			throw multiset_bad_format();
+		return ms;
+	}
+};
+
+/**
+	@brief Costanti del formato binario
+*/
+struct multiset_binary_format {
+	static const char* magic() {
+		return "MSB1";
+	}
+
+	enum : std::size_t {
+		version = 1, ///< Versione del formato
+		header_size = 40, ///< Byte dell'intestazione
+		offset_bits = 40, ///< Bit della posizione di un record in una posizione dell'indice
+		tag_bits = 24 ///< Bit dell'hash in una posizione dell'indice
+	};
+
+	/**
+		@brief Hash di un valore usato dall'indice
+
+		@param h valore restituito dal funtore di hash
+
+		@return hash rimescolato a 64 bit
+	*/
+	static unsigned long long mix(std::size_t h) {
+		return multiset_mix(h);
+	}
+
+	/**
+		@brief Bit dell'hash confrontati prima di decodificare un record
+
+		@param h hash rimescolato
+
+		@return i 24 bit più significativi dei 64 bit dell'hash
+	*/
+	static unsigned long long tag(unsigned long long h) {
+		return h >> (64 - tag_bits);
+	}
+};
+
+/**
+	@brief Scrittura di un MultiSet in formato binario su stream
+
+	@description
+	I dati sono preparati in memoria e scritti con una sola operazione: lo stream va
+	aperto in modalità binaria. Più MultiSet possono essere scritti uno dopo l'altro
+	sullo stesso stream.
+
+	@tparam T tipo del valore degli elementi del MultiSet (con un multiset_codec<T>)
+	@tparam E funtore di uguaglianza del valore di due elementi di un MultiSet
+	@tparam H funtore di hash del valore degli elementi di un MultiSet
+	@tparam A allocatore dei nodi del MultiSet
+	@tparam N numero di nodi interni del MultiSet
+
+	@param os stream di output binario
+	@param ms MultiSet da scrivere
+
+	@throw multiset_io_error se la scrittura sullo stream fallisce, multiset_bad_format
+	se i record superano la dimensione indirizzabile dall'indice (1 TiB)
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+void multiset_write(std::ostream &os, const MultiSet<T,E,H,A,N> &ms) {
+	typedef multiset_binary_format fmt;
+	const bool indexed = !std::is_same<H, multiset_no_hash>::value && ms.distinct_size() > 0;
+
+	std::string out(fmt::header_size, '\0');
+	multiset_writer w(out);
+	std::vector<std::pair<unsigned long long, std::size_t>> entries; // (hash, posizione del record)
+	if(indexed)
+		entries.reserve(ms.distinct_size());
+	H hash;
+	typename MultiSet<T,E,H,A,N>::distinct_range r = ms.distinct();
+	for(typename MultiSet<T,E,H,A,N>::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+		if(indexed)
+			entries.push_back(std::make_pair(fmt::mix(hash(i.value())), w.size()));
+		w.put_varint(i.count());
+		multiset_codec<T>::write(w, i.value());
+	}
+	const std::size_t records = out.size() - fmt::header_size;
+
+	std::size_t slots = 0;
+	if(indexed) {
+		if(out.size() >= (1ULL << fmt::offset_bits) - 1)
+			throw multiset_bad_format();
+		slots = 16;
+		while(slots < 2 * entries.size())
+			slots *= 2;
+		std::vector<unsigned long long> index(slots, 0);
+		for(std::size_t e = 0; e < entries.size(); ++e) {
+			std::size_t j = static_cast<std::size_t>(entries[e].first) & (slots - 1);
+			while(index[j] != 0)
+				j = (j + 1) & (slots - 1);
+			index[j] = (fmt::tag(entries[e].first) << fmt::offset_bits) | (entries[e].second + 1);
+		}
+		out.append((8 - out.size() % 8) % 8, '\0');
+		out.reserve(out.size() + 8 * slots);
+		for(std::size_t j = 0; j < slots; ++j)
+			w.put_fixed(index[j], 8);
+	}
+
+	std::string header;
+	multiset_writer h(header);
+	h.put_bytes(fmt::magic(), 4);
+	h.put_fixed(fmt::version, 4);
+	h.put_fixed(ms.size(), 8);
+	h.put_fixed(ms.distinct_size(), 8);
+	h.put_fixed(records, 8);
+	h.put_fixed(slots, 8);
+	out.replace(0, fmt::header_size, header);
+
+	if(!os.write(out.data(), static_cast<std::streamsize>(out.size())))
+		throw multiset_io_error();
+}
+
+/**
+	@brief Lettura di un MultiSet in formato binario da stream
+
+	@description
+	Il contenuto del MultiSet è sostituito solo se la lettura ha successo; in caso di
+	eccezione il MultiSet non viene modificato. Lo stream resta posizionato dopo i dati
+	letti (compreso l'indice, che non viene usato). I tipi T, E ed H non devono coincidere
+	con quelli del MultiSet scritto, purché il codec del valore sia lo stesso.
+
+	@tparam T tipo del valore degli elementi del MultiSet (con un multiset_codec<T>)
+	@tparam E funtore di uguaglianza del valore di due elementi di un MultiSet
+	@tparam H funtore di hash del valore degli elementi di un MultiSet
+	@tparam A allocatore dei nodi del MultiSet
+	@tparam N numero di nodi interni del MultiSet
+
+	@param is stream di input binario
+	@param ms MultiSet in cui leggere i dati
+
+	@throw multiset_bad_format se i dati non sono validi, multiset_io_error se la lettura
+	dallo stream fallisce prima della fine dell'intestazione, eccezione di allocazione di memoria
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+void multiset_read(std::istream &is, MultiSet<T,E,H,A,N> &ms) {
+	typedef multiset_binary_format fmt;
+	char header[fmt::header_size];
+	if(!is.read(header, fmt::header_size))
+		throw multiset_io_error();
+	multiset_reader hr(header, header + fmt::header_size);
+	if(std::memcmp(hr.get_bytes(4), fmt::magic(), 4) != 0 || hr.get_fixed(4) != fmt::version)
+		throw multiset_bad_format();
+	unsigned long long size = hr.get_fixed(8);
+	unsigned long long distinct = hr.get_fixed(8);
+	unsigned long long records = hr.get_fixed(8);
+	unsigned long long slots = hr.get_fixed(8);
+	if(distinct > records || size < distinct ||
+		(slots > 0 && ((slots & (slots - 1)) != 0 || slots < 2 * distinct || slots > (1ULL << fmt::offset_bits))))
+		throw multiset_bad_format();
+
+	// A blocchi, per non allocare subito una lunghezza letta da dati corrotti
+	std::string data;
+	while(data.size() < records) {
+		std::size_t chunk = static_cast<std::size_t>(std::min<unsigned long long>(records - data.size(), 1 << 20));
+		std::size_t old = data.size();
+		data.resize(old + chunk);
+		if(!is.read(&data[old], static_cast<std::streamsize>(chunk)))
+			throw multiset_bad_format();
+	}
+	if(slots > 0) {
+		std::size_t skip = static_cast<std::size_t>((8 - (fmt::header_size + records) % 8) % 8 + 8 * slots);
+		if(!is.ignore(static_cast<std::streamsize>(skip)) || static_cast<std::size_t>(is.gcount()) != skip)
+			throw multiset_bad_format();
+	}
+
+	MultiSet<T,E,H,A,N> tmp;
+	tmp.reserve(static_cast<std::size_t>(distinct));
+	multiset_reader r(data.data(), data.data() + data.size());
+	for(unsigned long long i = 0; i < distinct; ++i)
+		multiset_read_record(r, tmp);
+	if(r.remaining() != 0 || tmp.distinct_size() != distinct || tmp.size() != size)
+		throw multiset_bad_format();
+	ms.swap(tmp);
+}
+
+/**
+	@brief Vista in sola lettura di un MultiSet in formato binario, mappato in memoria
+
+	@description
+	La vista risponde a nocc() e contains() leggendo direttamente i dati, senza costruire
+	il MultiSet: viene decodificato solo il valore dei record confrontati. Se il file
+	contiene l'indice (MultiSet scritto con funtore di hash) una ricerca decodifica in media
+	un solo record, altrimenti i record vengono scorsi uno dopo l'altro.
+	Il file è mappato con mmap() sui sistemi POSIX e letto in memoria altrove; le pagine
+	sono caricate dal sistema operativo alla prima lettura. La vista può anche essere
+	costruita su dati già in memoria, che non sono copiati e devono sopravviverle.
+
+	@tparam T tipo del valore degli elementi (con un multiset_codec<T>)
+	@tparam E funtore di uguaglianza del valore di due elementi
+	@tparam H funtore di hash usato dal MultiSet scritto (multiset_no_hash se senza hash)
+*/
+template <typename T, typename E, typename H = multiset_no_hash>
+class MappedMultiSet {
+
+	typedef multiset_binary_format fmt;
+
+	const char *_data; ///< Primo byte dei dati
+	std::size_t _bytes; ///< Lunghezza dei dati
+	void *_map; ///< Indirizzo della mappatura, nullptr se i dati non sono mappati
+	std::vector<char> _copy; ///< Contenuto del file, se non è possibile mapparlo
+	std::size_t _size; ///< Numero di elementi
+	std::size_t _distinct; ///< Numero di elementi distinti
+	const char *_records_end; ///< Fine dei record
+	const char *_index; ///< Prima posizione dell'indice, nullptr se assente
+	std::size_t _slots; ///< Numero di posizioni dell'indice
+	E _eql; ///< Funtore di uguaglianza
+	H _hash; ///< Funtore di hash
+
+	/**
+		@brief Lettura e verifica dell'intestazione
+
+		@throw multiset_bad_format se l'intestazione non è valida o non corrisponde alla
+		lunghezza dei dati
+	*/
+	void parse() {
+		if(_bytes < fmt::header_size)
+			throw multiset_bad_format();
+		multiset_reader hr(_data, _data + fmt::header_size);
+		if(std::memcmp(hr.get_bytes(4), fmt::magic(), 4) != 0 || hr.get_fixed(4) != fmt::version)
+			throw multiset_bad_format();
+		unsigned long long size = hr.get_fixed(8);
+		unsigned long long distinct = hr.get_fixed(8);
+		unsigned long long records = hr.get_fixed(8);
+		unsigned long long slots = hr.get_fixed(8);
+		if(records > _bytes - fmt::header_size || distinct > records || size < distinct ||
+			size > std::numeric_limits<std::size_t>::max())
+			throw multiset_bad_format();
+		_size = static_cast<std::size_t>(size);
+		_distinct = static_cast<std::size_t>(distinct);
+		_records_end = _data + fmt::header_size + records;
+		_slots = static_cast<std::size_t>(slots);
+		_index = nullptr;
+		if(_slots > 0) {
+			std::size_t start = static_cast<std::size_t>(fmt::header_size + records + 7) / 8 * 8;
+			if((_slots & (_slots - 1)) != 0 || _slots < 2 * _distinct || start > _bytes || (_bytes - start) / 8 < _slots)
+				throw multiset_bad_format();
+			if(!std::is_same<H, multiset_no_hash>::value) // Senza funtore di hash l'indice non è usato
+				_index = _data + start;
+		}
+		// Un funtore di hash diverso da quello usato in scrittura non troverebbe i valori
+		if(_index != nullptr && _distinct > 0) {
+			multiset_reader r(_data + fmt::header_size, _records_end);
+			r.get_varint();
+			if(find(multiset_codec<T>::read(r)) != _data + fmt::header_size)
+				throw multiset_bad_format();
+		}
+	}
+
+	/**
+		@brief Rilascio della mappatura
+	*/
+	void unmap() {
+#ifdef MULTISET_BINARY_MMAP
+		if(_map != nullptr)
+			munmap(_map, _bytes);
+#endif
+		_map = nullptr;
+	}
+
+	/**
+		@brief Lettura di una posizione dell'indice
+
+		@param j indice della posizione
+
+		@return contenuto della posizione
+	*/
+	unsigned long long slot(std::size_t j) const {
+		multiset_reader r(_index + 8 * j, _index + 8 * j + 8);
+		return r.get_fixed(8);
+	}
+
+	/**
+		@brief Ricerca del record di un valore
+
+		@param v valore da cercare
+
+		@return puntatore all'inizio del record, nullptr se il valore non è presente
+
+		@throw multiset_bad_format se un record confrontato non è valido
+	*/
+	const char* find(const T &v) const {
+		if(_index == nullptr) {
+			multiset_reader r(_data + fmt::header_size, _records_end);
+			for(std::size_t i = 0; i < _distinct; ++i) {
+				const char *rec = r.position();
+				r.get_varint();
+				if(multiset_equal(_eql, multiset_codec<T>::read(r), v))
+					return rec;
+			}
+			return nullptr;
+		}
+		const unsigned long long h = fmt::mix(_hash(v));
+		const unsigned long long tag = fmt::tag(h);
+		const unsigned long long mask = (1ULL << fmt::offset_bits) - 1;
+		std::size_t j = static_cast<std::size_t>(h) & (_slots - 1);
+		for(std::size_t probes = 0; probes < _slots; ++probes, j = (j + 1) & (_slots - 1)) {
+			unsigned long long s = slot(j);
+			if(s == 0)
+				return nullptr;
+			if((s >> fmt::offset_bits) != tag)
+				continue;
+			unsigned long long off = (s & mask) - 1;
+			if(off < fmt::header_size || off >= static_cast<std::size_t>(_records_end - _data))
+				throw multiset_bad_format();
+			multiset_reader r(_data + off, _records_end);
+			r.get_varint();
+			if(multiset_equal(_eql, multiset_codec<T>::read(r), v))
+				return _data + off;
+		}
+		return nullptr;
+	}
+
+public:
+
+	typedef std::size_t size_type; ///< Tipo del numero di occorrenze e del numero di elementi
+
+	/**
+		@brief Costruttore da file
+
+		@param path percorso del file scritto con multiset_write()
+
+		@throw multiset_io_error se il file non può essere aperto o mappato,
+		multiset_bad_format se il contenuto non è valido
+	*/
+	explicit MappedMultiSet(const std::string &path) : _data(nullptr), _bytes(0), _map(nullptr) {
+#ifdef MULTISET_BINARY_MMAP
+		int fd = open(path.c_str(), O_RDONLY);
+		if(fd < 0)
+			throw multiset_io_error();
+		struct stat st;
+		if(fstat(fd, &st) != 0) {
+			close(fd);
+			throw multiset_io_error();
+		}
+		_bytes = static_cast<std::size_t>(st.st_size);
+		if(_bytes == 0) {
+			close(fd);
+			throw multiset_bad_format();
+		}
+		void *p = mmap(nullptr, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if(p == MAP_FAILED)
+			throw multiset_io_error();
+		_map = p;
+		_data = static_cast<const char*>(p);
+#else
+		std::ifstream in(path.c_str(), std::ios::binary);
+		if(!in)
+			throw multiset_io_error();
+		_copy.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+		if(in.bad())
+			throw multiset_io_error();
+		_data = _copy.data();
+		_bytes = _copy.size();
+#endif
+		try {
+			parse();
+		}
+		catch(...) {
+			unmap();
+			throw;
+		}
+	}
+
+	/**
+		@brief Costruttore da dati in memoria
+
+		@param data primo byte dei dati scritti con multiset_write(), che non vengono copiati
+		@param bytes lunghezza dei dati
+
+		@throw multiset_bad_format se i dati non sono validi
+	*/
+	MappedMultiSet(const char *data, std::size_t bytes) : _data(data), _bytes(bytes), _map(nullptr) {
+		parse();
+	}
+
+	MappedMultiSet(const MappedMultiSet &other) = delete; // Non copiabile: la mappatura è rilasciata dal distruttore
+	MappedMultiSet& operator=(const MappedMultiSet &other) = delete; // Non assegnabile
+
+	/**
+		@brief Costruttore di spostamento
+
+		@param other vista da cui spostare i dati, che resta vuota
+	*/
+	MappedMultiSet(MappedMultiSet &&other) : _data(other._data), _bytes(other._bytes), _map(other._map),
+		_copy(std::move(other._copy)), _size(other._size), _distinct(other._distinct),
+		_records_end(other._records_end), _index(other._index), _slots(other._slots),
+		_eql(other._eql), _hash(other._hash) {
+		other._map = nullptr;
+		other._data = other._records_end = nullptr;
+		other._index = nullptr;
+		other._bytes = other._size = other._distinct = other._slots = 0;
+	}
+
+	/**
+		@brief Distruttore, che rilascia la mappatura del file
+	*/
+	~MappedMultiSet() {
+		unmap();
+	}
+
+	/**
+		@brief Numero di elementi
+
+		@return numero totale di elementi, comprese le ripetizioni
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di elementi distinti
+
+		@return numero di valori distinti
+	*/
+	size_type distinct_size() const {
+		return _distinct;
+	}
+
+	/**
+		@brief Verifica se la vista ha un indice
+
+		@return true se le ricerche usano l'indice, false se scorrono i record
+	*/
+	bool indexed() const {
+		return _index != nullptr;
+	}
+
+	/**
+		@brief Verifica la presenza di un valore
+
+		@param v valore da cercare
+
+		@return true se v è presente almeno una volta
+
+		@throw multiset_bad_format se un record confrontato non è valido
+	*/
+	bool contains(const T &v) const {
+		return find(v) != nullptr;
+	}
+
+	/**
+		@brief Numero di occorrenze di un valore
+
+		@param v valore da cercare
+
+		@return numero di occorrenze di v, 0 se non presente
+
+		@throw multiset_bad_format se un record confrontato non è valido
+	*/
+	size_type nocc(const T &v) const {
+		const char *rec = find(v);
+		if(rec == nullptr)
+			return 0;
+		multiset_reader r(rec, _records_end);
+		return static_cast<size_type>(r.get_varint());
+	}
+
+}; // class MappedMultiSet
+
+#endif
+
+// Fine multiset_binary.h
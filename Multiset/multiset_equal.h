@@ -0,0 +1,159 @@
+/**
+	@headerfile multiset_equal.h
+
+	@brief Trait che riconoscono i funtori di uguaglianza equivalenti ad operator== o al
+	confronto byte per byte, e confronto tra due valori che ne sceglie l'implementazione.
+
+	@description
+	Per default i trait riconoscono std::equal_to<T> (e std::equal_to<> da C++14); per un
+	funtore definito dall'utente vanno specializzati, ad esempio:
+
+	template <> struct multiset_plain_equal<int, equal_int> : std::true_type {};
+
+	I contenitori usano i trait per sostituire l'invocazione del funtore con operator==
+	o std::memcmp, per confrontare più chiavi con una sola istruzione (FlatMultiSet), per
+	ordinare i nodi per byte nelle operazioni tra MultiSet senza hash o per calcolarne
+	l'impronta dai byte dei valori. Gli altri funtori sono invocati come prima.
+*/
+
+// Guardie
+
+#ifndef MULTISET_EQUAL_H
+#define MULTISET_EQUAL_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcmp
+#include <functional> // std::equal_to
+#include <type_traits> // std::integral_constant, std::is_same, std::is_integral, std::is_enum, std::is_pointer
+
+/**
+	@brief Trait che stabilisce se un funtore di uguaglianza equivale ad operator==
+
+	@description
+	Il valore è true se E(a, b) restituisce sempre a == b. Va specializzato per i funtori
+	dell'utente che confrontano i valori con operator== (o in modo equivalente).
+
+	@tparam T tipo dei valori confrontati
+	@tparam E funtore di uguaglianza
+*/
+template <typename T, typename E>
+struct multiset_plain_equal : std::integral_constant<bool, std::is_same<E, std::equal_to<T>>::value> {};
+
+#if __cplusplus >= 201402L
+/**
+	@brief Specializzazione del trait per il funtore trasparente std::equal_to<>
+*/
+template <typename T>
+struct multiset_plain_equal<T, std::equal_to<void>> : std::true_type {};
+#endif
+
+/**
+	@brief Trait che stabilisce se un funtore di uguaglianza equivale al confronto byte per byte
+
+	@description
+	Il valore è true se E(a, b) è vero se e solo se i sizeof(T) byte di a e b coincidono.
+	Per default vale per gli interi, le enumerazioni ed i puntatori confrontati con
+	operator== (non per i numeri con la virgola: 0.0 == -0.0, NaN != NaN). Va specializzato
+	per le strutture senza byte di riempimento i cui campi sono tutti confrontati.
+
+	@tparam T tipo dei valori confrontati
+	@tparam E funtore di uguaglianza
+*/
+template <typename T, typename E>
+struct multiset_bytewise_equal : std::integral_constant<bool, multiset_plain_equal<T,E>::value &&
+	(std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value)> {};
+
+/**
+	@brief Implementazione del confronto scelta dai trait
+
+	@description
+	2 per il confronto byte per byte, 1 per operator==, 0 per il funtore.
+
+	@tparam T tipo dei valori confrontati
+	@tparam E funtore di uguaglianza
+*/
+template <typename T, typename E>
+struct multiset_equal_kind {
+	static const int value = multiset_bytewise_equal<T,E>::value ? 2 : (multiset_plain_equal<T,E>::value ? 1 : 0);
+};
+
+/**
+	@brief Confronto tramite il funtore di uguaglianza
+*/
+template <typename T, typename E>
+bool multiset_equal(const E &eql, const T &a, const T &b, std::integral_constant<int, 0>) {
+	return eql(a, b);
+}
+
+/**
+	@brief Confronto tramite operator==, senza invocare il funtore
+*/
+template <typename T, typename E>
+bool multiset_equal(const E &, const T &a, const T &b, std::integral_constant<int, 1>) {
+	return a == b;
+}
+
+/**
+	@brief Confronto byte per byte, in poche istruzioni per i tipi di dimensione fissa
+*/
+template <typename T, typename E>
+bool multiset_equal(const E &, const T &a, const T &b, std::integral_constant<int, 2>) {
+	return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+/**
+	@brief Confronto tra due valori, con l'implementazione scelta dai trait
+
+	@tparam T tipo dei valori confrontati
+	@tparam E funtore di uguaglianza
+
+	@param eql istanza del funtore di uguaglianza
+	@param a primo valore
+	@param b secondo valore
+
+	@return true se a e b sono uguali secondo il funtore
+*/
+template <typename T, typename E>
+bool multiset_equal(const E &eql, const T &a, const T &b) {
+	return multiset_equal(eql, a, b, std::integral_constant<int, multiset_equal_kind<T,E>::value>());
+}
+
+/**
+	@brief Ordinamento byte per byte, coerente con un funtore per cui vale multiset_bytewise_equal
+
+	@tparam T tipo dei valori confrontati
+*/
+template <typename T>
+struct multiset_bytewise_less {
+	bool operator()(const T &a, const T &b) const {
+		return std::memcmp(&a, &b, sizeof(T)) < 0;
+	}
+};
+
+/**
+	@brief Hash dei byte di un valore, coerente con un funtore per cui vale multiset_bytewise_equal
+
+	@description
+	Hash FNV-1a dei sizeof(T) byte del valore: valori uguali byte per byte hanno lo stesso
+	hash. Usato dai MultiSet senza funtore di hash per il peso dei valori nell'impronta.
+
+	@tparam T tipo dei valori
+*/
+template <typename T>
+struct multiset_bytewise_hash {
+	std::size_t operator()(const T &v) const {
+		const unsigned char *p = reinterpret_cast<const unsigned char*>(&v);
+		unsigned long long h = 14695981039346656037ULL;
+		for(std::size_t i = 0; i < sizeof(T); ++i) {
+			h ^= p[i];
+			h *= 1099511628211ULL;
+		}
+		return static_cast<std::size_t>(h);
+	}
+};
+
+#endif
+
+// Fine multiset_equal.h
@@ -33,6 +33,55 @@ class multiset_iterator_out_of_bounds {
 
 };
 
+
+/**
+	@brief Eccezione di numero di occorrenze fuori dai limiti
+
+	@description
+	Questa eccezione viene lanciata quando un inserimento porterebbe il numero
+	di occorrenze di un valore, o il numero totale di elementi del MultiSet, oltre
+	il massimo rappresentabile.
+*/
+class multiset_count_overflow {
+
+};
+
+
+/**
+	@brief Eccezione di strutture incompatibili
+
+	@description
+	Questa eccezione viene lanciata quando si tenta di unire due ApproxMultiSet
+	costruiti con parametri diversi.
+*/
+class multiset_incompatible {
+
+};
+
+
+/**
+	@brief Eccezione di formato binario non valido
+
+	@description
+	Questa eccezione viene lanciata quando si legge un MultiSet da dati binari troncati,
+	corrotti o scritti in un formato diverso da quello di multiset_binary.h.
+*/
+class multiset_bad_format {
+
+};
+
+
+/**
+	@brief Eccezione di errore di input/output
+
+	@description
+	Questa eccezione viene lanciata quando non è possibile scrivere o leggere uno stream,
+	oppure aprire o mappare in memoria un file.
+*/
+class multiset_io_error {
+
+};
+
 #endif
 
 // Fine multiset_exceptions.h
\ No newline at end of file
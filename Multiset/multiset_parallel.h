@@ -0,0 +1,325 @@
+/**
+	@headerfile multiset_parallel.h
+
+	@brief Dichiarazione e definizione della costruzione parallela di un MultiSet
+	a partire da una sequenza.
+*/
+
+// Guardie
+
+#ifndef MULTISET_PARALLEL_H
+#define MULTISET_PARALLEL_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t
+#include <exception> // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional> // std::function
+#include <iterator> // std::iterator_traits, std::distance, std::advance
+#include <limits> // std::numeric_limits
+#include <pthread.h> // pthread_create, pthread_join
+#include <thread> // std::thread::hardware_concurrency
+#include <type_traits> // std::integral_constant, std::is_convertible, std::is_same
+#include <utility> // std::move
+#include <vector> // std::vector
+#include "multiset.h" // MultiSet, multiset_access, multiset_is_hashed
+
+/**
+	@brief Costruzione parallela di un MultiSet, specializzata per MultiSet<T,E,H,A,N>
+
+	@tparam MS tipo del MultiSet da costruire
+*/
+template <typename MS>
+struct multiset_parallel_builder;
+
+/**
+	@brief Costruzione parallela di un MultiSet
+
+	@description
+	La costruzione avviene in tre fasi, ciascuna eseguita da un gruppo di thread:
+	1. la sequenza è divisa in parti contigue, una per thread; ogni thread inserisce la propria
+	parte in P MultiSet locali, uno per partizione, scelta dai log2(P) bit meno significativi
+	dell'hash rimescolato del valore;
+	2. il thread p somma i MultiSet locali della partizione p di tutti i thread: le partizioni
+	sono disgiunte, quindi l'unione è anch'essa parallela;
+	3. i nodi di ogni partizione sono collegati direttamente, senza copie né ricerche, nei bucket
+	del MultiSet finale: con un numero di bucket multiplo di P, i bucket della partizione p sono
+	quelli con indice congruo a p modulo P, quindi i thread non scrivono mai sugli stessi bucket.
+	Nelle prime due fasi l'hash dei nodi è ruotato di log2(P) bit, così che i bucket di ogni
+	MultiSet locale siano selezionati da bit che variano all'interno della partizione; nella
+	terza fase l'hash originale viene ripristinato.
+	Se gli allocatori dei nodi non sono intercambiabili (ad esempio multiset_pool_allocator, che
+	usa un pool diverso per ogni MultiSet), la terza fase copia i nodi su un solo thread.
+	I nodi interni di una partizione (parametro N del MultiSet) sono spostati nella memoria
+	dell'allocatore prima di essere collegati, perché non sopravvivono al MultiSet della partizione.
+	I nodi sono raggiunti tramite multiset_access, gli inserimenti con l'hash già calcolato
+	tramite MultiSet::add_hashed().
+
+	@tparam T tipo degli elementi del MultiSet
+	@tparam E funtore di uguaglianza tra elementi del MultiSet
+	@tparam H funtore di hash degli elementi
+	@tparam A allocatore del MultiSet
+	@tparam N numero di nodi interni del MultiSet
+*/
+template <typename T, typename E, typename H, typename A, std::size_t N>
+struct multiset_parallel_builder<MultiSet<T,E,H,A,N>> {
+
+	typedef MultiSet<T,E,H,A,N> MS; ///< Tipo del MultiSet da costruire
+	typedef typename multiset_access::node_of<MS>::type node; ///< Tipo dei nodi del MultiSet
+
+	/**
+		Dati di un thread del gruppo
+	*/
+	struct worker {
+		const std::function<void(std::size_t)> *body; ///< Funzione eseguita dal thread
+		std::size_t index; ///< Indice del thread nel gruppo
+		std::exception_ptr error; ///< Eventuale eccezione lanciata da body
+	};
+
+	/**
+		@brief Corpo di un thread del gruppo
+
+		@param arg puntatore ad un worker
+
+		@return nullptr
+	*/
+	static void* run(void *arg) {
+		worker *w = static_cast<worker*>(arg);
+		try {
+			(*w->body)(w->index);
+		}
+		catch(...) { // Qualsiasi eccezione è riportata al thread chiamante
+			w->error = std::current_exception();
+		}
+		return nullptr;
+	}
+
+	/**
+		@brief Esecuzione di una funzione su n thread
+
+		@description
+		La funzione è invocata con gli indici da 0 a n - 1, ciascuno su un thread diverso; se un
+		thread non può essere creato, la sua invocazione avviene sul thread chiamante.
+		Al termine di tutti i thread, la prima eccezione lanciata viene propagata.
+
+		@param n numero di thread
+		@param body funzione da eseguire
+
+		@throw Eccezione lanciata da body
+	*/
+	static void parallel_for(std::size_t n, const std::function<void(std::size_t)> &body) {
+		std::vector<worker> workers(n);
+		std::vector<pthread_t> threads(n);
+		std::vector<bool> started(n, false);
+		for(std::size_t i = 0; i < n; ++i) {
+			workers[i].body = &body;
+			workers[i].index = i;
+			if(i > 0)
+				started[i] = (pthread_create(&threads[i], nullptr, run, &workers[i]) == 0);
+		}
+		for(std::size_t i = 0; i < n; ++i)
+			if(!started[i])
+				run(&workers[i]);
+		for(std::size_t i = 0; i < n; ++i)
+			if(started[i])
+				pthread_join(threads[i], nullptr);
+		for(std::size_t i = 0; i < n; ++i)
+			if(workers[i].error)
+				std::rethrow_exception(workers[i].error);
+	}
+
+	/**
+		@brief Rotazione a destra di un hash
+
+		@param h hash da ruotare
+		@param bits numero di bit della rotazione (minore del numero di bit di std::size_t)
+
+		@return hash ruotato
+	*/
+	static std::size_t rotate(std::size_t h, std::size_t bits) {
+		if(bits == 0)
+			return h;
+		return (h >> bits) | (h << (std::numeric_limits<std::size_t>::digits - bits));
+	}
+
+	/**
+		@brief Rotazione inversa di rotate()
+
+		@param h hash ruotato
+		@param bits numero di bit della rotazione
+
+		@return hash originale
+	*/
+	static std::size_t unrotate(std::size_t h, std::size_t bits) {
+		if(bits == 0)
+			return h;
+		return (h << bits) | (h >> (std::numeric_limits<std::size_t>::digits - bits));
+	}
+
+	/**
+		@brief Costruzione parallela da una sequenza con iteratori di tipo forward
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param nthreads numero di thread da usare (almeno 2)
+
+		@return MultiSet con gli elementi della sequenza
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	template <typename IterT>
+	static MS build(IterT first, IterT last, std::size_t nthreads, std::true_type) {
+		std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+		std::size_t bits = 0, nparts = 1;
+		while(nparts < nthreads) {
+			nparts *= 2;
+			++bits;
+		}
+
+		// Fase 1: ogni thread divide la propria parte della sequenza per partizione
+		std::vector<IterT> bounds(nthreads + 1, first);
+		for(std::size_t t = 1; t <= nthreads; ++t) {
+			bounds[t] = bounds[t - 1];
+			std::advance(bounds[t], n / nthreads + ((t - 1) < n % nthreads ? 1 : 0));
+		}
+		std::vector<std::vector<MS>> local(nthreads, std::vector<MS>(nparts));
+		parallel_for(nthreads, [&](std::size_t t) {
+			std::vector<MS> &mine = local[t];
+			for(IterT i = bounds[t]; i != bounds[t + 1]; ++i) {
+				const T &v = *i;
+				std::size_t h = mine[0].hash_value(v);
+				mine[h & (nparts - 1)].add_hashed(v, rotate(h, bits), 1);
+			}
+		});
+
+		// Fase 2: il thread p somma i MultiSet locali della partizione p
+		std::vector<MS> parts(nparts);
+		parallel_for(nparts, [&](std::size_t p) {
+			parts[p] = std::move(local[0][p]);
+			for(std::size_t t = 1; t < nthreads; ++t) {
+				parts[p] += local[t][p];
+				local[t][p].clear();
+			}
+		});
+		local.clear();
+
+		// Fase 3: i nodi delle partizioni sono collegati nei bucket del MultiSet finale
+		MS res;
+		std::size_t distinct = 0, size = 0;
+		bool shared = true;
+		for(std::size_t p = 0; p < nparts; ++p) {
+			distinct += parts[p].distinct_size();
+			size += parts[p].size();
+			shared = shared && parts[p].get_allocator() == res.get_allocator();
+		}
+		if(!shared || distinct <= multiset_access::min_buckets<MS>() / 2) {
+			res.reserve(distinct);
+			for(std::size_t p = 0; p < nparts; ++p)
+				for(const node *curr = multiset_access::first(parts[p]); curr != nullptr; curr = multiset_access::next(parts[p], curr))
+					res.add_hashed(curr->value, unrotate(curr->hash, bits), curr->nocc);
+			return res;
+		}
+		if(N > 0) {
+			parallel_for(nparts, [&](std::size_t p) {
+				multiset_access::spill(parts[p]);
+			});
+		}
+		std::size_t nb = multiset_access::min_buckets<MS>();
+		while(nb < distinct || nb < nparts)
+			nb *= 2;
+		multiset_access::allocate_buckets(res, nb);
+		std::vector<std::size_t> fps(nparts, 0);
+		parallel_for(nparts, [&](std::size_t p) {
+			fps[p] = multiset_access::splice(parts[p], res, [bits](std::size_t h) { return unrotate(h, bits); });
+		});
+		std::size_t fp = 0;
+		for(std::size_t p = 0; p < nparts; ++p)
+			fp += fps[p];
+		multiset_access::set_totals(res, distinct, size, fp);
+		return res;
+	}
+
+	/**
+		@brief Costruzione da una sequenza con iteratori di input o di tipo diverso da T
+
+		@description
+		La sequenza non può essere divisa senza scandirla, quindi il MultiSet è costruito
+		sul thread chiamante.
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param nthreads ignorato
+
+		@return MultiSet con gli elementi della sequenza
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	static MS build(IterT first, IterT last, std::size_t nthreads, std::false_type) {
+		(void)nthreads;
+		return MS(first, last);
+	}
+
+	/**
+		@brief Selezione della strategia di costruzione
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza
+
+		@param first iteratore che punta all'inizio della sequenza
+		@param last iteratore che punta alla fine della sequenza
+		@param nthreads numero di thread da usare (almeno 2)
+
+		@return MultiSet con gli elementi della sequenza
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	template <typename IterT>
+	static MS build(IterT first, IterT last, std::size_t nthreads) {
+		typedef typename std::iterator_traits<IterT>::iterator_category category;
+		typedef typename std::iterator_traits<IterT>::value_type value;
+		typedef std::integral_constant<bool, multiset_is_hashed<H>::value && std::is_convertible<category, std::forward_iterator_tag>::value &&
+			std::is_same<typename std::remove_cv<value>::type, typename std::remove_cv<T>::type>::value> splittable;
+
+		return build(first, last, nthreads, splittable());
+	}
+
+}; // struct multiset_parallel_builder
+
+/**
+	@brief Costruzione parallela di un MultiSet a partire da una sequenza
+
+	@description
+	Il risultato è uguale (operator==) a MS(first, last), ma la sequenza è elaborata da
+	nthreads thread (vedi multiset_parallel_builder). Senza funtore di hash, con iteratori di
+	input, con elementi di tipo diverso da T o con un solo thread, il MultiSet è costruito
+	sul thread chiamante tramite il costruttore da sequenza.
+	Il funtore di hash e quello di uguaglianza sono invocati contemporaneamente da più thread
+	(su istanze diverse) e devono quindi essere thread-safe.
+
+	@tparam MS tipo del MultiSet da costruire (ad esempio MultiSet<int, E, std::hash<int>>)
+	@tparam IterT tipo degli iteratori che identificano la sequenza
+
+	@param first iteratore che punta all'inizio della sequenza
+	@param last iteratore che punta alla fine della sequenza
+	@param nthreads numero di thread da usare, 0 per usarne uno per core
+
+	@return MultiSet con gli elementi della sequenza
+
+	@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+*/
+template <typename MS, typename IterT>
+MS multiset_parallel_build(IterT first, IterT last, std::size_t nthreads = 0) {
+	if(nthreads == 0)
+		nthreads = std::thread::hardware_concurrency();
+	if(nthreads < 2)
+		return MS(first, last);
+	return multiset_parallel_builder<MS>::build(first, last, nthreads);
+}
+
+#endif
+
+// Fine multiset_parallel.h
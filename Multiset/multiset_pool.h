@@ -0,0 +1,508 @@
+/**
+	@headerfile multiset_pool.h
+
+	@brief Dichiarazione e definizione di un allocatore a blocchi (pool) per i nodi
+	della classe MultiSet, compatibile con l'interfaccia degli allocatori standard.
+*/
+
+// Guardie
+
+#ifndef MULTISET_POOL_H
+#define MULTISET_POOL_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t, std::max_align_t
+#include <new> // ::operator new, ::operator delete
+#include <type_traits> // std::true_type
+
+/**
+	@brief Statistiche di utilizzo di un pool
+
+	@description
+	I contatori sono cumulativi, ad eccezione di quelli che descrivono la memoria
+	attualmente in uso.
+*/
+struct multiset_pool_stats {
+	std::size_t allocations; ///< Numero di richieste di allocazione ricevute
+	std::size_t deallocations; ///< Numero di richieste di deallocazione ricevute
+	std::size_t system_allocations; ///< Numero di allocazioni richieste al sistema (blocchi e richieste fuori pool)
+	std::size_t bytes_reserved; ///< Byte attualmente ottenuti dal sistema
+	std::size_t bytes_in_use; ///< Byte attualmente assegnati ai chiamanti
+	std::size_t slots_in_use; ///< Numero di celle del pool attualmente assegnate
+
+	/**
+		@brief Costruttore di default, con tutti i contatori a 0
+	*/
+	multiset_pool_stats() : allocations(0), deallocations(0), system_allocations(0),
+		bytes_reserved(0), bytes_in_use(0), slots_in_use(0) {}
+};
+
+/**
+	@brief Pool di celle di memoria di dimensione fissa
+
+	@description
+	Il pool ottiene dal sistema blocchi contenenti slots_per_block celle, tutte della
+	dimensione della prima richiesta di un singolo oggetto ricevuta. Le celle liberate
+	sono riutilizzate tramite una free list; le richieste di array (ad esempio gli array
+	di bucket) e quelle di dimensione diversa sono inoltrate direttamente a ::operator new.
+	Tutti i blocchi possono essere restituiti al sistema con un'unica chiamata a release().
+	Il pool non è thread-safe.
+*/
+class multiset_pool {
+
+	/**
+		Intestazione di un blocco ottenuto dal sistema
+	*/
+	struct block {
+		block *next; ///< Blocco allocato in precedenza
+	};
+
+	/**
+		Cella libera, collegata alla free list
+	*/
+	struct free_slot {
+		free_slot *next; ///< Cella libera successiva
+	};
+
+	std::size_t _slots_per_block; ///< Numero di celle per blocco
+	std::size_t _slot_size; ///< Dimensione di una cella (0 finché non è nota)
+	block *_blocks; ///< Lista dei blocchi ottenuti dal sistema
+	char *_cursor; ///< Prima cella mai assegnata del blocco corrente
+	char *_limit; ///< Fine del blocco corrente
+	free_slot *_free; ///< Free list delle celle liberate
+	std::size_t _block_bytes; ///< Byte ottenuti dal sistema per i blocchi
+	multiset_pool_stats _stats; ///< Statistiche di utilizzo
+	std::size_t _refs; ///< Numero di allocatori che condividono il pool
+
+	/**
+		@brief Scostamento delle celle dall'inizio di un blocco
+
+		@return dimensione dell'intestazione, arrotondata all'allineamento massimo
+	*/
+	static std::size_t header_size() {
+		return round_up(sizeof(block));
+	}
+
+	/**
+		@brief Arrotondamento di una dimensione all'allineamento massimo
+
+		@param bytes dimensione da arrotondare
+
+		@return multiplo di alignof(std::max_align_t) non minore di bytes
+	*/
+	static std::size_t round_up(std::size_t bytes) {
+		const std::size_t a = alignof(std::max_align_t);
+		return (bytes + a - 1) / a * a;
+	}
+
+	/**
+		@brief Verifica che una richiesta sia servita dal pool
+
+		@param bytes numero di byte della richiesta
+		@param single true se la richiesta è per un singolo oggetto
+
+		@return true se la richiesta è per un singolo oggetto della dimensione delle celle,
+		false altrimenti
+	*/
+	bool pooled(std::size_t bytes, bool single) const {
+		return single && round_up(bytes < sizeof(free_slot) ? sizeof(free_slot) : bytes) == _slot_size;
+	}
+
+	// Il pool non è copiabile
+
+	multiset_pool(const multiset_pool &other);
+	multiset_pool& operator=(const multiset_pool &other);
+
+public:
+
+	/**
+		@brief Costruttore del pool
+
+		@param slots_per_block numero di celle di ciascun blocco
+	*/
+	explicit multiset_pool(std::size_t slots_per_block) : _slots_per_block(slots_per_block), _slot_size(0),
+		_blocks(nullptr), _cursor(nullptr), _limit(nullptr), _free(nullptr), _block_bytes(0), _refs(1) {}
+
+	/**
+		@brief Distruttore del pool
+
+		@post Tutti i blocchi sono restituiti al sistema
+	*/
+	~multiset_pool() {
+		release();
+	}
+
+	/**
+		@brief Allocazione di memoria
+
+		@description
+		Le richieste della dimensione delle celle sono servite dalla free list o, se vuota,
+		dal blocco corrente; se anche il blocco è esaurito, ne viene richiesto uno nuovo.
+
+		@param bytes numero di byte richiesti
+		@param single true se la richiesta è per un singolo oggetto, false per un array
+
+		@return puntatore alla memoria allocata
+
+		@throw std::bad_alloc se il sistema non ha memoria disponibile
+	*/
+	void* allocate(std::size_t bytes, bool single) {
+		if(_slot_size == 0 && single)
+			_slot_size = round_up(bytes < sizeof(free_slot) ? sizeof(free_slot) : bytes);
+
+		if(!pooled(bytes, single)) { // Richiesta fuori pool
+			void *p = ::operator new(bytes);
+			_stats.allocations++;
+			_stats.system_allocations++;
+			_stats.bytes_reserved += bytes;
+			_stats.bytes_in_use += bytes;
+			return p;
+		}
+
+		void *p;
+		if(_free != nullptr) {
+			p = _free;
+			_free = _free->next;
+		}
+		else {
+			if(_cursor == _limit) {
+				std::size_t size = header_size() + _slots_per_block * _slot_size;
+				block *b = static_cast<block*>(::operator new(size));
+				b->next = _blocks;
+				_blocks = b;
+				_cursor = reinterpret_cast<char*>(b) + header_size();
+				_limit = _cursor + _slots_per_block * _slot_size;
+				_stats.system_allocations++;
+				_stats.bytes_reserved += size;
+				_block_bytes += size;
+			}
+			p = _cursor;
+			_cursor += _slot_size;
+		}
+		_stats.allocations++;
+		_stats.bytes_in_use += _slot_size;
+		_stats.slots_in_use++;
+		return p;
+	}
+
+	/**
+		@brief Deallocazione di memoria
+
+		@param p puntatore restituito da allocate()
+		@param bytes numero di byte passato ad allocate()
+		@param single valore di single passato ad allocate()
+
+		@post Una cella del pool è inserita nella free list, una richiesta fuori pool è
+		restituita al sistema
+	*/
+	void deallocate(void *p, std::size_t bytes, bool single) {
+		_stats.deallocations++;
+		if(!pooled(bytes, single)) { // Richiesta fuori pool
+			::operator delete(p);
+			_stats.bytes_reserved -= bytes;
+			_stats.bytes_in_use -= bytes;
+			return;
+		}
+		free_slot *s = static_cast<free_slot*>(p);
+		s->next = _free;
+		_free = s;
+		_stats.bytes_in_use -= _slot_size;
+		_stats.slots_in_use--;
+	}
+
+	/**
+		@brief Restituzione di tutti i blocchi al sistema
+
+		@description
+		Le celle ancora assegnate diventano non valide: il metodo va chiamato solo
+		quando nessuna cella è più in uso, o quando i loro oggetti sono già stati distrutti.
+
+		@post Il pool è vuoto e può essere riutilizzato
+	*/
+	void release() {
+		while(_blocks != nullptr) {
+			block *tmp = _blocks->next;
+			::operator delete(_blocks);
+			_blocks = tmp;
+		}
+		_stats.bytes_reserved -= _block_bytes;
+		_stats.bytes_in_use -= _stats.slots_in_use * _slot_size;
+		_block_bytes = 0;
+		_stats.slots_in_use = 0;
+		_cursor = nullptr;
+		_limit = nullptr;
+		_free = nullptr;
+	}
+
+	/**
+		@brief Statistiche di utilizzo del pool
+
+		@return copia delle statistiche correnti
+	*/
+	multiset_pool_stats stats() const {
+		return _stats;
+	}
+
+	/**
+		@brief Numero di celle per blocco
+
+		@return numero di celle di ciascun blocco
+	*/
+	std::size_t slots_per_block() const {
+		return _slots_per_block;
+	}
+
+	/**
+		@brief Registrazione di un nuovo allocatore che condivide il pool
+	*/
+	void acquire() {
+		_refs++;
+	}
+
+	/**
+		@brief Rilascio del pool da parte di un allocatore
+
+		@return true se nessun allocatore condivide più il pool
+	*/
+	bool unref() {
+		return --_refs == 0;
+	}
+
+}; // class multiset_pool
+
+/**
+	@brief Allocatore a blocchi compatibile con gli allocatori standard
+
+	@description
+	Tutte le copie di un allocatore (anche quelle ottenute tramite rebind) condividono
+	lo stesso pool. Un container copiato riceve invece un pool nuovo, tramite
+	select_on_container_copy_construction(), ed un container assegnato per copia mantiene
+	il proprio (i nodi sono ricostruiti nelle sue celle); lo spostamento e lo scambio
+	trasferiscono anche il pool.
+
+	@tparam T tipo degli oggetti allocati
+	@tparam BlockSlots numero di celle di ciascun blocco del pool
+*/
+template <typename T, std::size_t BlockSlots = 256>
+class multiset_pool_allocator {
+
+	multiset_pool *_pool; ///< Pool condiviso
+
+	template <typename U, std::size_t B>
+	friend class multiset_pool_allocator;
+
+public:
+
+	// Traits dell'allocatore
+
+	typedef T value_type; ///< Tipo degli oggetti allocati
+	typedef std::false_type propagate_on_container_copy_assignment; ///< Nell'assegnamento di copia ogni container mantiene il proprio pool
+	typedef std::true_type propagate_on_container_move_assignment; ///< Il pool segue i nodi nello spostamento
+	typedef std::true_type propagate_on_container_swap; ///< Il pool segue i nodi nello scambio
+
+	/**
+		@brief Struttura per ottenere l'allocatore di un altro tipo, con lo stesso pool
+
+		@tparam U tipo degli oggetti allocati dal nuovo allocatore
+	*/
+	template <typename U>
+	struct rebind {
+		typedef multiset_pool_allocator<U, BlockSlots> other; ///< Allocatore del tipo U
+	};
+
+	/**
+		@brief Costruttore di default, che crea un nuovo pool
+
+		@throw std::bad_alloc se il pool non può essere allocato
+	*/
+	multiset_pool_allocator() : _pool(new multiset_pool(BlockSlots)) {}
+
+	/**
+		@brief Copy constructor, che condivide il pool
+
+		@param other allocatore da copiare
+	*/
+	multiset_pool_allocator(const multiset_pool_allocator &other) : _pool(other._pool) {
+		_pool->acquire();
+	}
+
+	/**
+		@brief Costruttore di conversione da un allocatore di un altro tipo, che condivide il pool
+
+		@tparam U tipo degli oggetti allocati da other
+
+		@param other allocatore da convertire
+	*/
+	template <typename U>
+	multiset_pool_allocator(const multiset_pool_allocator<U, BlockSlots> &other) : _pool(other._pool) {
+		_pool->acquire();
+	}
+
+	/**
+		@brief Operatore di assegnamento, che condivide il pool di other
+
+		@param other allocatore "sorgente"
+
+		@return riferimento all'allocatore corrente
+	*/
+	multiset_pool_allocator& operator=(const multiset_pool_allocator &other) {
+		other._pool->acquire();
+		if(_pool->unref())
+			delete _pool;
+		_pool = other._pool;
+		return *this;
+	}
+
+	/**
+		@brief Distruttore, che dealloca il pool se non è più condiviso
+	*/
+	~multiset_pool_allocator() {
+		if(_pool->unref())
+			delete _pool;
+	}
+
+	/**
+		@brief Allocazione di n oggetti
+
+		@param n numero di oggetti
+
+		@return puntatore alla memoria allocata
+
+		@throw std::bad_alloc se il sistema non ha memoria disponibile
+	*/
+	T* allocate(std::size_t n) {
+		return static_cast<T*>(_pool->allocate(n * sizeof(T), n == 1));
+	}
+
+	/**
+		@brief Deallocazione di n oggetti
+
+		@param p puntatore restituito da allocate()
+		@param n numero di oggetti passato ad allocate()
+	*/
+	void deallocate(T *p, std::size_t n) {
+		_pool->deallocate(p, n * sizeof(T), n == 1);
+	}
+
+	/**
+		@brief Allocatore per la copia di un container, con un pool nuovo
+
+		@return allocatore con un pool nuovo e vuoto
+	*/
+	multiset_pool_allocator select_on_container_copy_construction() const {
+		return multiset_pool_allocator();
+	}
+
+	/**
+		@brief Statistiche di utilizzo del pool
+
+		@return copia delle statistiche correnti
+	*/
+	multiset_pool_stats stats() const {
+		return _pool->stats();
+	}
+
+	/**
+		@brief Verifica che tutte le celle in uso appartengano al chiamante
+
+		@param live numero di celle del pool in uso da parte del chiamante
+
+		@return true se le celle in uso sono esattamente live, ovvero se nessun altro
+		container usa il pool
+	*/
+	bool owns_all(std::size_t live) const {
+		return _pool->stats().slots_in_use == live;
+	}
+
+	/**
+		@brief Restituzione al sistema di tutti i blocchi del pool
+
+		@pre Gli oggetti allocati nel pool sono già stati distrutti
+	*/
+	void release() {
+		_pool->release();
+	}
+
+	/**
+		@brief Operatore di uguaglianza
+
+		@param other allocatore con cui confrontare quello corrente
+
+		@return true se i due allocatori condividono lo stesso pool
+	*/
+	template <typename U>
+	bool operator==(const multiset_pool_allocator<U, BlockSlots> &other) const {
+		return _pool == other._pool;
+	}
+
+	/**
+		@brief Operatore di disuguaglianza
+
+		@param other allocatore con cui confrontare quello corrente
+
+		@return true se i due allocatori non condividono lo stesso pool
+	*/
+	template <typename U>
+	bool operator!=(const multiset_pool_allocator<U, BlockSlots> &other) const {
+		return _pool != other._pool;
+	}
+
+}; // class multiset_pool_allocator
+
+/**
+	@brief Trait per il rilascio in un'unica operazione della memoria di un allocatore
+
+	@description
+	Per un allocatore generico il rilascio in blocco non è disponibile e i nodi vanno
+	deallocati singolarmente.
+
+	@tparam A tipo dell'allocatore
+*/
+template <typename A>
+struct multiset_pool_traits {
+	/**
+		@brief Verifica della possibilità di rilasciare la memoria in blocco
+
+		@return false, il rilascio in blocco non è disponibile
+	*/
+	static bool owns_all(const A &, std::size_t) {
+		return false;
+	}
+
+	/**
+		@brief Rilascio della memoria in blocco (nessuna operazione)
+	*/
+	static void release(A &) {}
+};
+
+/**
+	@brief Specializzazione del trait per l'allocatore a blocchi
+*/
+template <typename T, std::size_t BlockSlots>
+struct multiset_pool_traits<multiset_pool_allocator<T, BlockSlots>> {
+	/**
+		@brief Verifica della possibilità di rilasciare la memoria in blocco
+
+		@param a allocatore
+		@param live numero di celle in uso da parte del chiamante
+
+		@return true se tutte le celle in uso appartengono al chiamante
+	*/
+	static bool owns_all(const multiset_pool_allocator<T, BlockSlots> &a, std::size_t live) {
+		return a.owns_all(live);
+	}
+
+	/**
+		@brief Rilascio della memoria in blocco
+
+		@param a allocatore
+	*/
+	static void release(multiset_pool_allocator<T, BlockSlots> &a) {
+		a.release();
+	}
+};
+
+#endif
+
+// Fine multiset_pool.h
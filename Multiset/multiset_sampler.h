@@ -0,0 +1,200 @@
+/**
+	@headerfile multiset_sampler.h
+
+	@brief Dichiarazione e definizione di un campionatore pesato per MultiSet e FlatMultiSet,
+	basato su una tabella alias.
+*/
+
+// Guardie
+
+#ifndef MULTISET_SAMPLER_H
+#define MULTISET_SAMPLER_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t
+#include <random> // std::uniform_int_distribution, std::uniform_real_distribution
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_value_not_found
+#include "multiset.h" // MultiSet
+#include "flat_multiset.h" // FlatMultiSet
+
+/**
+	@brief Campionatore pesato degli elementi di un MultiSet
+
+	@description
+	Il campionatore estrae valori del MultiSet con probabilità proporzionale al loro numero
+	di occorrenze. Alla costruzione viene creata, in tempo O(d) con d il numero di elementi
+	distinti, una tabella alias (metodo di Vose): ogni estrazione richiede quindi due numeri
+	casuali ed un accesso alla tabella, in tempo O(1).
+	Il campionatore fa riferimento ai valori del container da cui è costruito e rappresenta
+	i numeri di occorrenze al momento della costruzione: va ricostruito dopo ogni modifica
+	del container, che deve sopravvivergli.
+
+	@tparam T tipo degli elementi campionati
+*/
+template <typename T>
+class multiset_sampler {
+
+	std::vector<const T*> _values; ///< Valori distinti del container
+	std::vector<double> _prob; ///< Probabilità di accettare la colonna estratta
+	std::vector<std::size_t> _alias; ///< Valore alternativo di ciascuna colonna
+	std::size_t _size; ///< Numero totale di elementi del container
+
+	/**
+		@brief Costruzione della tabella alias
+
+		@param counts numero di occorrenze di ciascun valore di _values
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	void build(const std::vector<std::size_t> &counts) {
+		std::size_t d = counts.size();
+		std::vector<double> scaled(d);
+		std::vector<std::size_t> small, large;
+		_prob.assign(d, 1.0);
+		_alias.resize(d);
+		for(std::size_t i = 0; i < d; ++i) {
+			_alias[i] = i;
+			scaled[i] = static_cast<double>(counts[i]) * d / static_cast<double>(_size);
+			if(scaled[i] < 1.0)
+				small.push_back(i);
+			else
+				large.push_back(i);
+		}
+		while(!small.empty() && !large.empty()) {
+			std::size_t s = small.back(), l = large.back();
+			small.pop_back();
+			_prob[s] = scaled[s];
+			_alias[s] = l;
+			scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+			if(scaled[l] < 1.0) {
+				large.pop_back();
+				small.push_back(l);
+			}
+		}
+		// Le colonne rimaste hanno probabilità 1 (a meno di errori di arrotondamento)
+	}
+
+public:
+
+	typedef std::size_t size_type; ///< Tipo delle dimensioni
+
+	/**
+		@brief Costruttore di default, che crea un campionatore vuoto
+	*/
+	multiset_sampler() : _size(0) {}
+
+	/**
+		@brief Creazione di un campionatore a partire da un MultiSet
+
+		@description
+		Gli elementi distinti sono visitati una sola volta tramite distinct().
+
+		@tparam E funtore di uguaglianza del MultiSet
+		@tparam H funtore di hash del MultiSet
+		@tparam A allocatore del MultiSet
+		@tparam N numero di nodi interni del MultiSet
+
+		@param ms MultiSet da campionare
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename E, typename H, typename A, std::size_t N>
+	explicit multiset_sampler(const MultiSet<T,E,H,A,N> &ms) : _size(ms.size()) {
+		std::vector<std::size_t> counts;
+		_values.reserve(ms.distinct_size());
+		counts.reserve(ms.distinct_size());
+		typename MultiSet<T,E,H,A,N>::distinct_range r = ms.distinct();
+		for(typename MultiSet<T,E,H,A,N>::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			_values.push_back(&i.value());
+			counts.push_back(i.count());
+		}
+		build(counts);
+	}
+
+	/**
+		@brief Creazione di un campionatore a partire da un FlatMultiSet
+
+		@tparam E funtore di uguaglianza del FlatMultiSet
+
+		@param fs FlatMultiSet da campionare
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename E>
+	explicit multiset_sampler(const FlatMultiSet<T,E> &fs) : _size(fs.size()) {
+		std::vector<std::size_t> counts(fs.counts(), fs.counts() + fs.distinct_size());
+		_values.resize(fs.distinct_size());
+		for(std::size_t i = 0; i < fs.distinct_size(); ++i)
+			_values[i] = &fs.value_at(i);
+		build(counts);
+	}
+
+	// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	/**
+		@brief Numero di elementi del container campionato
+
+		@return numero totale di elementi al momento della costruzione
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Estrazione di un valore
+
+		@tparam URNG generatore di numeri casuali uniformi (ad esempio std::mt19937)
+
+		@param g generatore di numeri casuali
+
+		@return riferimento costante al valore estratto, con probabilità pari al suo numero
+		di occorrenze diviso per size()
+
+		@throw multiset_value_not_found se il container campionato è vuoto
+	*/
+	template <typename URNG>
+	const T& operator()(URNG &g) const {
+		if(_values.empty())
+			throw multiset_value_not_found();
+		std::uniform_int_distribution<std::size_t> column(0, _values.size() - 1);
+		std::uniform_real_distribution<double> coin(0.0, 1.0);
+		std::size_t i = column(g);
+		return *_values[(coin(g) < _prob[i]) ? i : _alias[i]];
+	}
+
+	/**
+		@brief Estrazione di n valori, scritti in una sequenza di output
+
+		@tparam URNG generatore di numeri casuali uniformi
+		@tparam OutIt iteratore di output su cui assegnare i valori estratti
+
+		@param g generatore di numeri casuali
+		@param n numero di estrazioni (con reinserimento)
+		@param out iteratore di inizio della sequenza di output
+
+		@return iteratore successivo all'ultimo valore scritto
+
+		@throw multiset_value_not_found se il container campionato è vuoto e n è positivo
+	*/
+	template <typename URNG, typename OutIt>
+	OutIt sample(URNG &g, size_type n, OutIt out) const {
+		if(n == 0)
+			return out;
+		if(_values.empty())
+			throw multiset_value_not_found();
+		std::uniform_int_distribution<std::size_t> column(0, _values.size() - 1);
+		std::uniform_real_distribution<double> coin(0.0, 1.0);
+		for(; n > 0; --n, ++out) {
+			std::size_t i = column(g);
+			*out = *_values[(coin(g) < _prob[i]) ? i : _alias[i]];
+		}
+		return out;
+	}
+
+}; // class multiset_sampler
+
+#endif
+
+// Fine multiset_sampler.h
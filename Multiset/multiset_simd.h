@@ -0,0 +1,220 @@
+/**
+	@headerfile multiset_simd.h
+
+	@brief Ricerca di una chiave aritmetica in un array contiguo, confrontando più chiavi
+	con una sola istruzione, usata da FlatMultiSet.
+
+	@description
+	Con SSE2 (sempre disponibile su x86-64) ogni iterazione confronta 16 chiavi intere a 32 bit
+	o float, oppure 8 chiavi intere a 64 bit o double, con un solo salto condizionato per
+	blocco; la posizione esatta è poi cercata all'interno del blocco. Senza SSE2, o definendo
+	la macro MULTISET_NO_SIMD prima dell'inclusione, i blocchi di 16 chiavi sono confrontati
+	senza salti, in un ciclo che il compilatore può vettorizzare.
+	Il confronto è quello di operator==, come std::equal_to: un NaN non è uguale ad alcuna
+	chiave e 0.0 è uguale a -0.0.
+*/
+
+// Guardie
+
+#ifndef MULTISET_SIMD_H
+#define MULTISET_SIMD_H
+
+// Direttive pre-compilatore
+
+#include <cstddef> // std::size_t
+#include <type_traits> // std::is_arithmetic, std::is_same, std::is_integral, std::integral_constant
+#include "multiset_equal.h" // multiset_plain_equal
+
+#if defined(__SSE2__) && !defined(MULTISET_NO_SIMD)
+#include <emmintrin.h> // _mm_cmpeq_epi32, _mm_cmpeq_ps, _mm_cmpeq_pd, _mm_movemask_epi8
+#define MULTISET_SIMD_SSE2
+#endif
+
+/**
+	@brief Trait che stabilisce se la ricerca di chiavi può usare multiset_scan()
+
+	@description
+	Il valore è true se T è un tipo aritmetico diverso da bool (std::vector<bool> non è
+	contiguo) ed E confronta le chiavi con operator== (vedi multiset_plain_equal).
+
+	@tparam T tipo delle chiavi
+	@tparam E funtore di uguaglianza
+*/
+template <typename T, typename E>
+struct multiset_key_scan {
+	static const bool value = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+		multiset_plain_equal<T,E>::value;
+};
+
+/**
+	@brief Ricerca di una chiave a blocchi di 16, senza istruzioni vettoriali esplicite
+
+	@tparam T tipo aritmetico delle chiavi
+
+	@param keys array delle chiavi
+	@param n numero di chiavi
+	@param v chiave da cercare
+
+	@return indice della prima chiave uguale a v, n se non presente
+*/
+template <typename T>
+std::size_t multiset_scan_blocks(const T *keys, std::size_t n, T v) {
+	std::size_t i = 0;
+	for(; i + 16 <= n; i += 16) {
+		bool hit = false;
+		for(std::size_t j = 0; j < 16; ++j)
+			hit |= (keys[i + j] == v);
+		if(hit)
+			break;
+	}
+	while(i < n && !(keys[i] == v))
+		++i;
+	return i;
+}
+
+#ifdef MULTISET_SIMD_SSE2
+
+/**
+	@brief Categoria di una chiave per la ricerca con SSE2
+
+	@description
+	1 per gli interi a 32 bit, 2 per gli interi a 64 bit, 3 per float, 4 per double,
+	0 per gli altri tipi (ricerca a blocchi senza istruzioni vettoriali).
+
+	@tparam T tipo aritmetico delle chiavi
+*/
+template <typename T>
+struct multiset_scan_kind {
+	static const int value = std::is_integral<T>::value ? (sizeof(T) == 4 ? 1 : (sizeof(T) == 8 ? 2 : 0)) :
+		(std::is_same<T, float>::value ? 3 : (std::is_same<T, double>::value ? 4 : 0));
+};
+
+/**
+	@brief Ricerca per i tipi senza variante SSE2
+*/
+template <typename T>
+std::size_t multiset_scan_sse2(const T *keys, std::size_t n, T v, std::integral_constant<int, 0>) {
+	return multiset_scan_blocks(keys, n, v);
+}
+
+/**
+	@brief Ricerca di un intero a 32 bit, 16 chiavi per iterazione
+*/
+template <typename T>
+std::size_t multiset_scan_sse2(const T *keys, std::size_t n, T v, std::integral_constant<int, 1>) {
+	const __m128i key = _mm_set1_epi32(static_cast<int>(v));
+	std::size_t i = 0;
+	for(; i + 16 <= n; i += 16) {
+		const __m128i *p = reinterpret_cast<const __m128i*>(keys + i);
+		__m128i a = _mm_cmpeq_epi32(_mm_loadu_si128(p), key);
+		__m128i b = _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), key);
+		__m128i c = _mm_cmpeq_epi32(_mm_loadu_si128(p + 2), key);
+		__m128i d = _mm_cmpeq_epi32(_mm_loadu_si128(p + 3), key);
+		if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0)
+			break;
+	}
+	while(i < n && keys[i] != v)
+		++i;
+	return i;
+}
+
+/**
+	@brief Confronto di due interi a 64 bit per vettore
+
+	@description
+	SSE2 confronta solo interi a 32 bit: le due metà di ogni intero devono essere uguali.
+
+	@param a vettore di due interi a 64 bit
+	@param key vettore con la chiave ripetuta
+
+	@return vettore con tutti i bit a 1 negli interi uguali alla chiave
+*/
+inline __m128i multiset_cmpeq_epi64(__m128i a, __m128i key) {
+	__m128i eq = _mm_cmpeq_epi32(a, key);
+	return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+/**
+	@brief Ricerca di un intero a 64 bit, 8 chiavi per iterazione
+*/
+template <typename T>
+std::size_t multiset_scan_sse2(const T *keys, std::size_t n, T v, std::integral_constant<int, 2>) {
+	const __m128i key = _mm_set1_epi64x(static_cast<long long>(v));
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		const __m128i *p = reinterpret_cast<const __m128i*>(keys + i);
+		__m128i a = multiset_cmpeq_epi64(_mm_loadu_si128(p), key);
+		__m128i b = multiset_cmpeq_epi64(_mm_loadu_si128(p + 1), key);
+		__m128i c = multiset_cmpeq_epi64(_mm_loadu_si128(p + 2), key);
+		__m128i d = multiset_cmpeq_epi64(_mm_loadu_si128(p + 3), key);
+		if(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))) != 0)
+			break;
+	}
+	while(i < n && keys[i] != v)
+		++i;
+	return i;
+}
+
+/**
+	@brief Ricerca di un float, 16 chiavi per iterazione
+*/
+inline std::size_t multiset_scan_sse2(const float *keys, std::size_t n, float v, std::integral_constant<int, 3>) {
+	const __m128 key = _mm_set1_ps(v);
+	std::size_t i = 0;
+	for(; i + 16 <= n; i += 16) {
+		__m128 a = _mm_cmpeq_ps(_mm_loadu_ps(keys + i), key);
+		__m128 b = _mm_cmpeq_ps(_mm_loadu_ps(keys + i + 4), key);
+		__m128 c = _mm_cmpeq_ps(_mm_loadu_ps(keys + i + 8), key);
+		__m128 d = _mm_cmpeq_ps(_mm_loadu_ps(keys + i + 12), key);
+		if(_mm_movemask_ps(_mm_or_ps(_mm_or_ps(a, b), _mm_or_ps(c, d))) != 0)
+			break;
+	}
+	while(i < n && !(keys[i] == v))
+		++i;
+	return i;
+}
+
+/**
+	@brief Ricerca di un double, 8 chiavi per iterazione
+*/
+inline std::size_t multiset_scan_sse2(const double *keys, std::size_t n, double v, std::integral_constant<int, 4>) {
+	const __m128d key = _mm_set1_pd(v);
+	std::size_t i = 0;
+	for(; i + 8 <= n; i += 8) {
+		__m128d a = _mm_cmpeq_pd(_mm_loadu_pd(keys + i), key);
+		__m128d b = _mm_cmpeq_pd(_mm_loadu_pd(keys + i + 2), key);
+		__m128d c = _mm_cmpeq_pd(_mm_loadu_pd(keys + i + 4), key);
+		__m128d d = _mm_cmpeq_pd(_mm_loadu_pd(keys + i + 6), key);
+		if(_mm_movemask_pd(_mm_or_pd(_mm_or_pd(a, b), _mm_or_pd(c, d))) != 0)
+			break;
+	}
+	while(i < n && !(keys[i] == v))
+		++i;
+	return i;
+}
+
+#endif
+
+/**
+	@brief Ricerca di una chiave aritmetica in un array contiguo
+
+	@tparam T tipo aritmetico delle chiavi (diverso da bool)
+
+	@param keys array delle chiavi
+	@param n numero di chiavi
+	@param v chiave da cercare
+
+	@return indice della prima chiave uguale a v (secondo operator==), n se non presente
+*/
+template <typename T>
+std::size_t multiset_scan(const T *keys, std::size_t n, T v) {
+#ifdef MULTISET_SIMD_SSE2
+	return multiset_scan_sse2(keys, n, v, std::integral_constant<int, multiset_scan_kind<T>::value>());
+#else
+	return multiset_scan_blocks(keys, n, v);
+#endif
+}
+
+#endif
+
+// Fine multiset_simd.h
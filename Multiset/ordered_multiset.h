@@ -0,0 +1,1535 @@
+/**
+	@headerfile ordered_multiset.h
+
+	@brief Dichiarazione e definizione di una classe templata OrderedMultiSet,
+	rappresentata tramite un B-tree, con ridefinizione dell'operatore di stream <<.
+
+	@description
+	Come per MultiSet, la macro MULTISET_NO_ITERATOR_CHECKS disattiva la verifica dei limiti
+	nell'incremento degli iteratori.
+*/
+
+// Guardie
+
+#ifndef ORDERED_MULTISET_H
+#define ORDERED_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <ostream> // std::ostream
+#include <algorithm> // std::swap
+#include <iterator> // std::forward_iterator_tag
+#include <functional> // std::less
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <limits> // std::numeric_limits
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_iterator_out_of_bounds, multiset_value_not_found, multiset_count_overflow
+
+/**
+	@brief MultiSet ordinato templato su due parametri
+
+	@description
+	Variante di MultiSet in cui gli elementi sono mantenuti ordinati secondo un
+	ordinamento stretto debole. Due elementi a e b sono considerati uguali se
+	né a < b né b < a.
+	Gli elementi distinti sono memorizzati in un B-tree: ogni nodo contiene fino a
+	max_keys valori contigui in memoria, con il relativo numero di occorrenze.
+	Ogni nodo memorizza anche il numero totale di elementi del proprio sottoalbero,
+	così che i conteggi su intervalli non richiedano di visitare gli elementi.
+	Inserimento, ricerca e rimozione hanno costo O(log n).
+
+	@pre Il tipo T dev'essere default-costruibile ed assegnabile
+
+	@tparam T tipo degli elementi di un OrderedMultiSet
+	@tparam Less funtore di confronto "minore di" tra elementi dell'OrderedMultiSet
+*/
+template <typename T, typename Less = std::less<T>>
+class OrderedMultiSet {
+
+	// Sezione privata della classe
+
+	// Costanti private
+
+	static const unsigned int min_degree = 16; ///< Grado minimo del B-tree
+	static const unsigned int max_keys = 2 * min_degree - 1; ///< Numero massimo di valori in un nodo
+
+	/**
+		Struct che implementa un nodo del B-tree
+	*/
+	struct bnode {
+		T keys[max_keys]; ///< Valori distinti del nodo, in ordine crescente
+		std::size_t counts[max_keys]; ///< Numero di occorrenze di ciascun valore
+		bnode *children[max_keys + 1]; ///< Puntatori ai figli (non usati nelle foglie)
+		bnode *parent; ///< Puntatore al nodo padre (nullptr per la radice)
+		unsigned int index; ///< Posizione del nodo tra i figli del padre
+		unsigned int nkeys; ///< Numero di valori presenti nel nodo
+		std::size_t total; ///< Numero totale di elementi nel sottoalbero
+		bool leaf; ///< True se il nodo è una foglia
+
+		/**
+			@brief Costruttore per un nodo
+
+			@description
+			Questo metodo crea un nodo vuoto, senza padre.
+
+			@param l true se il nodo è una foglia
+		*/
+		explicit bnode(bool l) : parent(nullptr), index(0), nkeys(0), total(0), leaf(l) {}
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct bnode
+
+	/**
+		Operazioni insiemistiche eseguite da merge()
+	*/
+	enum merge_op {
+		merge_sum, ///< Somma dei numeri di occorrenze
+		merge_union, ///< Massimo dei numeri di occorrenze
+		merge_intersection, ///< Minimo dei numeri di occorrenze
+		merge_difference ///< Differenza troncata dei numeri di occorrenze
+	};
+
+	// Altri dati membro privati
+
+	bnode *_root; ///< Puntatore alla radice del B-tree
+	std::size_t _size; ///< Numero totale di elementi
+	std::size_t _distinct; ///< Numero di elementi distinti
+
+	Less _less; ///< Istanza del funtore di confronto
+
+	// Altri metodi privati
+
+	/**
+		@brief Uguaglianza tra due elementi derivata dal funtore di confronto
+
+		@param a primo elemento
+		@param b secondo elemento
+
+		@return true se né a < b né b < a, false altrimenti
+	*/
+	bool equivalent(const T &a, const T &b) const {
+		return !_less(a, b) && !_less(b, a);
+	}
+
+	/**
+		@brief Posizione del primo valore di un nodo non minore di v
+
+		@param x nodo in cui cercare
+		@param v valore da cercare
+
+		@return indice del primo valore non minore di v, nkeys se non esiste
+	*/
+	unsigned int lower_index(const bnode *x, const T &v) const {
+		unsigned int lo = 0, hi = x->nkeys;
+		while(lo < hi) {
+			unsigned int mid = (lo + hi) / 2;
+			if(_less(x->keys[mid], v))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	/**
+		@brief Posizione del primo valore di un nodo maggiore di v
+
+		@param x nodo in cui cercare
+		@param v valore da cercare
+
+		@return indice del primo valore maggiore di v, nkeys se non esiste
+	*/
+	unsigned int upper_index(const bnode *x, const T &v) const {
+		unsigned int lo = 0, hi = x->nkeys;
+		while(lo < hi) {
+			unsigned int mid = (lo + hi) / 2;
+			if(_less(v, x->keys[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	/**
+		@brief Ricerca di un valore nel B-tree
+
+		@param v valore da cercare
+		@param pos posizione del valore nel nodo restituito
+
+		@return puntatore al nodo contenente il valore, nullptr se non presente
+	*/
+	bnode* find(const T &v, unsigned int &pos) const {
+		bnode *x = _root;
+		while(x != nullptr) {
+			unsigned int i = lower_index(x, v);
+			if(i < x->nkeys && !_less(v, x->keys[i])) {
+				pos = i;
+				return x;
+			}
+			x = x->leaf ? nullptr : x->children[i];
+		}
+		return nullptr;
+	}
+
+	/**
+		@brief Ricalcolo del numero di elementi del sottoalbero di un nodo
+
+		@param x nodo da aggiornare
+
+		@post x->total è la somma delle occorrenze dei valori di x e dei totali dei figli
+	*/
+	static void recount(bnode *x) {
+		std::size_t sum = 0;
+		for(unsigned int i = 0; i < x->nkeys; ++i)
+			sum += x->counts[i];
+		if(!x->leaf)
+			for(unsigned int i = 0; i <= x->nkeys; ++i)
+				sum += x->children[i]->total;
+		x->total = sum;
+	}
+
+	/**
+		@brief Aggiornamento dei puntatori al padre dei figli di un nodo
+
+		@param x nodo i cui figli sono stati spostati
+
+		@post Ogni figlio di x ha x come padre e la propria posizione come indice
+	*/
+	static void adopt(bnode *x) {
+		if(x->leaf)
+			return;
+		for(unsigned int i = 0; i <= x->nkeys; ++i) {
+			x->children[i]->parent = x;
+			x->children[i]->index = i;
+		}
+	}
+
+	/**
+		@brief Aggiornamento dei totali dei nodi da un nodo fino alla radice
+
+		@param x nodo da cui iniziare l'aggiornamento
+		@param k valore di cui variare i totali
+		@param inc true per incrementare i totali di k, false per decrementarli
+	*/
+	static void update_path(bnode *x, std::size_t k, bool inc) {
+		for(; x != nullptr; x = x->parent) {
+			if(inc)
+				x->total += k;
+			else
+				x->total -= k;
+		}
+	}
+
+	/**
+		@brief Divisione di un figlio pieno
+
+		@description
+		Il figlio i-esimo di x, che contiene max_keys valori, viene diviso in due nodi
+		da min_degree - 1 valori ciascuno. Il valore mediano risale in x.
+
+		@pre x non è pieno e il suo figlio i-esimo è pieno
+
+		@param x nodo padre
+		@param i posizione del figlio da dividere
+
+		@throw Eccezione di allocazione di memoria (il B-tree resta invariato)
+	*/
+	void split_child(bnode *x, unsigned int i) {
+		bnode *y = x->children[i];
+		bnode *z = new bnode(y->leaf);
+
+		for(unsigned int j = 0; j < min_degree - 1; ++j) {
+			z->keys[j] = y->keys[j + min_degree];
+			z->counts[j] = y->counts[j + min_degree];
+			y->keys[j + min_degree] = T();
+		}
+		if(!y->leaf)
+			for(unsigned int j = 0; j < min_degree; ++j)
+				z->children[j] = y->children[j + min_degree];
+		z->nkeys = min_degree - 1;
+		y->nkeys = min_degree - 1;
+
+		for(unsigned int j = x->nkeys; j > i; --j) {
+			x->keys[j] = x->keys[j - 1];
+			x->counts[j] = x->counts[j - 1];
+			x->children[j + 1] = x->children[j];
+		}
+		x->keys[i] = y->keys[min_degree - 1];
+		x->counts[i] = y->counts[min_degree - 1];
+		y->keys[min_degree - 1] = T();
+		x->children[i + 1] = z;
+		x->nkeys++;
+
+		adopt(x);
+		adopt(z);
+		recount(y);
+		recount(z);
+	}
+
+	/**
+		@brief Unione di due figli adiacenti
+
+		@description
+		Il figlio (i+1)-esimo di x ed il valore i-esimo di x sono accodati al
+		figlio i-esimo, che diventa pieno. Il figlio (i+1)-esimo è deallocato.
+
+		@pre I figli i-esimo ed (i+1)-esimo di x contengono min_degree - 1 valori
+
+		@param x nodo padre
+		@param i posizione del figlio sinistro
+	*/
+	void merge_children(bnode *x, unsigned int i) {
+		bnode *y = x->children[i];
+		bnode *z = x->children[i + 1];
+
+		y->keys[min_degree - 1] = x->keys[i];
+		y->counts[min_degree - 1] = x->counts[i];
+		for(unsigned int j = 0; j < z->nkeys; ++j) {
+			y->keys[j + min_degree] = z->keys[j];
+			y->counts[j + min_degree] = z->counts[j];
+		}
+		if(!y->leaf)
+			for(unsigned int j = 0; j <= z->nkeys; ++j)
+				y->children[j + min_degree] = z->children[j];
+		y->nkeys = max_keys;
+
+		for(unsigned int j = i; j + 1 < x->nkeys; ++j) {
+			x->keys[j] = x->keys[j + 1];
+			x->counts[j] = x->counts[j + 1];
+			x->children[j + 1] = x->children[j + 2];
+		}
+		x->nkeys--;
+		x->keys[x->nkeys] = T();
+
+		adopt(x);
+		adopt(y);
+		recount(y);
+		delete z;
+	}
+
+	/**
+		@brief Garanzia che un figlio abbia almeno min_degree valori
+
+		@description
+		Se il figlio i-esimo di x ha il numero minimo di valori, gliene viene ceduto uno
+		da un fratello adiacente tramite x (rotazione) oppure, se entrambi i fratelli hanno
+		il numero minimo di valori, il figlio viene unito ad uno di essi.
+
+		@param x nodo padre
+		@param i posizione del figlio
+
+		@return posizione del figlio in cui proseguire la discesa
+	*/
+	unsigned int fill_child(bnode *x, unsigned int i) {
+		bnode *c = x->children[i];
+
+		if(i > 0 && x->children[i - 1]->nkeys >= min_degree) { // Rotazione dal fratello sinistro
+			bnode *l = x->children[i - 1];
+			for(unsigned int j = c->nkeys; j > 0; --j) {
+				c->keys[j] = c->keys[j - 1];
+				c->counts[j] = c->counts[j - 1];
+			}
+			if(!c->leaf)
+				for(unsigned int j = c->nkeys + 1; j > 0; --j)
+					c->children[j] = c->children[j - 1];
+			c->keys[0] = x->keys[i - 1];
+			c->counts[0] = x->counts[i - 1];
+			if(!c->leaf)
+				c->children[0] = l->children[l->nkeys];
+			x->keys[i - 1] = l->keys[l->nkeys - 1];
+			x->counts[i - 1] = l->counts[l->nkeys - 1];
+			l->keys[l->nkeys - 1] = T();
+			l->nkeys--;
+			c->nkeys++;
+			adopt(c);
+			recount(l);
+			recount(c);
+			return i;
+		}
+
+		if(i < x->nkeys && x->children[i + 1]->nkeys >= min_degree) { // Rotazione dal fratello destro
+			bnode *r = x->children[i + 1];
+			c->keys[c->nkeys] = x->keys[i];
+			c->counts[c->nkeys] = x->counts[i];
+			if(!c->leaf)
+				c->children[c->nkeys + 1] = r->children[0];
+			x->keys[i] = r->keys[0];
+			x->counts[i] = r->counts[0];
+			for(unsigned int j = 0; j + 1 < r->nkeys; ++j) {
+				r->keys[j] = r->keys[j + 1];
+				r->counts[j] = r->counts[j + 1];
+			}
+			if(!r->leaf)
+				for(unsigned int j = 0; j < r->nkeys; ++j)
+					r->children[j] = r->children[j + 1];
+			r->nkeys--;
+			r->keys[r->nkeys] = T();
+			c->nkeys++;
+			adopt(c);
+			adopt(r);
+			recount(r);
+			recount(c);
+			return i;
+		}
+
+		if(i < x->nkeys) { // Unione con il fratello destro
+			merge_children(x, i);
+			return i;
+		}
+		merge_children(x, i - 1); // Unione con il fratello sinistro
+		return i - 1;
+	}
+
+	/**
+		@brief Metodo ausiliario ricorsivo di eliminazione di un valore distinto
+
+		@description
+		Elimina dal sottoalbero di x il valore v, indipendentemente dal suo numero di
+		occorrenze. Durante la discesa ogni figlio visitato viene portato ad almeno
+		min_degree valori, così che l'eliminazione non debba mai risalire l'albero.
+
+		@pre v è presente nel sottoalbero di x
+
+		@param x radice del sottoalbero
+		@param v valore da eliminare
+
+		@post I totali dei nodi del sottoalbero sono aggiornati
+	*/
+	void erase(bnode *x, const T &v) {
+		unsigned int i = lower_index(x, v);
+
+		if(i < x->nkeys && !_less(v, x->keys[i])) {
+			if(x->leaf) {
+				for(unsigned int j = i; j + 1 < x->nkeys; ++j) {
+					x->keys[j] = x->keys[j + 1];
+					x->counts[j] = x->counts[j + 1];
+				}
+				x->nkeys--;
+				x->keys[x->nkeys] = T();
+			}
+			else if(x->children[i]->nkeys >= min_degree) { // Sostituzione con il predecessore
+				bnode *p = x->children[i];
+				while(!p->leaf)
+					p = p->children[p->nkeys];
+				x->keys[i] = p->keys[p->nkeys - 1];
+				x->counts[i] = p->counts[p->nkeys - 1];
+				erase(x->children[i], x->keys[i]);
+			}
+			else if(x->children[i + 1]->nkeys >= min_degree) { // Sostituzione con il successore
+				bnode *s = x->children[i + 1];
+				while(!s->leaf)
+					s = s->children[0];
+				x->keys[i] = s->keys[0];
+				x->counts[i] = s->counts[0];
+				erase(x->children[i + 1], x->keys[i]);
+			}
+			else {
+				merge_children(x, i);
+				erase(x->children[i], v);
+			}
+		}
+		else {
+			if(x->children[i]->nkeys < min_degree)
+				i = fill_child(x, i);
+			erase(x->children[i], v);
+		}
+		recount(x);
+	}
+
+	/**
+		@brief Copia ricorsiva di un sottoalbero
+
+		@param x radice del sottoalbero da copiare
+
+		@return radice della copia
+
+		@throw Eccezione di allocazione di memoria (la copia parziale è deallocata)
+	*/
+	static bnode* clone(const bnode *x) {
+		bnode *y = new bnode(x->leaf);
+		unsigned int copied = 0; // Numero di figli già copiati
+
+		try {
+			for(unsigned int i = 0; i < x->nkeys; ++i) {
+				y->keys[i] = x->keys[i];
+				y->counts[i] = x->counts[i];
+			}
+			if(!x->leaf)
+				for(; copied <= x->nkeys; ++copied)
+					y->children[copied] = clone(x->children[copied]);
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			for(unsigned int i = 0; i < copied; ++i)
+				destroy(y->children[i]);
+			delete y;
+			throw;
+		}
+		y->nkeys = x->nkeys;
+		y->total = x->total;
+		adopt(y);
+		return y;
+	}
+
+	/**
+		@brief Deallocazione ricorsiva di un sottoalbero
+
+		@param x radice del sottoalbero da deallocare
+	*/
+	static void destroy(bnode *x) {
+		if(x == nullptr)
+			return;
+		if(!x->leaf)
+			for(unsigned int i = 0; i <= x->nkeys; ++i)
+				destroy(x->children[i]);
+		delete x;
+	}
+
+	/**
+		@brief Metodo di rimozione contenuto dell'OrderedMultiSet
+
+		@post La memoria allocata per l'OrderedMultiSet è deallocata
+	*/
+	void clear() {
+		destroy(_root);
+		_root = nullptr;
+		_size = 0;
+		_distinct = 0;
+	}
+
+	/**
+		@brief Eliminazione di un valore distinto dal B-tree
+
+		@description
+		Il valore è eliminato tramite erase(); se la radice resta senza valori, viene
+		sostituita dal suo unico figlio (o l'albero diventa vuoto).
+
+		Il valore viene copiato prima della discesa: v può essere un riferimento ad un valore
+		dell'albero (ad esempio *begin()), che le unioni e le rotazioni spostano o sovrascrivono.
+
+		@pre v è presente nell'OrderedMultiSet
+
+		@param v valore da eliminare
+
+		@post Il numero di elementi distinti è diminuito di 1 (_size non viene modificato)
+	*/
+	void erase_distinct(const T &v) {
+		const T key(v);
+		erase(_root, key);
+		_distinct--;
+		if(_root->nkeys == 0) {
+			bnode *old = _root;
+			_root = _root->leaf ? nullptr : _root->children[0];
+			if(_root != nullptr)
+				_root->parent = nullptr;
+			delete old;
+		}
+	}
+
+	/**
+		@brief Costruzione di un sottoalbero da una sequenza ordinata di valori distinti
+
+		@description
+		I valori keys[lo, lo + n) sono distribuiti tra c figli di altezza h - 1, separati da
+		c - 1 valori del nodo, con c minimo tale che ogni figlio non superi la capacità massima
+		caps[h - 1] (e almeno 2). I figli ricevono lo stesso numero di valori, a meno di uno:
+		ciò garantisce che ogni nodo non radice abbia almeno min_degree - 1 valori.
+		Ogni valore è copiato una sola volta, quindi il costo è lineare in n.
+
+		@pre caps[h - 1] < n <= caps[h] per la radice, n >= min_degree^(h + 1) - 1 per gli altri nodi
+
+		@param keys valori distinti, in ordine crescente
+		@param counts numero di occorrenze di ciascun valore
+		@param lo posizione del primo valore del sottoalbero
+		@param n numero di valori del sottoalbero
+		@param h altezza del sottoalbero (0 per una foglia)
+		@param caps capacità massima di un sottoalbero di ciascuna altezza
+
+		@return radice del sottoalbero
+
+		@throw Eccezione di allocazione di memoria (il sottoalbero parziale è deallocato)
+	*/
+	static bnode* build(const std::vector<T> &keys, const std::vector<std::size_t> &counts, std::size_t lo,
+		std::size_t n, unsigned int h, const std::vector<std::size_t> &caps) {
+		bnode *x = new bnode(h == 0);
+
+		if(h == 0) {
+			for(unsigned int i = 0; i < n; ++i) {
+				x->keys[i] = keys[lo + i];
+				x->counts[i] = counts[lo + i];
+			}
+			x->nkeys = static_cast<unsigned int>(n);
+			recount(x);
+			return x;
+		}
+
+		std::size_t c = (n + 1 + caps[h - 1]) / (caps[h - 1] + 1); // ceil((n + 1) / (caps[h - 1] + 1))
+		if(c < 2)
+			c = 2;
+		std::size_t base = (n - (c - 1)) / c, extra = (n - (c - 1)) % c;
+		unsigned int built = 0; // Numero di figli già costruiti
+
+		try {
+			for(; built < c; ++built) {
+				std::size_t m = base + (built < extra ? 1 : 0);
+				x->children[built] = build(keys, counts, lo, m, h - 1, caps);
+				lo += m;
+				if(built + 1 < c) {
+					x->keys[built] = keys[lo];
+					x->counts[built] = counts[lo];
+					lo++;
+				}
+			}
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			for(unsigned int i = 0; i < built; ++i)
+				destroy(x->children[i]);
+			delete x;
+			throw;
+		}
+		x->nkeys = static_cast<unsigned int>(c - 1);
+		recount(x);
+		adopt(x);
+		return x;
+	}
+
+	/**
+		@brief Operazione insiemistica con un altro OrderedMultiSet
+
+		@description
+		I valori distinti dei due OrderedMultiSet sono scorsi in parallelo, in ordine
+		crescente, calcolando il numero di occorrenze del risultato per ciascun valore.
+		Il B-tree del risultato è poi costruito direttamente tramite build(): il costo
+		totale è lineare nel numero di valori distinti dei due OrderedMultiSet.
+		Il risultato sostituisce il contenuto dell'OrderedMultiSet corrente solo al termine,
+		quindi in caso di eccezione l'OrderedMultiSet corrente resta invariato.
+
+		@param other secondo operando
+		@param op operazione da eseguire
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (solo per la somma)
+	*/
+	void merge(const OrderedMultiSet &other, merge_op op) {
+		if(op == merge_sum && other._size > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+
+		std::vector<T> keys;
+		std::vector<std::size_t> counts;
+		std::size_t size = 0;
+		const_iterator i = begin(), j = other.begin(), ie = end(), je = other.end();
+
+		keys.reserve(_distinct + (op == merge_sum || op == merge_union ? other._distinct : 0));
+		counts.reserve(keys.capacity());
+		while(i != ie || j != je) {
+			const T *v;
+			std::size_t a = 0, b = 0;
+			if(j == je || (i != ie && _less(*i, *j))) {
+				v = &(*i);
+				a = i.ptr->counts[i.pos];
+				i.next_distinct();
+			}
+			else if(i == ie || _less(*j, *i)) {
+				v = &(*j);
+				b = j.ptr->counts[j.pos];
+				j.next_distinct();
+			}
+			else {
+				v = &(*i);
+				a = i.ptr->counts[i.pos];
+				b = j.ptr->counts[j.pos];
+				i.next_distinct();
+				j.next_distinct();
+			}
+
+			std::size_t k;
+			switch(op) {
+				case merge_sum: k = a + b; break;
+				case merge_union: k = (a > b) ? a : b; break;
+				case merge_intersection: k = (a < b) ? a : b; break;
+				default: k = (a > b) ? a - b : 0; break;
+			}
+			if(k > 0) {
+				keys.push_back(*v);
+				counts.push_back(k);
+				size += k;
+			}
+		}
+
+		std::vector<std::size_t> caps(1, max_keys);
+		while(caps.back() < keys.size())
+			caps.push_back((caps.back() + 1) * (max_keys + 1) - 1);
+
+		bnode *root = keys.empty() ? nullptr : build(keys, counts, 0, keys.size(), static_cast<unsigned int>(caps.size() - 1), caps);
+		destroy(_root);
+		_root = root;
+		_size = size;
+		_distinct = keys.size();
+	}
+
+	/**
+		@brief Numero di elementi strettamente minori (o non maggiori) di un valore
+
+		@description
+		La discesa nel B-tree somma i totali dei sottoalberi che si trovano interamente
+		a sinistra del cammino, senza visitarne gli elementi.
+
+		@param v valore di confronto
+		@param inclusive true per contare anche gli elementi uguali a v
+
+		@return numero di elementi minori (o minori o uguali) di v
+	*/
+	std::size_t count_before(const T &v, bool inclusive) const {
+		std::size_t sum = 0;
+		const bnode *x = _root;
+
+		while(x != nullptr) {
+			unsigned int i = inclusive ? upper_index(x, v) : lower_index(x, v);
+			for(unsigned int j = 0; j < i; ++j) {
+				sum += x->counts[j];
+				if(!x->leaf)
+					sum += x->children[j]->total;
+			}
+			x = x->leaf ? nullptr : x->children[i];
+		}
+		return sum;
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	// Tipi pubblici
+
+	typedef std::size_t size_type; ///< Tipo del numero di occorrenze e del numero di elementi
+
+	// Metodi pubblici fondamentali
+
+	/**
+		@brief Costruttore di default per OrderedMultiSet
+
+		@description
+		Questo metodo istanzia un OrderedMultiSet vuoto, con radice nulla.
+	*/
+	OrderedMultiSet() : _root(nullptr), _size(0), _distinct(0) {}
+
+	/**
+		@brief Costruttore di copia per OrderedMultiSet
+
+		@description
+		Il B-tree viene copiato nodo per nodo, senza ripetere gli inserimenti.
+
+		@param other OrderedMultiSet da copiare per istanziare quello corrente
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	OrderedMultiSet(const OrderedMultiSet &other) : _root(nullptr), _size(other._size), _distinct(other._distinct) {
+		if(other._root != nullptr)
+			_root = clone(other._root);
+	}
+
+	/**
+		@brief Operatore di assegnamento per OrderedMultiSet
+
+		@description
+		La copia avviene tramite copy-constructor ed utilizzo della funzione std::swap.
+
+		@param other OrderedMultiSet "sorgente" da copiare
+
+		@return Riferimento all'OrderedMultiSet corrente
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	OrderedMultiSet& operator=(const OrderedMultiSet &other) {
+		if(this != &other) {
+			OrderedMultiSet tmp(other);
+			std::swap(this->_root, tmp._root);
+			std::swap(this->_size, tmp._size);
+			std::swap(this->_distinct, tmp._distinct);
+		}
+		return *this;
+	}
+
+	/**
+		@brief Distruttore per OrderedMultiSet
+
+		@post La memoria allocata da tutti gli elementi dell'OrderedMultiSet è deallocata
+	*/
+	~OrderedMultiSet() {
+		clear();
+	}
+
+	/**
+		@brief Creazione di un OrderedMultiSet a partire da una sequenza identificata da due iteratori generici
+
+		@pre Il tipo dei valori della sequenza dev'essere castabile nel tipo T
+
+		@tparam IterT tipo degli iteratori che identificano la sequenza generica
+
+		@param begin iteratore che punta all'inizio della sequenza
+		@param end iteratore che punta alla fine della sequenza
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	template <typename IterT>
+	OrderedMultiSet(IterT begin, IterT end) : _root(nullptr), _size(0), _distinct(0) {
+		try {
+			while(begin != end) {
+				add(static_cast<T>(*begin));
+				++begin;
+			}
+		}
+		catch(...) { // Eccezione di allocazione di memoria
+			clear();
+			throw;
+		}
+	}
+
+	// Metodi pubblici non fondamentali
+
+	/**
+		@brief Numero di elementi di un OrderedMultiSet
+
+		@return numero totale di elementi
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di elementi distinti di un OrderedMultiSet
+
+		@return numero di elementi distinti
+	*/
+	size_type distinct_size() const {
+		return _distinct;
+	}
+
+	/**
+		@brief Ricerca di un elemento nell'OrderedMultiSet
+
+		@param v elemento da cercare
+
+		@return True se l'elemento è presente, false altrimenti
+	*/
+	bool contains(const T &v) const {
+		unsigned int pos;
+		return find(v, pos) != nullptr;
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento dell'OrderedMultiSet
+
+		@param v valore di cui sapere il numero di occorrenze
+
+		@return numero di occorrenze se il valore è presente, 0 altrimenti
+	*/
+	size_type nocc(const T &v) const {
+		unsigned int pos;
+		bnode *x = find(v, pos);
+		if(x != nullptr)
+			return x->counts[pos];
+		return 0;
+	}
+
+	/**
+		@brief Inserimento di un elemento nell'OrderedMultiSet
+
+		@description
+		Equivale ad add(v, 1).
+
+		@param v valore da inserire
+
+		@post Il numero totale di elementi è incrementato di 1
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v) {
+		add(v, 1);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento nell'OrderedMultiSet
+
+		@description
+		Se il valore è presente, il suo numero di occorrenze è incrementato di k.
+		Altrimenti il valore è inserito in una foglia: i nodi pieni incontrati durante
+		la discesa vengono divisi preventivamente, così che l'inserimento non debba
+		mai risalire l'albero. Infine i totali del cammino vengono incrementati.
+		Se k è 0 l'OrderedMultiSet non viene modificato.
+
+		@param v valore da inserire
+		@param k numero di occorrenze da inserire
+
+		@post Il numero totale di elementi è incrementato di k
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (l'OrderedMultiSet resta invariato)
+	*/
+	void add(const T &v, size_type k) {
+		if(k == 0)
+			return;
+		if(k > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+
+		unsigned int pos;
+		bnode *x = find(v, pos);
+
+		if(x != nullptr) {
+			x->counts[pos] += k;
+			update_path(x, k, true);
+			_size += k;
+			return;
+		}
+
+		if(_root == nullptr)
+			_root = new bnode(true);
+		else if(_root->nkeys == max_keys) {
+			bnode *s = new bnode(false);
+			s->children[0] = _root;
+			s->total = _root->total;
+			adopt(s);
+			try {
+				split_child(s, 0);
+			}
+			catch(...) { // Eccezione di allocazione di memoria
+				_root->parent = nullptr;
+				delete s;
+				throw;
+			}
+			_root = s;
+		}
+
+		x = _root;
+		while(!x->leaf) {
+			unsigned int i = lower_index(x, v);
+			if(x->children[i]->nkeys == max_keys) {
+				split_child(x, i);
+				if(_less(x->keys[i], v))
+					i++;
+			}
+			x = x->children[i];
+		}
+
+		unsigned int i = lower_index(x, v);
+		for(unsigned int j = x->nkeys; j > i; --j) {
+			x->keys[j] = x->keys[j - 1];
+			x->counts[j] = x->counts[j - 1];
+		}
+		x->keys[i] = v;
+		x->counts[i] = k;
+		x->nkeys++;
+		update_path(x, k, true);
+		_size += k;
+		_distinct++;
+	}
+
+	/**
+		@brief Rimozione di un elemento dall'OrderedMultiSet
+
+		@description
+		Equivale a remove(v, 1).
+
+		@pre L'elemento dev'essere presente
+
+		@param v valore da rimuovere
+
+		@post Il numero totale di elementi è diminuito di 1
+
+		@throw Eccezione custom per elemento non presente
+	*/
+	void remove(const T &v) {
+		remove(v, 1);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento dall'OrderedMultiSet
+
+		@description
+		Se il valore ha più di k occorrenze, ne viene decrementato il numero di occorrenze.
+		Se ne ha esattamente k, il valore viene eliminato dal B-tree. Se ne ha meno di k,
+		viene lanciata un'eccezione custom e l'OrderedMultiSet non viene modificato.
+
+		@pre Il valore deve avere almeno k occorrenze
+
+		@param v valore da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@post Il numero totale di elementi è diminuito di k
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove(const T &v, size_type k) {
+		if(k == 0)
+			return;
+
+		unsigned int pos;
+		bnode *x = find(v, pos);
+
+		if(x == nullptr || x->counts[pos] < k)
+			throw multiset_value_not_found();
+
+		if(x->counts[pos] > k) {
+			x->counts[pos] -= k;
+			update_path(x, k, false);
+		}
+		else
+			erase_distinct(v);
+		_size -= k;
+	}
+
+	/**
+		@brief Impostazione del numero di occorrenze di un elemento
+
+		@description
+		Il numero di occorrenze di v diventa k: se k è 0 il valore viene eliminato (se
+		presente), se v non è presente viene inserito con k occorrenze.
+
+		@param v valore di cui impostare il numero di occorrenze
+		@param k nuovo numero di occorrenze
+
+		@post nocc(v) restituisce k
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (l'OrderedMultiSet resta invariato)
+	*/
+	void set_count(const T &v, size_type k) {
+		unsigned int pos;
+		bnode *x = find(v, pos);
+
+		if(x == nullptr) {
+			add(v, k);
+			return;
+		}
+		std::size_t old = x->counts[pos];
+		if(k > old && k - old > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		if(k == 0)
+			erase_distinct(v);
+		else if(k > old)
+			update_path(x, k - old, true);
+		else
+			update_path(x, old - k, false);
+		if(k != 0)
+			x->counts[pos] = k;
+		_size = _size - old + k;
+	}
+
+	/**
+		@brief Numero di elementi compresi in un intervallo chiuso
+
+		@description
+		Restituisce il numero di elementi x (contati con le loro occorrenze) tali che
+		a <= x <= b, senza visitare gli elementi dell'intervallo.
+
+		@param a estremo inferiore dell'intervallo
+		@param b estremo superiore dell'intervallo
+
+		@return numero di elementi compresi tra a e b, 0 se b < a
+	*/
+	size_type count_range(const T &a, const T &b) const {
+		if(_less(b, a))
+			return 0;
+		return count_before(b, true) - count_before(a, false);
+	}
+
+	/**
+		@brief Numero di elementi strettamente minori di un valore
+
+		@param v valore di confronto
+
+		@return numero di elementi minori di v
+	*/
+	size_type rank(const T &v) const {
+		return count_before(v, false);
+	}
+
+	/**
+		@brief Operatore di uguaglianza tra due OrderedMultiSet
+
+		@description
+		Poiché gli elementi sono ordinati, il confronto scorre in parallelo i valori
+		distinti dei due OrderedMultiSet, con costo lineare.
+
+		@param other OrderedMultiSet con cui confrontare il primo
+
+		@return True se i due OrderedMultiSet sono uguali, false altrimenti
+	*/
+	bool operator==(const OrderedMultiSet &other) const {
+		if(_size != other._size || _distinct != other._distinct)
+			return false;
+		const_iterator i = begin(), j = other.begin(), ie = end();
+		while(i != ie) {
+			if(!equivalent(*i, *j) || i.ptr->counts[i.pos] != j.ptr->counts[j.pos])
+				return false;
+			i.next_distinct();
+			j.next_distinct();
+		}
+		return true;
+	}
+
+	// Operazioni insiemistiche
+
+	/**
+		@brief Somma di OrderedMultiSet
+
+		@description
+		Le occorrenze di ogni elemento di other sono aggiunte a quelle dell'OrderedMultiSet
+		corrente, con costo lineare nel numero di valori distinti (vedi merge()).
+
+		@param other OrderedMultiSet da sommare
+
+		@return Riferimento all'OrderedMultiSet corrente
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (l'OrderedMultiSet resta invariato)
+	*/
+	OrderedMultiSet& operator+=(const OrderedMultiSet &other) {
+		merge(other, merge_sum);
+		return *this;
+	}
+
+	/**
+		@brief Unione di OrderedMultiSet
+
+		@description
+		Il numero di occorrenze di ogni elemento diventa il massimo tra quelli nei due
+		OrderedMultiSet, con costo lineare nel numero di valori distinti.
+
+		@param other OrderedMultiSet da unire
+
+		@return Riferimento all'OrderedMultiSet corrente
+
+		@throw Eccezione di allocazione di memoria (l'OrderedMultiSet resta invariato)
+	*/
+	OrderedMultiSet& operator|=(const OrderedMultiSet &other) {
+		if(this != &other)
+			merge(other, merge_union);
+		return *this;
+	}
+
+	/**
+		@brief Intersezione di OrderedMultiSet
+
+		@description
+		Il numero di occorrenze di ogni elemento diventa il minimo tra quelli nei due
+		OrderedMultiSet, con costo lineare nel numero di valori distinti.
+
+		@param other OrderedMultiSet da intersecare
+
+		@return Riferimento all'OrderedMultiSet corrente
+
+		@throw Eccezione di allocazione di memoria (l'OrderedMultiSet resta invariato)
+	*/
+	OrderedMultiSet& operator&=(const OrderedMultiSet &other) {
+		if(this != &other)
+			merge(other, merge_intersection);
+		return *this;
+	}
+
+	/**
+		@brief Differenza troncata di OrderedMultiSet
+
+		@description
+		Il numero di occorrenze di ogni elemento è diminuito del numero di occorrenze in other,
+		senza scendere sotto 0, con costo lineare nel numero di valori distinti.
+
+		@param other OrderedMultiSet da sottrarre
+
+		@return Riferimento all'OrderedMultiSet corrente
+
+		@throw Eccezione di allocazione di memoria (l'OrderedMultiSet resta invariato)
+	*/
+	OrderedMultiSet& operator-=(const OrderedMultiSet &other) {
+		if(this == &other)
+			clear();
+		else
+			merge(other, merge_difference);
+		return *this;
+	}
+
+	/**
+		@brief Inclusione tra OrderedMultiSet
+
+		@description
+		I valori distinti dei due OrderedMultiSet sono scorsi in parallelo, con costo lineare.
+
+		@param other OrderedMultiSet di cui verificare l'inclusione in quello corrente
+
+		@return True se ogni elemento di other compare nell'OrderedMultiSet corrente almeno
+		altrettante volte, false altrimenti
+	*/
+	bool includes(const OrderedMultiSet &other) const {
+		if(other._size > _size || other._distinct > _distinct)
+			return false;
+		const_iterator i = begin(), j = other.begin(), ie = end(), je = other.end();
+		while(j != je) {
+			while(i != ie && _less(*i, *j))
+				i.next_distinct();
+			if(i == ie || _less(*j, *i) || i.ptr->counts[i.pos] < j.ptr->counts[j.pos])
+				return false;
+			i.next_distinct();
+			j.next_distinct();
+		}
+		return true;
+	}
+
+	// Supporto agli iteratori per un OrderedMultiSet
+
+	/**
+		@brief Iteratore in lettura (costante) di tipo forward per un OrderedMultiSet
+
+		@description
+		Gli elementi sono visitati in ordine crescente; ogni valore è ripetuto
+		tante volte quante sono le sue occorrenze.
+	*/
+	class const_iterator {
+
+	public:
+
+		// Traits dell'iteratore costante
+
+		typedef std::forward_iterator_tag iterator_category; ///< Categoria dell'iteratore
+		typedef const T value_type; ///< Tipo dei dati puntati dall'iteratore costante
+		typedef ptrdiff_t difference_type; ///< Tipo per rappresentare la differenza tra due puntatori
+		typedef const T* pointer; ///< Tipo di puntatore ai dati puntati dall'iteratore costante
+		typedef const T& reference; ///< Tipo di reference ai dati puntati dall'iteratore costante
+
+		// Metodi fondamentali dell'iteratore costante
+
+		/**
+			@brief Costruttore di default dell'iteratore costante
+		*/
+		const_iterator() : ptr(nullptr), pos(0), t(1) {}
+
+		/**
+			@brief Copy constructor dell'iteratore costante
+
+			@param other iteratore costante da copiare
+		*/
+		const_iterator(const const_iterator &other) : ptr(other.ptr), pos(other.pos), t(other.t) {}
+
+		/**
+			@brief Operatore di assegnamento dell'iteratore costante
+
+			@param other iteratore costante "sorgente" da copiare
+
+			@return riferimento all'iteratore costante corrente
+		*/
+		const_iterator& operator=(const const_iterator &other) {
+			ptr = other.ptr;
+			pos = other.pos;
+			t = other.t;
+			return *this;
+		}
+
+		/**
+			@brief Distruttore per un iteratore costante
+		*/
+		~const_iterator() {}
+
+		// Altri metodi pubblici dell'iteratore costante
+
+		/**
+			@brief Operatore di deferenziamento
+
+			@return valore costante puntato dall'iteratore costante
+		*/
+		reference operator*() const {
+			return ptr->keys[pos];
+		}
+
+		/**
+			@brief Operatore di accesso tramite puntatore
+
+			@return puntatore al valore costante puntato dall'iteratore costante
+		*/
+		pointer operator->() const {
+			return &(ptr->keys[pos]);
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@return Copia dell'iteratore costante corrente prima dell'incremento
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è già alla fine
+		*/
+		const_iterator operator++(int) {
+			const_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@description
+			L'iteratore passa al valore successivo solo quando le occorrenze del valore
+			corrente sono state consumate.
+
+			@return Riferimento all'iteratore costante corrente
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore costante è già alla fine
+		*/
+		const_iterator& operator++() {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
+			if(ptr == nullptr)
+				throw multiset_iterator_out_of_bounds();
+#endif
+			if(t == ptr->counts[pos])
+				next_distinct();
+			else
+				t++;
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se i due iteratori costanti puntano allo stesso valore, false altrimenti
+		*/
+		bool operator==(const const_iterator &other) const {
+			return (ptr == other.ptr && pos == other.pos);
+		}
+
+		/**
+			@brief Operatore di disuguaglianza
+
+			@param other iteratore costante con cui confrontare quello corrente
+
+			@return true se i due iteratori costanti puntano a valori diversi, false altrimenti
+		*/
+		bool operator!=(const const_iterator &other) const {
+			return !(*this == other);
+		}
+
+	private:
+
+		// Dati privati dell'iteratore costante
+
+		const bnode *ptr; ///< Puntatore al nodo del B-tree
+		unsigned int pos; ///< Posizione del valore nel nodo
+		std::size_t t; ///< Occorrenza corrente del valore, usata negli operatori di incremento
+
+		friend class OrderedMultiSet; // La classe container che utilizza l'iteratore costante dev'essere friend della classe iteratore
+
+		/**
+			@brief Costruttore privato
+
+			@param n puntatore al nodo del B-tree
+			@param p posizione del valore nel nodo
+		*/
+		const_iterator(const bnode *n, unsigned int p) : ptr(n), pos(p), t(1) {}
+
+		/**
+			@brief Passaggio al valore distinto successivo in ordine crescente
+
+			@description
+			Da un nodo interno si scende al valore minimo del sottoalbero destro; da una
+			foglia si risale finché il nodo non è l'ultimo figlio del padre.
+		*/
+		void next_distinct() {
+			t = 1;
+			if(!ptr->leaf) {
+				ptr = ptr->children[pos + 1];
+				while(!ptr->leaf)
+					ptr = ptr->children[0];
+				pos = 0;
+				return;
+			}
+			if(pos + 1 < ptr->nkeys) {
+				pos++;
+				return;
+			}
+			while(ptr->parent != nullptr && ptr->index == ptr->parent->nkeys)
+				ptr = ptr->parent;
+			pos = ptr->index;
+			ptr = ptr->parent;
+			if(ptr == nullptr)
+				pos = 0;
+		}
+
+	}; // class const_iterator
+
+	// Funzioni membro per l'utilizzo di iteratori costanti
+
+	/**
+		@brief Iteratore costante che punta al valore minimo
+
+		@return iteratore costante che punta all'inizio dell'OrderedMultiSet
+	*/
+	const_iterator begin() const {
+		const bnode *x = _root;
+		if(x == nullptr)
+			return end();
+		while(!x->leaf)
+			x = x->children[0];
+		return const_iterator(x, 0);
+	}
+
+	/**
+		@brief Iteratore costante che punta alla fine dell'OrderedMultiSet
+
+		@return iteratore costante che punta alla fine dell'OrderedMultiSet
+	*/
+	const_iterator end() const {
+		return const_iterator(nullptr, 0);
+	}
+
+	/**
+		@brief Primo elemento non minore di un valore
+
+		@param v valore di confronto
+
+		@return iteratore costante al primo elemento non minore di v, end() se non esiste
+	*/
+	const_iterator lower_bound(const T &v) const {
+		const_iterator res = end();
+		const bnode *x = _root;
+		while(x != nullptr) {
+			unsigned int i = lower_index(x, v);
+			if(i < x->nkeys) {
+				res = const_iterator(x, i);
+				if(!_less(v, x->keys[i]))
+					break;
+			}
+			x = x->leaf ? nullptr : x->children[i];
+		}
+		return res;
+	}
+
+	/**
+		@brief Primo elemento maggiore di un valore
+
+		@param v valore di confronto
+
+		@return iteratore costante al primo elemento maggiore di v, end() se non esiste
+	*/
+	const_iterator upper_bound(const T &v) const {
+		const_iterator res = end();
+		const bnode *x = _root;
+		while(x != nullptr) {
+			unsigned int i = upper_index(x, v);
+			if(i < x->nkeys)
+				res = const_iterator(x, i);
+			x = x->leaf ? nullptr : x->children[i];
+		}
+		return res;
+	}
+
+}; // class OrderedMultiSet
+
+// Funzioni globali
+
+/**
+	@brief Somma di due OrderedMultiSet
+
+	@param a primo OrderedMultiSet
+	@param b secondo OrderedMultiSet
+
+	@return nuovo OrderedMultiSet, somma di a e b
+
+	@throw Eccezione di allocazione di memoria o custom di numero di occorrenze fuori dai limiti
+*/
+template <typename T, typename Less>
+OrderedMultiSet<T,Less> operator+(const OrderedMultiSet<T,Less> &a, const OrderedMultiSet<T,Less> &b) {
+	OrderedMultiSet<T,Less> res(a);
+	res += b;
+	return res;
+}
+
+/**
+	@brief Unione di due OrderedMultiSet
+
+	@param a primo OrderedMultiSet
+	@param b secondo OrderedMultiSet
+
+	@return nuovo OrderedMultiSet, unione di a e b (massimo dei numeri di occorrenze)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename Less>
+OrderedMultiSet<T,Less> operator|(const OrderedMultiSet<T,Less> &a, const OrderedMultiSet<T,Less> &b) {
+	OrderedMultiSet<T,Less> res(a);
+	res |= b;
+	return res;
+}
+
+/**
+	@brief Intersezione di due OrderedMultiSet
+
+	@param a primo OrderedMultiSet
+	@param b secondo OrderedMultiSet
+
+	@return nuovo OrderedMultiSet, intersezione di a e b (minimo dei numeri di occorrenze)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename Less>
+OrderedMultiSet<T,Less> operator&(const OrderedMultiSet<T,Less> &a, const OrderedMultiSet<T,Less> &b) {
+	OrderedMultiSet<T,Less> res(a);
+	res &= b;
+	return res;
+}
+
+/**
+	@brief Differenza troncata di due OrderedMultiSet
+
+	@param a primo OrderedMultiSet
+	@param b secondo OrderedMultiSet
+
+	@return nuovo OrderedMultiSet, con le occorrenze di a diminuite di quelle di b (senza scendere sotto 0)
+
+	@throw Eccezione di allocazione di memoria
+*/
+template <typename T, typename Less>
+OrderedMultiSet<T,Less> operator-(const OrderedMultiSet<T,Less> &a, const OrderedMultiSet<T,Less> &b) {
+	OrderedMultiSet<T,Less> res(a);
+	res -= b;
+	return res;
+}
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per un OrderedMultiSet
+
+	@description
+	Il formato di invio su stream è lo stesso del MultiSet, con i valori in ordine crescente:
+	{<X1, OccorrenzeX1>, <X2, OccorrenzeX2>, ..., <Xn, OccorrenzeXn>}.
+
+	@tparam T tipo del valore degli elementi dell'OrderedMultiSet da stampare
+	@tparam Less funtore di confronto tra elementi
+
+	@param os oggetto di stream output
+	@param ms OrderedMultiSet da stampare
+
+	@return riferimento allo stream di output
+*/
+template <typename T, typename Less>
+std::ostream &operator<<(std::ostream &os, const OrderedMultiSet<T,Less> &ms) {
+	typename OrderedMultiSet<T,Less>::const_iterator i = ms.begin(), ie = ms.end();
+
+	os << "{";
+	while(i != ie) {
+		const T *curr_val = &(*i); // Le occorrenze di un valore sono tutte lo stesso oggetto nel B-tree
+		typename OrderedMultiSet<T,Less>::size_type count = 0;
+		if(i != ms.begin())
+			os << ", ";
+		while(i != ie && &(*i) == curr_val) {
+			count++;
+			++i;
+		}
+		os << "<" << *curr_val << ", " << count << ">";
+	}
+	os << "}";
+
+	return os;
+}
+
+#endif
+
+// Fine ordered_multiset.h
@@ -0,0 +1,594 @@
+/**
+	@headerfile snapshot_multiset.h
+
+	@brief Dichiarazione e definizione di una classe templata SnapshotMultiSet, con lettori
+	concorrenti che non si bloccano mai ed uno scrittore che pubblica versioni successive.
+*/
+
+// Guardie
+
+#ifndef SNAPSHOT_MULTISET_H
+#define SNAPSHOT_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <algorithm> // std::sort, std::min
+#include <atomic> // std::atomic
+#include <cstddef> // std::size_t
+#include <functional> // std::hash, std::equal_to
+#include <limits> // std::numeric_limits
+#include <memory> // std::shared_ptr, std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <thread> // std::this_thread::get_id
+#include <utility> // std::pair
+#include <vector> // std::vector
+#include "multiset_exceptions.h" // multiset_value_not_found, multiset_count_overflow
+#include "multiset.h" // MultiSet, multiset_mix, multiset_equal
+
+/**
+	@brief MultiSet a versioni, per molti lettori concorrenti ed un solo scrittore
+
+	@description
+	Il contenuto pubblicato è una versione immutabile: un array di puntatori a bucket, ciascuno
+	un vettore di (valore, hash, numero di occorrenze). Un lettore ottiene con read() una vista
+	della versione corrente, su cui interroga nocc() senza alcun lock; la vista resta valida
+	(e la versione invariata) finché la vista esiste.
+	Lo scrittore accumula le modifiche con add() e remove(), che non sono visibili ai lettori,
+	e le rende visibili tutte insieme con publish(): la nuova versione condivide con la
+	precedente i bucket non modificati, mentre quelli modificati sono copiati (copy-on-write).
+	La versione corrente è sostituita con un'unica scrittura atomica, quindi un lettore vede
+	sempre tutte le modifiche di un gruppo o nessuna.
+	Le versioni sostituite sono liberate con una reclamazione per epoche: ogni vista occupa una
+	delle reader_slots() posizioni dei lettori, annotandovi l'epoca in cui è stata creata, e una
+	versione è liberata solo quando nessuna vista attiva può ancora riferirla. Ogni posizione
+	occupa una linea di cache propria, e ciascun thread inizia la ricerca di una posizione libera
+	da un indice ottenuto dal proprio identificatore: lettori diversi non scrivono quindi sulle
+	stesse linee di cache. Se tutte le posizioni sono occupate, la vista è contata in una
+	posizione di riserva condivisa; finché esistono viste di riserva nessuna versione è liberata.
+
+	@tparam T tipo degli elementi dello SnapshotMultiSet
+	@tparam E funtore di uguaglianza tra due elementi
+	@tparam H funtore di hash degli elementi
+*/
+template <typename T, typename E = std::equal_to<T>, typename H = std::hash<T>>
+class SnapshotMultiSet {
+
+public:
+
+	typedef std::size_t size_type; ///< Tipo dei numeri di occorrenze e delle dimensioni
+
+private:
+
+	// Sezione privata della classe
+
+	/**
+		Elemento di un bucket
+	*/
+	struct entry {
+		T value; ///< Valore dell'elemento
+		std::size_t hash; ///< Hash rimescolato del valore
+		std::size_t count; ///< Numero di occorrenze del valore
+
+		/**
+			@brief Costruttore per un elemento di un bucket
+
+			@param v valore dell'elemento
+			@param h hash rimescolato del valore
+			@param c numero di occorrenze
+		*/
+		entry(const T &v, std::size_t h, std::size_t c) : value(v), hash(h), count(c) {}
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct entry
+
+	typedef std::vector<entry> bucket; ///< Bucket di una versione (immutabile una volta pubblicato)
+
+	/**
+		Versione pubblicata del contenuto
+	*/
+	struct version {
+		std::vector<std::shared_ptr<const bucket>> buckets; ///< Bucket (nullptr se vuoti), in numero potenza di 2
+		std::size_t size; ///< Numero totale di elementi
+		std::size_t distinct; ///< Numero di elementi distinti
+		std::size_t number; ///< Numero progressivo della versione
+
+		/**
+			@brief Costruttore per una versione
+
+			@param nb numero di bucket
+			@param s numero totale di elementi
+			@param d numero di elementi distinti
+			@param n numero progressivo
+		*/
+		version(std::size_t nb, std::size_t s, std::size_t d, std::size_t n) : buckets(nb), size(s), distinct(d), number(n) {}
+
+		/**
+			@brief Numero di occorrenze di un valore nella versione
+
+			@param v valore da cercare
+			@param h hash rimescolato di v
+			@param eql funtore di uguaglianza
+
+			@return numero di occorrenze di v, 0 se non è presente
+		*/
+		std::size_t nocc(const T &v, std::size_t h, const E &eql) const {
+			const bucket *b = buckets[h & (buckets.size() - 1)].get();
+			if(b == nullptr)
+				return 0;
+			for(std::size_t i = 0; i < b->size(); ++i)
+				if((*b)[i].hash == h && multiset_equal(eql, (*b)[i].value, v))
+					return (*b)[i].count;
+			return 0;
+		}
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct version
+
+	typedef MultiSet<T,E,H> pending_type; ///< Tipo delle modifiche non ancora pubblicate
+
+	/**
+		Modifica di un valore, usata da publish()
+	*/
+	struct change {
+		const T *value; ///< Valore modificato
+		std::size_t hash; ///< Hash rimescolato del valore
+		std::size_t count; ///< Occorrenze aggiunte o rimosse
+		bool added; ///< True per un inserimento, false per una rimozione
+	};
+
+	/**
+		Posizione dei lettori, su una linea di cache propria
+	*/
+	struct reader_slot {
+		std::atomic<std::size_t> value; ///< Epoca della vista (0 se libera); per la posizione di riserva, numero di viste
+		char pad[64]; ///< Separa posizioni diverse su linee di cache diverse
+
+		// L'implementazione dei restanti metodi standard è lasciata al compilatore
+
+	}; // struct reader_slot
+
+	// Costanti private
+
+	static const std::size_t min_buckets = 16; ///< Numero di bucket della prima versione
+
+	// Dati membro privati
+
+	std::atomic<const version*> _current; ///< Versione corrente
+	std::atomic<std::size_t> _epoch; ///< Epoca corrente (incrementata ad ogni pubblicazione, parte da 1)
+	std::unique_ptr<reader_slot[]> _slots; ///< Posizioni dei lettori
+	std::size_t _nslots; ///< Numero di posizioni dei lettori
+	std::vector<std::pair<const version*, std::size_t>> _retired; ///< Versioni sostituite, con l'epoca della sostituzione
+	pending_type _added; ///< Occorrenze aggiunte dopo l'ultima pubblicazione
+	pending_type _removed; ///< Occorrenze rimosse dopo l'ultima pubblicazione
+	mutable std::mutex _writer; ///< Serializza le operazioni di scrittura
+	mutable reader_slot _overflow; ///< Posizione di riserva: numero di viste senza una posizione propria (dopo i dati dello scrittore, lontana da quelli letti dai lettori)
+
+	E _eql; ///< Istanza del funtore di uguaglianza
+	H _hash; ///< Istanza del funtore di hash
+
+	/**
+		@brief Calcolo dell'hash di un valore
+
+		@param v valore di cui calcolare l'hash
+
+		@return hash rimescolato del valore
+	*/
+	std::size_t hash_of(const T &v) const {
+		return multiset_mix(_hash(v));
+	}
+
+	/**
+		@brief Numero di occorrenze di un valore, comprese le modifiche non pubblicate
+
+		@pre Il mutex dello scrittore è acquisito
+
+		@param v valore da cercare
+
+		@return numero di occorrenze che v avrà dopo la prossima pubblicazione
+	*/
+	std::size_t pending_nocc(const T &v) const {
+		return _current.load()->nocc(v, hash_of(v), _eql) + _added.nocc(v) - _removed.nocc(v);
+	}
+
+	/**
+		@brief Liberazione delle versioni non più raggiungibili dai lettori
+
+		@description
+		Una versione sostituita all'epoca e può essere riferita solo da viste create ad
+		un'epoca minore o uguale ad e: se tutte le viste attive sono più recenti, viene liberata.
+		L'epoca delle viste di riserva non è nota: se ve n'è almeno una, nessuna versione è liberata
+		(lo sarà ad una pubblicazione successiva).
+
+		@pre Il mutex dello scrittore è acquisito
+	*/
+	void reclaim() {
+		if(_overflow.value.load() != 0)
+			return;
+		std::size_t oldest = std::numeric_limits<std::size_t>::max();
+		for(std::size_t i = 0; i < _nslots; ++i) {
+			std::size_t e = _slots[i].value.load();
+			if(e != 0 && e < oldest)
+				oldest = e;
+		}
+		std::size_t kept = 0;
+		for(std::size_t i = 0; i < _retired.size(); ++i) {
+			if(_retired[i].second < oldest)
+				delete _retired[i].first;
+			else
+				_retired[kept++] = _retired[i];
+		}
+		_retired.resize(kept);
+	}
+
+	/**
+		@brief Ridistribuzione degli elementi di una versione in un nuovo numero di bucket
+
+		@param from versione da ridistribuire
+		@param to nuova versione, con i bucket vuoti
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	static void rehash(const version &from, version &to) {
+		std::vector<std::shared_ptr<bucket>> tmp(to.buckets.size());
+		std::size_t mask = to.buckets.size() - 1;
+		for(std::size_t i = 0; i < from.buckets.size(); ++i) {
+			if(!from.buckets[i])
+				continue;
+			const bucket &b = *from.buckets[i];
+			for(std::size_t j = 0; j < b.size(); ++j) {
+				std::shared_ptr<bucket> &dst = tmp[b[j].hash & mask];
+				if(!dst)
+					dst = std::make_shared<bucket>();
+				dst->push_back(b[j]);
+			}
+		}
+		for(std::size_t i = 0; i < tmp.size(); ++i)
+			to.buckets[i] = tmp[i];
+	}
+
+	/**
+		@brief Ordinamento delle modifiche per hash, così da raggrupparle per bucket
+
+		@param a prima modifica
+		@param b seconda modifica
+
+		@return true se a ha un hash minore di b
+	*/
+	static bool by_hash(const change &a, const change &b) {
+		return a.hash < b.hash;
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	/**
+		@brief Vista di una versione dello SnapshotMultiSet
+
+		@description
+		La vista occupa una posizione dei lettori (o è contata nella posizione di riserva) dalla
+		creazione alla distruzione, durante le quali la versione vista non viene liberata. Le interrogazioni non acquisiscono alcun lock.
+		La vista non deve sopravvivere allo SnapshotMultiSet; può essere spostata ma non copiata.
+	*/
+	class view {
+
+		const SnapshotMultiSet *_owner; ///< SnapshotMultiSet di provenienza
+		reader_slot *_slot; ///< Posizione occupata, nullptr dopo uno spostamento
+		const version *_version; ///< Versione vista
+
+		friend class SnapshotMultiSet;
+
+		/**
+			@brief Costruttore privato, richiamato da read()
+
+			@param owner SnapshotMultiSet di provenienza
+			@param slot posizione occupata (o posizione di riserva)
+			@param v versione vista
+		*/
+		view(const SnapshotMultiSet *owner, reader_slot *slot, const version *v) : _owner(owner),
+			_slot(slot), _version(v) {}
+
+	public:
+
+		view(const view &other) = delete; // Una posizione dei lettori non può essere condivisa
+		view& operator=(const view &other) = delete; // Non assegnabile
+
+		/**
+			@brief Move constructor
+
+			@param other vista da spostare, che non occupa più alcuna posizione
+		*/
+		view(view &&other) noexcept : _owner(other._owner), _slot(other._slot), _version(other._version) {
+			other._slot = nullptr;
+		}
+
+		/**
+			@brief Distruttore, che libera la posizione occupata
+		*/
+		~view() {
+			if(_slot == &_owner->_overflow)
+				_slot->value.fetch_sub(1);
+			else if(_slot != nullptr)
+				_slot->value.store(0);
+		}
+
+		/**
+			@brief Numero di occorrenze di un elemento nella versione vista
+
+			@param v valore di cui sapere il numero di occorrenze
+
+			@return numero di occorrenze di v, 0 se non è presente
+		*/
+		size_type nocc(const T &v) const {
+			return _version->nocc(v, _owner->hash_of(v), _owner->_eql);
+		}
+
+		/**
+			@brief Ricerca di un elemento nella versione vista
+
+			@param v elemento da cercare
+
+			@return true se l'elemento è presente, false altrimenti
+		*/
+		bool contains(const T &v) const {
+			return nocc(v) > 0;
+		}
+
+		/**
+			@brief Numero di elementi della versione vista
+
+			@return numero totale di elementi
+		*/
+		size_type size() const {
+			return _version->size;
+		}
+
+		/**
+			@brief Numero di elementi distinti della versione vista
+
+			@return numero di elementi distinti
+		*/
+		size_type distinct_size() const {
+			return _version->distinct;
+		}
+
+		/**
+			@brief Numero progressivo della versione vista
+
+			@return 0 per la versione iniziale, incrementato ad ogni pubblicazione
+		*/
+		size_type number() const {
+			return _version->number;
+		}
+
+	}; // class view
+
+	/**
+		@brief Costruttore per SnapshotMultiSet
+
+		@param reader_slots numero massimo di viste contemporanee (almeno 1)
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	explicit SnapshotMultiSet(size_type reader_slots = 64) : _current(nullptr), _epoch(1),
+		_nslots(reader_slots == 0 ? 1 : reader_slots) {
+		_slots.reset(new reader_slot[_nslots]);
+		for(std::size_t i = 0; i < _nslots; ++i)
+			_slots[i].value.store(0);
+		_overflow.value.store(0);
+		_current.store(new version(min_buckets, 0, 0, 0));
+	}
+
+	SnapshotMultiSet(const SnapshotMultiSet &other) = delete; // Non copiabile
+	SnapshotMultiSet& operator=(const SnapshotMultiSet &other) = delete; // Non assegnabile
+
+	/**
+		@brief Distruttore
+
+		@pre Nessuna vista è ancora attiva
+
+		@post La versione corrente e quelle sostituite sono liberate
+	*/
+	~SnapshotMultiSet() {
+		for(std::size_t i = 0; i < _retired.size(); ++i)
+			delete _retired[i].first;
+		delete _current.load();
+	}
+
+	/**
+		@brief Numero di posizioni dei lettori
+
+		@return numero di viste contemporanee con una posizione propria (le altre usano la
+		posizione di riserva)
+	*/
+	size_type reader_slots() const {
+		return _nslots;
+	}
+
+	/**
+		@brief Vista della versione corrente
+
+		@description
+		La vista occupa una posizione libera, annotandovi l'epoca corrente con un'unica
+		operazione atomica, poi legge la versione corrente. La ricerca parte da una posizione
+		scelta dall'identificatore del thread e salta senza scritture le posizioni occupate; se
+		sono tutte occupate, la vista incrementa il contatore della posizione di riserva. Nessun
+		lock è acquisito: un lettore non attende mai lo scrittore né gli altri lettori.
+
+		@return vista della versione corrente
+	*/
+	view read() const {
+		std::size_t e = _epoch.load();
+		std::size_t start = multiset_mix(std::hash<std::thread::id>()(std::this_thread::get_id())) % _nslots;
+		for(std::size_t i = start, n = 0; n < _nslots; ++n, i = (i + 1 == _nslots) ? 0 : i + 1) {
+			std::size_t expected = 0;
+			if(_slots[i].value.load(std::memory_order_relaxed) == 0 && _slots[i].value.compare_exchange_strong(expected, e))
+				return view(this, &_slots[i], _current.load());
+		}
+		_overflow.value.fetch_add(1);
+		return view(this, &_overflow, _current.load());
+	}
+
+	/**
+		@brief Numero di occorrenze di un elemento nella versione corrente
+
+		@param v valore di cui sapere il numero di occorrenze
+
+		@return numero di occorrenze di v, 0 se non è presente
+	*/
+	size_type nocc(const T &v) const {
+		return read().nocc(v);
+	}
+
+	/**
+		@brief Ricerca di un elemento nella versione corrente
+
+		@param v elemento da cercare
+
+		@return true se l'elemento è presente, false altrimenti
+	*/
+	bool contains(const T &v) const {
+		return nocc(v) > 0;
+	}
+
+	/**
+		@brief Numero di elementi della versione corrente
+
+		@return numero totale di elementi
+	*/
+	size_type size() const {
+		return read().size();
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di un elemento nel prossimo gruppo di modifiche
+
+		@description
+		L'inserimento diventa visibile ai lettori solo alla successiva publish().
+
+		@param v valore da inserire
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(const T &v, size_type k = 1) {
+		std::lock_guard<std::mutex> guard(_writer);
+		if(k > std::numeric_limits<std::size_t>::max() - (_current.load()->size + _added.size()))
+			throw multiset_count_overflow();
+		size_type cancel = std::min(k, _removed.nocc(v));
+		if(k > cancel)
+			_added.add(v, k - cancel);
+		_removed.remove(v, cancel);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di un elemento nel prossimo gruppo di modifiche
+
+		@description
+		La rimozione diventa visibile ai lettori solo alla successiva publish(). Il numero di
+		occorrenze disponibili tiene conto delle modifiche non ancora pubblicate.
+
+		@param v valore da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T
+	*/
+	void remove(const T &v, size_type k = 1) {
+		std::lock_guard<std::mutex> guard(_writer);
+		if(pending_nocc(v) < k)
+			throw multiset_value_not_found();
+		size_type cancel = std::min(k, _added.nocc(v));
+		if(k > cancel)
+			_removed.add(v, k - cancel);
+		_added.remove(v, cancel);
+	}
+
+	/**
+		@brief Pubblicazione delle modifiche accumulate
+
+		@description
+		La nuova versione copia l'array dei puntatori ai bucket della precedente e i soli bucket
+		modificati; se il numero di elementi distinti supera quello dei bucket, i bucket sono
+		raddoppiati e tutti ridistribuiti. La versione è poi resa corrente con un'unica scrittura
+		atomica e la precedente è affidata alla reclamazione per epoche.
+
+		@post I lettori che chiamano read() da ora in poi vedono tutte le modifiche accumulate
+
+		@throw Eccezione di allocazione di memoria o lanciata dal costruttore di copia di T (la
+		versione corrente e le modifiche accumulate restano invariate)
+	*/
+	void publish() {
+		std::lock_guard<std::mutex> guard(_writer);
+		if(_added.size() == 0 && _removed.size() == 0)
+			return;
+		const version *old = _current.load();
+
+		std::vector<change> changes;
+		changes.reserve(_added.distinct_size() + _removed.distinct_size());
+		typename pending_type::distinct_range r = _added.distinct();
+		for(typename pending_type::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			change c = {&i.value(), hash_of(i.value()), i.count(), true};
+			changes.push_back(c);
+		}
+		r = _removed.distinct();
+		for(typename pending_type::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+			change c = {&i.value(), hash_of(i.value()), i.count(), false};
+			changes.push_back(c);
+		}
+
+		std::size_t nb = old->buckets.size();
+		while(old->distinct + _added.distinct_size() > nb)
+			nb *= 2;
+		std::unique_ptr<version> next(new version(nb, old->size + _added.size() - _removed.size(), old->distinct, old->number + 1));
+		if(nb == old->buckets.size())
+			next->buckets = old->buckets;
+		else
+			rehash(*old, *next);
+
+		std::sort(changes.begin(), changes.end(), by_hash);
+		std::size_t mask = nb - 1;
+		for(std::size_t i = 0; i < changes.size(); ) {
+			std::size_t idx = changes[i].hash & mask;
+			std::shared_ptr<bucket> b = next->buckets[idx] ? std::make_shared<bucket>(*next->buckets[idx]) : std::make_shared<bucket>();
+			for(; i < changes.size() && (changes[i].hash & mask) == idx; ++i) {
+				const change &c = changes[i];
+				std::size_t j = 0;
+				while(j < b->size() && !((*b)[j].hash == c.hash && multiset_equal(_eql, (*b)[j].value, *c.value)))
+					++j;
+				if(c.added) {
+					if(j == b->size()) {
+						b->push_back(entry(*c.value, c.hash, c.count));
+						next->distinct++;
+					}
+					else
+						(*b)[j].count += c.count;
+				}
+				else if(((*b)[j].count -= c.count) == 0) {
+					(*b)[j] = b->back();
+					b->pop_back();
+					next->distinct--;
+				}
+			}
+			if(b->empty())
+				next->buckets[idx].reset();
+			else
+				next->buckets[idx] = b;
+		}
+		_retired.reserve(_retired.size() + 1);
+
+		_current.store(next.release());
+		_retired.push_back(std::make_pair(old, _epoch.fetch_add(1)));
+		_added.clear();
+		_removed.clear();
+		reclaim();
+	}
+
+}; // class SnapshotMultiSet
+
+#endif
+
+// Fine snapshot_multiset.h
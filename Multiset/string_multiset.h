@@ -0,0 +1,889 @@
+/**
+	@headerfile string_multiset.h
+
+	@brief Dichiarazione e definizione della classe StringMultiSet, MultiSet di stringhe
+	con chiavi internate in memoria contigua, con ridefinizione dell'operatore di stream <<.
+
+	@description
+	Come per MultiSet, definendo la macro MULTISET_NO_ITERATOR_CHECKS prima dell'inclusione
+	l'incremento di un iteratore alla fine non lancia multiset_iterator_out_of_bounds.
+*/
+
+// Guardie
+
+#ifndef STRING_MULTISET_H
+#define STRING_MULTISET_H
+
+// Direttive pre-compilatore
+
+#include <ostream> // std::ostream
+#include <algorithm> // std::swap, std::max
+#include <cstddef> // std::ptrdiff_t, std::size_t
+#include <cstdint> // std::uint32_t
+#include <cstring> // std::memcmp, std::memcpy, std::strlen
+#include <iterator> // std::forward_iterator_tag
+#include <limits> // std::numeric_limits
+#include <memory> // std::unique_ptr
+#include <new> // placement new
+#include <string> // std::string
+#include <utility> // std::pair
+#include <vector> // std::vector
+#if __cplusplus >= 201703L
+#include <string_view> // std::string_view
+#endif
+#include "multiset_exceptions.h" // multiset_value_not_found, multiset_count_overflow, multiset_iterator_out_of_bounds
+#include "multiset.h" // multiset_mix
+
+/**
+	@brief Riferimento non proprietario ad una sequenza di caratteri
+
+	@description
+	Equivalente minimo di std::string_view (non disponibile prima di C++17), in cui
+	è convertibile da C++17. È costruito implicitamente da una stringa C o da una
+	std::string, che devono restare valide finché il riferimento è usato. La sequenza
+	può contenere caratteri nulli.
+*/
+struct multiset_string_ref {
+	const char *data; ///< Primo carattere della sequenza
+	std::size_t size; ///< Numero di caratteri
+
+	/**
+		@brief Costruttore da puntatore e lunghezza
+
+		@param d primo carattere
+		@param n numero di caratteri
+	*/
+	multiset_string_ref(const char *d, std::size_t n) : data(d), size(n) {}
+
+	/**
+		@brief Costruttore da stringa C (terminata da un carattere nullo)
+
+		@param s stringa C
+	*/
+	multiset_string_ref(const char *s) : data(s), size(std::strlen(s)) {}
+
+	/**
+		@brief Costruttore da std::string
+
+		@param s stringa
+	*/
+	multiset_string_ref(const std::string &s) : data(s.data()), size(s.size()) {}
+
+#if __cplusplus >= 201703L
+	/**
+		@brief Costruttore da std::string_view
+
+		@param s vista sulla stringa
+	*/
+	multiset_string_ref(std::string_view s) : data(s.data()), size(s.size()) {}
+
+	/**
+		@brief Conversione a std::string_view
+
+		@return vista sugli stessi caratteri
+	*/
+	operator std::string_view() const {
+		return std::string_view(data, size);
+	}
+#endif
+
+	/**
+		@brief Copia dei caratteri in una std::string
+
+		@return nuova stringa con gli stessi caratteri
+	*/
+	std::string str() const {
+		return std::string(data, size);
+	}
+
+	/**
+		@brief Operatore di uguaglianza tra riferimenti
+
+		@param other riferimento da confrontare
+
+		@return true se le due sequenze hanno gli stessi caratteri
+	*/
+	bool operator==(const multiset_string_ref &other) const {
+		return size == other.size && std::memcmp(data, other.data, size) == 0;
+	}
+};
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per un multiset_string_ref
+
+	@param os oggetto di stream output
+	@param s riferimento da stampare
+
+	@return riferimento allo stream di output
+*/
+inline std::ostream &operator<<(std::ostream &os, const multiset_string_ref &s) {
+	return os.write(s.data, static_cast<std::streamsize>(s.size));
+}
+
+/**
+	@brief Hash di una sequenza di caratteri, 8 byte per iterazione
+
+	@param s primo carattere
+	@param n numero di caratteri
+
+	@return hash rimescolato della sequenza
+*/
+inline std::size_t multiset_string_hash(const char *s, std::size_t n) {
+	unsigned long long h = 0x9e3779b97f4a7c15ULL ^ n;
+	for(; n >= 8; s += 8, n -= 8) {
+		unsigned long long w;
+		std::memcpy(&w, s, 8);
+		h = (h ^ w) * 0xff51afd7ed558ccdULL;
+		h ^= h >> 32;
+	}
+	unsigned long long w = 0;
+	std::memcpy(&w, s, n);
+	h = (h ^ w) * 0xc4ceb9fe1a85ec53ULL;
+	return multiset_mix(static_cast<std::size_t>(h ^ (h >> 29)));
+}
+
+/**
+	@brief MultiSet di stringhe con chiavi internate
+
+	@description
+	Variante di MultiSet<std::string> pensata per molte stringhe brevi. Ogni chiave distinta è
+	copiata una sola volta in blocchi di memoria contigua (arena), in un record che contiene
+	l'hash precalcolato, il numero di occorrenze, la lunghezza ed i caratteri, seguiti da un
+	carattere nullo: non è richiesta un'allocazione per chiave. La tabella di hash ad
+	indirizzamento aperto contiene, per ogni chiave, un riferimento di 32 bit al record (blocco
+	e posizione nel blocco) e 32 bit del suo hash: una ricerca legge il record solo se questi
+	coincidono, e confronta i caratteri solo se coincidono anche l'hash completo e la lunghezza.
+	I caratteri di una chiave non sono mai spostati: i riferimenti restituiti restano validi
+	dopo gli inserimenti e le rimozioni, fino a compact(), clear(), all'assegnamento o alla
+	distruzione. Per lo stesso motivo, una chiave che scende a 0 occorrenze resta internata
+	(e torna in uso se reinserita) finché compact() non libera la memoria delle chiavi inutilizzate.
+	Gli elementi si visitano per chiave distinta, tramite distinct(), nell'ordine di inserimento.
+*/
+class StringMultiSet {
+
+public:
+
+	typedef std::size_t size_type; ///< Tipo dei numeri di occorrenze e delle dimensioni
+
+private:
+
+	// Sezione privata della classe
+
+	/**
+		Intestazione del record di una chiave internata, seguita nell'arena dai caratteri
+	*/
+	struct record {
+		std::size_t hash; ///< Hash della chiave (vedi multiset_string_hash())
+		std::size_t count; ///< Numero di occorrenze, 0 se la chiave non è più presente
+		std::size_t size; ///< Numero di caratteri
+
+		/**
+			@brief Caratteri della chiave
+
+			@return puntatore al primo carattere, che segue l'intestazione
+		*/
+		const char* data() const {
+			return reinterpret_cast<const char*>(this + 1);
+		}
+	};
+
+	/**
+		Posizione della tabella di hash
+	*/
+	struct slot {
+		std::uint32_t handle; ///< Riferimento al record più 1, 0 se la posizione è libera
+		std::uint32_t tag; ///< Bit alti dell'hash della chiave
+	};
+
+	// Costanti private
+
+	enum : std::size_t {
+		block_size = 64 * 1024, ///< Byte di un blocco dell'arena
+		offset_bits = 13, ///< Bit del riferimento che indicano la posizione nel blocco (in unità di 8 byte)
+		max_blocks = std::size_t(1) << (32 - offset_bits), ///< Numero massimo di blocchi dell'arena
+		min_slots = 16 ///< Posizioni allocate al primo inserimento
+	};
+
+	// Dati membro privati
+
+	std::vector<std::unique_ptr<char[]>> _blocks; ///< Blocchi dell'arena
+	char *_cursor; ///< Primo byte libero del blocco corrente
+	std::size_t _left; ///< Byte liberi del blocco corrente
+	std::size_t _current; ///< Indice del blocco corrente
+	std::size_t _reserved; ///< Byte allocati per l'arena
+	std::vector<std::uint32_t> _order; ///< Riferimenti ai record, in ordine di inserimento
+	std::vector<slot> _slots; ///< Tabella di hash (0 oppure una potenza di 2 posizioni)
+	std::size_t _distinct; ///< Numero di chiavi con almeno un'occorrenza
+	std::size_t _size; ///< Numero totale di elementi
+
+	// Metodi privati
+
+	/**
+		@brief Bit dell'hash memorizzati nella tabella
+
+		@param h hash della chiave
+
+		@return bit alti dell'hash (la posizione nella tabella usa quelli bassi)
+	*/
+	static std::uint32_t tag_of(std::size_t h) {
+		unsigned long long x = h;
+		return static_cast<std::uint32_t>(x >> 32) ^ static_cast<std::uint32_t>(x >> 16);
+	}
+
+	/**
+		@brief Record a partire dal suo riferimento
+
+		@param handle riferimento (blocco e posizione nel blocco)
+
+		@return puntatore al record
+	*/
+	record* at(std::uint32_t handle) const {
+		char *b = _blocks[handle >> offset_bits].get();
+		return reinterpret_cast<record*>(b + (static_cast<std::size_t>(handle) & ((std::size_t(1) << offset_bits) - 1)) * 8);
+	}
+
+	/**
+		@brief Posizione di una chiave nella tabella
+
+		@param s chiave da cercare
+		@param h hash della chiave
+
+		@return posizione della chiave, oppure della posizione libera in cui inserirla
+		(la tabella non deve essere vuota)
+	*/
+	std::size_t probe(multiset_string_ref s, std::size_t h) const {
+		std::size_t mask = _slots.size() - 1;
+		std::uint32_t tag = tag_of(h);
+		for(std::size_t i = h & mask; ; i = (i + 1) & mask) {
+			const slot &sl = _slots[i];
+			if(sl.handle == 0)
+				return i;
+			if(sl.tag == tag) {
+				const record *r = at(sl.handle - 1);
+				if(r->hash == h && r->size == s.size && std::memcmp(r->data(), s.data, s.size) == 0)
+					return i;
+			}
+		}
+	}
+
+	/**
+		@brief Record di una chiave
+
+		@param s chiave da cercare
+		@param h hash della chiave
+
+		@return puntatore al record, nullptr se la chiave non è mai stata internata
+	*/
+	record* find(multiset_string_ref s, std::size_t h) const {
+		if(_slots.empty())
+			return nullptr;
+		const slot &sl = _slots[probe(s, h)];
+		return (sl.handle == 0) ? nullptr : at(sl.handle - 1);
+	}
+
+	/**
+		@brief Ricostruzione della tabella di hash con n posizioni
+
+		@param n nuovo numero di posizioni (una potenza di 2, maggiore del numero di chiavi)
+
+		@throw Eccezione di allocazione di memoria (la tabella resta invariata)
+	*/
+	void rehash(std::size_t n) {
+		std::vector<slot> slots(n);
+		std::size_t mask = n - 1;
+		for(std::size_t k = 0; k < _order.size(); ++k) {
+			std::size_t h = at(_order[k])->hash;
+			std::size_t i = h & mask;
+			while(slots[i].handle != 0)
+				i = (i + 1) & mask;
+			slots[i].handle = _order[k] + 1;
+			slots[i].tag = tag_of(h);
+		}
+		_slots.swap(slots);
+	}
+
+	/**
+		@brief Copia di una chiave nell'arena
+
+		@description
+		I record più lunghi di un quarto di blocco sono copiati in un blocco dedicato, così
+		che lo spazio libero del blocco corrente non vada perso.
+
+		@param s chiave da copiare
+		@param h hash della chiave
+		@param k numero di occorrenze
+
+		@return riferimento al nuovo record
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti, se l'arena ha già il numero massimo di blocchi
+	*/
+	std::uint32_t store(multiset_string_ref s, std::size_t h, std::size_t k) {
+		std::size_t n = (sizeof(record) + s.size + 1 + 7) / 8 * 8;
+		std::size_t b, offset;
+		char *p;
+		if(n > _left) {
+			if(_blocks.size() >= max_blocks)
+				throw multiset_count_overflow();
+			std::size_t bytes = (n > block_size / 4) ? n : block_size;
+			std::unique_ptr<char[]> block(new char[bytes]);
+			p = block.get();
+			_blocks.push_back(std::move(block));
+			_reserved += bytes;
+			b = _blocks.size() - 1;
+			offset = 0;
+			if(bytes == block_size) {
+				_current = b;
+				_cursor = p + n;
+				_left = bytes - n;
+			}
+		}
+		else {
+			p = _cursor;
+			b = _current;
+			offset = static_cast<std::size_t>(_cursor - _blocks[b].get());
+			_cursor += n;
+			_left -= n;
+		}
+		record *r = new (p) record;
+		r->hash = h;
+		r->count = k;
+		r->size = s.size;
+		char *d = p + sizeof(record);
+		std::memcpy(d, s.data, s.size);
+		d[s.size] = '\0';
+		return static_cast<std::uint32_t>((b << offset_bits) | (offset / 8));
+	}
+
+	/**
+		@brief Inserimento di una chiave non ancora internata
+
+		@param s chiave da inserire
+		@param h hash della chiave
+		@param k numero di occorrenze
+		@param pos posizione libera restituita da probe(), ignorata se la tabella è vuota o va ingrandita
+
+		@throw Eccezione di allocazione di memoria (lo StringMultiSet resta invariato)
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti, se l'arena è piena
+	*/
+	void insert(multiset_string_ref s, std::size_t h, std::size_t k, std::size_t pos) {
+		if((_order.size() + 1) * 4 > _slots.size() * 3) {
+			rehash(_slots.empty() ? std::size_t(min_slots) : _slots.size() * 2);
+			pos = probe(s, h);
+		}
+		if(_order.size() == _order.capacity())
+			_order.reserve(_order.size() < min_slots ? std::size_t(min_slots) : _order.size() * 2);
+		std::uint32_t handle = store(s, h, k);
+		_order.push_back(handle);
+		slot &sl = _slots[pos];
+		sl.handle = handle + 1;
+		sl.tag = tag_of(h);
+		++_distinct;
+	}
+
+public:
+
+	// Sezione pubblica della classe
+
+	// Metodi fondamentali
+
+	/**
+		@brief Costruttore di default per StringMultiSet
+	*/
+	StringMultiSet() : _cursor(nullptr), _left(0), _current(0), _reserved(0), _distinct(0), _size(0) {}
+
+	/**
+		@brief Copy constructor di StringMultiSet
+
+		@description
+		Sono copiate le sole chiavi con almeno un'occorrenza, in una nuova arena.
+
+		@param other StringMultiSet da copiare
+
+		@throw Eccezione di allocazione di memoria
+	*/
+	StringMultiSet(const StringMultiSet &other) : _cursor(nullptr), _left(0), _current(0), _reserved(0), _distinct(0), _size(0) {
+		reserve(other._distinct);
+		for(std::size_t i = 0; i < other._order.size(); ++i) {
+			const record *r = other.at(other._order[i]);
+			if(r->count > 0) {
+				multiset_string_ref key(r->data(), r->size);
+				insert(key, r->hash, r->count, probe(key, r->hash));
+			}
+		}
+		_size = other._size;
+	}
+
+	/**
+		@brief Costruttore di spostamento di StringMultiSet
+
+		@description
+		I blocchi dell'arena passano al nuovo oggetto senza spostare i caratteri: i riferimenti
+		alle chiavi restano validi. other resta vuoto. Non lancia eccezioni, quindi i contenitori
+		standard (ad esempio std::vector alla crescita) spostano gli StringMultiSet invece di
+		copiarne le arene.
+
+		@param other StringMultiSet da spostare
+	*/
+	StringMultiSet(StringMultiSet &&other) noexcept : _cursor(nullptr), _left(0), _current(0), _reserved(0), _distinct(0), _size(0) {
+		swap(other);
+	}
+
+	/**
+		@brief Operatore di assegnamento di StringMultiSet
+
+		@description
+		L'eventuale copia avviene nella costruzione del parametro, prima della chiamata: lo
+		scambio non lancia eccezioni.
+
+		@param other StringMultiSet da copiare (o spostare)
+
+		@return Riferimento allo StringMultiSet corrente
+	*/
+	StringMultiSet& operator=(StringMultiSet other) noexcept {
+		swap(other);
+		return *this;
+	}
+
+	// Il distruttore è lasciato al compilatore: i blocchi dell'arena sono rilasciati dai std::unique_ptr
+
+	/**
+		@brief Scambio del contenuto di due StringMultiSet
+
+		@param other StringMultiSet con cui scambiare il contenuto
+	*/
+	void swap(StringMultiSet &other) noexcept {
+		_blocks.swap(other._blocks);
+		std::swap(_cursor, other._cursor);
+		std::swap(_left, other._left);
+		std::swap(_current, other._current);
+		std::swap(_reserved, other._reserved);
+		_order.swap(other._order);
+		_slots.swap(other._slots);
+		std::swap(_distinct, other._distinct);
+		std::swap(_size, other._size);
+	}
+
+	/**
+		@brief Numero di elementi di uno StringMultiSet
+
+		@return numero totale di elementi
+	*/
+	size_type size() const {
+		return _size;
+	}
+
+	/**
+		@brief Numero di elementi distinti di uno StringMultiSet
+
+		@return numero di chiavi con almeno un'occorrenza
+	*/
+	size_type distinct_size() const {
+		return _distinct;
+	}
+
+	/**
+		@brief Numero di chiavi internate, comprese quelle scese a 0 occorrenze
+
+		@return numero di chiavi nell'arena
+	*/
+	size_type interned_size() const {
+		return _order.size();
+	}
+
+	/**
+		@brief Memoria occupata da uno StringMultiSet
+
+		@return byte allocati per l'arena, l'ordine di inserimento e la tabella di hash
+	*/
+	size_type memory_usage() const {
+		return _reserved + _blocks.capacity() * sizeof(std::unique_ptr<char[]>) +
+			_order.capacity() * sizeof(std::uint32_t) + _slots.capacity() * sizeof(slot);
+	}
+
+	/**
+		@brief Ricerca di una chiave nello StringMultiSet
+
+		@param s chiave da cercare
+
+		@return true se la chiave ha almeno un'occorrenza, false altrimenti
+	*/
+	bool contains(multiset_string_ref s) const {
+		return nocc(s) > 0;
+	}
+
+	/**
+		@brief Numero di occorrenze di una chiave
+
+		@param s chiave da cercare
+
+		@return numero di occorrenze della chiave (0 se non presente)
+	*/
+	size_type nocc(multiset_string_ref s) const {
+		const record *r = find(s, multiset_string_hash(s.data, s.size));
+		return (r == nullptr) ? 0 : r->count;
+	}
+
+	/**
+		@brief Inserimento di una chiave nello StringMultiSet
+
+		@param s chiave da inserire
+
+		@throw Eccezione di allocazione di memoria
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti
+	*/
+	void add(multiset_string_ref s) {
+		add(s, 1);
+	}
+
+	/**
+		@brief Inserimento di k occorrenze di una chiave nello StringMultiSet
+
+		@description
+		Una chiave nuova è copiata nell'arena; una chiave già internata (anche se scesa a 0
+		occorrenze) è aggiornata senza allocare memoria.
+
+		@param s chiave da inserire
+		@param k numero di occorrenze da inserire
+
+		@throw Eccezione di allocazione di memoria (lo StringMultiSet resta invariato)
+		@throw Eccezione custom di numero di occorrenze fuori dai limiti (lo StringMultiSet resta invariato)
+	*/
+	void add(multiset_string_ref s, size_type k) {
+		if(k == 0)
+			return;
+		if(k > std::numeric_limits<std::size_t>::max() - _size)
+			throw multiset_count_overflow();
+		std::size_t h = multiset_string_hash(s.data, s.size);
+		std::size_t pos = _slots.empty() ? 0 : probe(s, h);
+		if(_slots.empty() || _slots[pos].handle == 0)
+			insert(s, h, k, pos);
+		else {
+			record *r = at(_slots[pos].handle - 1);
+			if(r->count == 0)
+				++_distinct;
+			r->count += k;
+		}
+		_size += k;
+	}
+
+	/**
+		@brief Rimozione di una chiave dallo StringMultiSet
+
+		@param s chiave da rimuovere
+
+		@throw Eccezione custom per elemento non presente
+	*/
+	void remove(multiset_string_ref s) {
+		remove(s, 1);
+	}
+
+	/**
+		@brief Rimozione di k occorrenze di una chiave dallo StringMultiSet
+
+		@description
+		Una chiave che scende a 0 occorrenze resta internata fino a compact().
+
+		@param s chiave da rimuovere
+		@param k numero di occorrenze da rimuovere
+
+		@throw Eccezione custom per elemento non presente (o con meno di k occorrenze)
+	*/
+	void remove(multiset_string_ref s, size_type k) {
+		if(k == 0)
+			return;
+		record *r = find(s, multiset_string_hash(s.data, s.size));
+		if(r == nullptr || r->count < k)
+			throw multiset_value_not_found();
+		r->count -= k;
+		_size -= k;
+		if(r->count == 0)
+			--_distinct;
+	}
+
+	/**
+		@brief Preallocazione della tabella per un numero atteso di chiavi distinte
+
+		@param n numero atteso di chiavi distinte
+
+		@throw Eccezione di allocazione di memoria (lo StringMultiSet resta invariato)
+	*/
+	void reserve(size_type n) {
+		if(n == 0)
+			return;
+		std::size_t ns = min_slots;
+		while(ns * 3 < n * 4)
+			ns *= 2;
+		if(ns > _slots.size())
+			rehash(ns);
+		_order.reserve(n);
+	}
+
+	/**
+		@brief Rilascio della memoria delle chiavi scese a 0 occorrenze
+
+		@description
+		Le chiavi presenti sono copiate in una nuova arena, nell'ordine di inserimento; i
+		riferimenti alle chiavi ottenuti in precedenza non sono più validi.
+
+		@throw Eccezione di allocazione di memoria (lo StringMultiSet resta invariato)
+	*/
+	void compact() {
+		StringMultiSet tmp(*this);
+		swap(tmp);
+	}
+
+	/**
+		@brief Metodo di rimozione contenuto dello StringMultiSet
+
+		@post Lo StringMultiSet è vuoto e la memoria dell'arena è rilasciata
+	*/
+	void clear() {
+		StringMultiSet tmp;
+		swap(tmp);
+	}
+
+	/**
+		@brief Operatore di uguaglianza tra due StringMultiSet
+
+		@description
+		Ogni chiave presente è cercata nell'altro StringMultiSet usando il suo hash precalcolato.
+
+		@param other StringMultiSet con cui confrontare quello corrente
+
+		@return true se i due StringMultiSet contengono le stesse chiavi con lo stesso numero di occorrenze
+	*/
+	bool operator==(const StringMultiSet &other) const {
+		if(_size != other._size || _distinct != other._distinct)
+			return false;
+		for(std::size_t i = 0; i < _order.size(); ++i) {
+			const record *r = at(_order[i]);
+			if(r->count == 0)
+				continue;
+			const record *theirs = other.find(multiset_string_ref(r->data(), r->size), r->hash);
+			if(theirs == nullptr || theirs->count != r->count)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+		@brief Iteratore in lettura sulle chiavi distinte di uno StringMultiSet
+
+		@description
+		Visita le chiavi con almeno un'occorrenza nell'ordine di inserimento; il deferenziamento
+		restituisce la coppia (chiave, numero di occorrenze).
+	*/
+	class distinct_iterator {
+
+	public:
+
+		typedef std::forward_iterator_tag iterator_category; ///< Categoria dell'iteratore
+		typedef std::pair<multiset_string_ref, size_type> value_type; ///< Coppia (chiave, numero di occorrenze)
+		typedef std::ptrdiff_t difference_type; ///< Tipo per rappresentare la differenza tra due iteratori
+		typedef void pointer; ///< La coppia è restituita per valore: l'accesso tramite puntatore non è disponibile
+		typedef value_type reference; ///< Tipo restituito dal deferenziamento
+
+		/**
+			@brief Costruttore di default dell'iteratore
+		*/
+		distinct_iterator() : _owner(nullptr), _i(0) {}
+
+		/**
+			@brief Chiave puntata dall'iteratore
+
+			@return riferimento ai caratteri internati della chiave
+		*/
+		multiset_string_ref value() const {
+			const record *r = current();
+			return multiset_string_ref(r->data(), r->size);
+		}
+
+		/**
+			@brief Numero di occorrenze della chiave puntata
+
+			@return numero di occorrenze
+		*/
+		size_type count() const {
+			return current()->count;
+		}
+
+		/**
+			@brief Operatore di deferenziamento
+
+			@return coppia (chiave, numero di occorrenze)
+		*/
+		reference operator*() const {
+			return value_type(value(), count());
+		}
+
+		/**
+			@brief Operatore di iterazione post-incremento
+
+			@return iteratore prima dell'incremento
+		*/
+		distinct_iterator operator++(int) {
+			distinct_iterator tmp(*this);
+			++*this;
+			return tmp;
+		}
+
+		/**
+			@brief Operatore di iterazione pre-incremento
+
+			@return riferimento all'iteratore incrementato
+
+			@throw multiset_iterator_out_of_bounds se l'iteratore è già alla fine (salvo MULTISET_NO_ITERATOR_CHECKS)
+		*/
+		distinct_iterator& operator++() {
+#ifndef MULTISET_NO_ITERATOR_CHECKS
+			if(_owner == nullptr || _i == _owner->_order.size())
+				throw multiset_iterator_out_of_bounds();
+#endif
+			++_i;
+			skip();
+			return *this;
+		}
+
+		/**
+			@brief Operatore di uguaglianza tra iteratori
+
+			@param other iteratore da confrontare
+
+			@return true se i due iteratori puntano alla stessa chiave
+		*/
+		bool operator==(const distinct_iterator &other) const {
+			return _owner == other._owner && _i == other._i;
+		}
+
+		/**
+			@brief Operatore di diversità tra iteratori
+
+			@param other iteratore da confrontare
+
+			@return true se i due iteratori puntano a chiavi diverse
+		*/
+		bool operator!=(const distinct_iterator &other) const {
+			return !(*this == other);
+		}
+
+	private:
+
+		friend class StringMultiSet; // Per usare il costruttore privato
+
+		const StringMultiSet *_owner; ///< StringMultiSet visitato
+		std::size_t _i; ///< Posizione nell'ordine di inserimento
+
+		/**
+			@brief Costruttore privato, che salta le chiavi a 0 occorrenze
+
+			@param owner StringMultiSet visitato
+			@param i posizione iniziale nell'ordine di inserimento
+		*/
+		distinct_iterator(const StringMultiSet *owner, std::size_t i) : _owner(owner), _i(i) {
+			skip();
+		}
+
+		/**
+			@brief Record puntato dall'iteratore
+
+			@return puntatore al record
+		*/
+		const record* current() const {
+			return _owner->at(_owner->_order[_i]);
+		}
+
+		/**
+			@brief Avanzamento fino alla prima chiave con almeno un'occorrenza (o alla fine)
+		*/
+		void skip() {
+			while(_i < _owner->_order.size() && current()->count == 0)
+				++_i;
+		}
+
+	}; // class distinct_iterator
+
+	/**
+		@brief Intervallo delle chiavi distinte, utilizzabile in un ciclo for su intervallo
+	*/
+	class distinct_range {
+
+	public:
+
+		/**
+			@brief Costruttore dell'intervallo
+
+			@param ms StringMultiSet da visitare
+		*/
+		explicit distinct_range(const StringMultiSet *ms) : owner(ms) {}
+
+		/**
+			@brief Inizio dell'intervallo
+
+			@return iteratore alla prima chiave presente
+		*/
+		distinct_iterator begin() const {
+			return distinct_iterator(owner, 0);
+		}
+
+		/**
+			@brief Fine dell'intervallo
+
+			@return iteratore alla fine
+		*/
+		distinct_iterator end() const {
+			return distinct_iterator(owner, owner->_order.size());
+		}
+
+	private:
+
+		const StringMultiSet *owner; ///< StringMultiSet visitato
+
+	}; // class distinct_range
+
+	/**
+		@brief Chiavi distinte dello StringMultiSet
+
+		@description
+		Esempio: for(auto e : ms.distinct()) os << e.first << " " << e.second;
+
+		@return intervallo delle chiavi con almeno un'occorrenza, nell'ordine di inserimento
+	*/
+	distinct_range distinct() const {
+		return distinct_range(this);
+	}
+
+}; // class StringMultiSet
+
+// Funzioni globali
+
+/**
+	@brief Ridefinizione dell'operatore di stream << per uno StringMultiSet
+
+	@description
+	Il formato di invio su stream è lo stesso del MultiSet:
+	{<X1, OccorrenzeX1>, <X2, OccorrenzeX2>, ..., <Xn, OccorrenzeXn>}.
+
+	@param os oggetto di stream output
+	@param ms StringMultiSet da stampare
+
+	@return riferimento allo stream di output
+*/
+inline std::ostream &operator<<(std::ostream &os, const StringMultiSet &ms) {
+	os << "{";
+	bool first = true;
+	StringMultiSet::distinct_range r = ms.distinct();
+	for(StringMultiSet::distinct_iterator i = r.begin(); i != r.end(); ++i) {
+		if(!first)
+			os << ", ";
+		os << "<" << i.value() << ", " << i.count() << ">";
+		first = false;
+	}
+	os << "}";
+
+	return os;
+}
+
+#endif
+
+// Fine string_multiset.h